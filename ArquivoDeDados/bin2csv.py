@@ -0,0 +1,78 @@
+import struct
+import sys
+import os
+
+# Converte um arquivo binário do datalogger (datalogN.bin) para o CSV usado por script.py:
+#   amostra,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,temp
+#
+# Uso: python bin2csv.py datalog1.bin [saida.csv]
+
+# Cabeçalho: magic, versão, tamanho do cabeçalho, tamanho do quadro, reservado,
+# taxa (Hz), escalas (accel, gyro, temp), offset da temperatura, início (us)
+HEADER_FMT = "<4sHHHHIffffQ"
+# Quadro: tempo relativo (us), accel[3], gyro[3], temp
+FRAME_FMT = "<I7h"
+
+MAGIC = b"MPUL"
+VERSION = 1
+
+
+def f32(valor):
+    # Arredonda para float de 32 bits, como o firmware faz nas conversões
+    return struct.unpack("<f", struct.pack("<f", valor))[0]
+
+
+def converter(entrada, saida):
+    with open(entrada, "rb") as f:
+        dados = f.read()
+
+    tam_cabecalho = struct.calcsize(HEADER_FMT)
+    if len(dados) < tam_cabecalho:
+        print(f"Arquivo '{entrada}' muito pequeno para conter o cabeçalho!")
+        return False
+
+    (magic, versao, header_size, frame_size, _reservado, taxa,
+     accel_escala, gyro_escala, temp_escala, temp_offset,
+     _inicio) = struct.unpack_from(HEADER_FMT, dados, 0)
+
+    if magic != MAGIC or versao != VERSION:
+        print(f"Arquivo '{entrada}' não é um log binário compatível!")
+        return False
+    if frame_size != struct.calcsize(FRAME_FMT):
+        print(f"Tamanho de quadro inesperado: {frame_size}")
+        return False
+
+    total = (len(dados) - header_size) // frame_size
+    print(f"{total} amostras a {taxa} Hz")
+
+    with open(saida, "w", newline="\n") as out:
+        out.write("amostra,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,temp\n")
+        for i in range(total):
+            quadro = struct.unpack_from(FRAME_FMT, dados, header_size + i * frame_size)
+            accel = quadro[1:4]
+            gyro = quadro[4:7]
+            temp = quadro[7]
+
+            valores = [f32(a / accel_escala) for a in accel]
+            valores += [f32(g / gyro_escala) for g in gyro]
+            valores.append(f32(f32(temp / temp_escala) + temp_offset))
+
+            out.write(f"{i + 1}," + ",".join(f"{v:.2f}" for v in valores) + "\n")
+    return True
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("Uso: python bin2csv.py <arquivo.bin> [saida.csv]")
+        exit(1)
+
+    entrada = sys.argv[1]
+    saida = sys.argv[2] if len(sys.argv) > 2 else os.path.splitext(entrada)[0] + ".csv"
+
+    if not os.path.exists(entrada):
+        print(f"Arquivo '{entrada}' não encontrado!")
+        exit(1)
+
+    if not converter(entrada, saida):
+        exit(1)
+    print(f"CSV gerado: {saida}")
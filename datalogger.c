@@ -8,12 +8,24 @@
 
 #include "lib/ssd1306/ssd1306.h"
 #include "lib/ssd1306/display.h"
+#include "lib/i2c_async/i2c_async.h"
+#include "lib/ui/ui.h" // Interface com cena retida e orçamento de quadros
+#include "lib/events/events.h" // Fila de eventos do laço principal
+#include "lib/joystick/joystick.h" // Joystick amostrado por timer
 #include "lib/led/led.h"
 #include "lib/button/button.h"
 #include "lib/matrix_leds/neopixel.h"
 #include "lib/buzzer/buzzer.h"
 #include "lib/sensors/mpu6050/mpu6050.h" // Biblioteca do MPU6050
+#include "lib/sampler/sampler.h" // Amostragem periódica por timer
+#include "lib/binlog/binlog.h" // Formato binário de gravação
+#include "lib/csvfmt/csvfmt.h" // Formatação das linhas CSV em ponto fixo
 #include "lib/sd/sd_utils.h" // Biblioteca de utilidades do SD
+#include "lib/sd/sd_wbuf.h" // Buffer de combinação de escritas no SD
+#include "lib/runstats/runstats.h" // Resumo da gravação (arquivo .stats)
+#include "lib/spectrum/spectrum.h" // Espectro da aceleração em ponto fixo (arquivo .fft)
+#include "lib/trigger/trigger.h" // Gravação por evento com anel pré-disparo
+#include "lib/trace/trace.h" // Pontos de prova de latência (DATALOGGER_TRACE)
 
 #include "ff.h"
 #include "diskio.h"
@@ -43,35 +55,106 @@
 // Tempo de debounce para os botões (em ms)
 const uint32_t delay_debounce = 200;
 
+// Taxa de amostragem do MPU6050 durante a gravação (1 Hz a 1 kHz)
+#define SAMPLE_RATE_HZ 100
+
+// Aquisição no núcleo 1 (1) ou no núcleo 0 junto com UI e SD (0)
+#ifndef SAMPLER_USE_CORE1
+#define SAMPLER_USE_CORE1 1
+#endif
+
+// Aquisição pela FIFO do MPU6050 (1), em rajadas, ou uma leitura por período (0)
+#define SAMPLER_USE_FIFO 0
+
+// Formato do arquivo de gravação: texto CSV (0) ou binário compacto (1)
+#define LOG_FORMAT_BINARIO 0
+
+#if LOG_FORMAT_BINARIO
+#define LOG_EXT ".bin"
+#else
+#define LOG_EXT ".csv"
+#endif
+
+// Gravação por evento (lib/trigger): condição, limiar (mg para TRIGGER_ACCEL e
+// TRIGGER_SLOPE, °/s para TRIGGER_GYRO) e amostras antes e a partir do disparo
+#define TRIGGER_CONDITION TRIGGER_ACCEL
+#define TRIGGER_THRESHOLD 500
+#define TRIGGER_PRE_SAMPLES 200  // 2 s a 100 Hz
+#define TRIGGER_POST_SAMPLES 800 // 8 s a 100 Hz
+
+// Espectro da aceleração por blocos (lib/spectrum) gravado em datalogN.fft,
+// ao lado do arquivo de dados: picos e RMS por faixa a cada 256 amostras
+#ifndef CAPTURE_SPECTRUM
+#define CAPTURE_SPECTRUM 0
+#endif
+
+// Pré-alocação contígua do arquivo de gravação: duração esperada (em s), 0 desativa.
+// Com o gatilho, cada evento reserva só as amostras dele (pré + pós-disparo).
+// O arquivo é truncado para o tamanho real ao parar; se a gravação passar disso,
+// o arquivo continua crescendo normalmente
+#define CAPTURE_PREALLOC_S 600
+
+// Bytes por amostra usados para calcular a pré-alocação
+#if LOG_FORMAT_BINARIO
+#define LOG_RECORD_SIZE sizeof(binlog_frame_t)
+#else
+#define LOG_RECORD_SIZE 48 // Tamanho típico de uma linha CSV
+#endif
+
+// Quantidade de amostras retiradas da fila por vez durante a gravação
+#define CAPTURE_BATCH 16
+
+// Intervalo mínimo entre atualizações do display durante a gravação (em ms)
+#define CAPTURE_DISPLAY_INTERVAL_MS 500
+
+// Colunas por segundo do gráfico da aceleração na tela de gravação
+// (LIVESTATS_ENV_LEN colunas: cerca de 29 s visíveis)
+#define CAPTURE_ENV_COLUMNS_PER_S 4
+
+// Período de amostragem do joystick e do tique do laço principal (em ms)
+#define JOYSTICK_PERIOD_MS 10
+#define EVENT_TICK_MS 20
+
+// Tempo que mensagens e LEDs de resultado ficam visíveis (em ms)
+#define FEEDBACK_MS 2000
+
+// Taxa máxima de quadros do menu: mudanças entre dois quadros são reunidas
+#define DISPLAY_MAX_FPS 30
+
 /*================== VARIÁVEIS GLOBAIS ==================*/
 // Estrutura para controle do display OLED
 ssd1306_t ssd;
+static i2c_async_t display_bus; // Envio dos quadros do display por DMA
+static ui_t ui;                 // Cena mostrada no display
 
 // Variáveis para controle dos botões
 volatile uint32_t last_time_debounce_button_a = 0;
 volatile uint32_t last_time_debounce_button_b = 0;
-volatile bool selecionar = false; // Flag de seleção no menu
-volatile bool BUTTON_B_PRESSED = false; // Flag para indicar que o botão B foi pressionado
 
 // Variáveis para controle de arquivos
-static char filename[20] = "datalogX.csv"; // Nome do arquivo de dados
+static char filename[20] = "datalogX" LOG_EXT; // Nome do arquivo de dados
 static FIL data_file;                     // Objeto do arquivo
+static sd_wbuf_t data_wbuf;               // Buffer de escrita alinhado a setores
+static uint8_t data_wbuf_storage[SD_WBUF_DEFAULT_SIZE] __attribute__((aligned(4)));
 static bool sd_card_is_mounted = false;   // Status do cartão SD
 
 // Variáveis para captura de dados
 static volatile bool is_capturing = false; // Flag de captura
 static uint32_t amostra_count = 0;        // Contador de amostras
-
-// Estados do menu principal
-typedef enum {
-    MODO_MONTAR_DESMONTAR,
-    MODO_GRAVAR,
-    MODO_LER,
-    MODO_ALTERAR_ARQUIVO,
-    MODO_BOOTSEL
-} menu_state_t;
-
+static uint64_t capture_start_us = 0;      // Instante de início da gravação
+static bool capture_prealloc = false;      // Arquivo atual foi pré-alocado
+static runstats_t capture_stats;           // Resumo da gravação atual
+static trigger_t trigger;                  // Gatilho da gravação por evento
+static bool trigger_armed = false;         // Amostrando e esperando eventos
+#if CAPTURE_SPECTRUM
+static spectrum_t capture_spectrum;        // Bloco do espectro em formação
+static FIL spectrum_file;                  // Arquivo .fft da gravação atual
+static bool spectrum_file_open = false;
+#endif
+
+// Estado do menu principal (estados em lib/ui/ui.h)
 static menu_state_t current_state = MODO_MONTAR_DESMONTAR; // Estado inicial
+static int file_index = 0; // Arquivo destacado em MODO_SELECIONAR_ARQUIVO
 
 //Prototipos de funções
 // Funções de inicialização
@@ -79,20 +162,42 @@ void setup();
 
 // Funções de manipulação de arquivos
 void read_file(const char *filename);
+void sidecar_name(char *name, size_t size, const char *ext);
+void write_stats_file(const sd_wbuf_stats_t *wstats);
+void spectrum_file_begin(void);
+void spectrum_file_block(void);
+void spectrum_file_end(void);
 void print_data_file();
 void init_stop_capture();
+bool capture_file_open(uint64_t start_us, uint32_t prealloc_samples);
+void capture_file_close(bool summary);
+void write_sample(const sample_t *amostra);
+void acao_gatilho();
+void trigger_sample(const sample_t *amostra);
+void trigger_event_end();
 void list_csv_files();
-void selecionar_arquivo_csv();
+
+// Ações do menu (tabela menu_table)
+void acao_montar_desmontar();
+void acao_ler();
+void acao_alterar_arquivo();
+void acao_bootsel();
+void menu_anterior();
+void menu_proximo();
+void arquivo_anterior();
+void arquivo_proximo();
+void arquivo_confirmar();
+void arquivo_voltar();
+void handle_event(const event_t *event);
 
 // Funções de interface
-void update_menu_from_joystick();
-void update_capture_display();
-void draw_menu();
 void show_menu();
 void beep(uint frequency, uint repeticoes, uint duration);
+void led_feedback(led_color_t color);
 
 // Funções de sistema
-static void gpio_button_handler(uint gpio, uint32_t events);
+static void gpio_irq_callback(uint gpio, uint32_t events);
+static void gpio_button_handler(uint gpio);
 
 // Variáveis para controle de arquivos CSV
 #define MAX_FILES 100
@@ -113,182 +218,203 @@ int main() {
     set_led_green();  // Sistema pronto (verde)
     beep(3000, 1, 100); // Beep de inicialização
     
-    // Variáveis para dados do sensor
-    int16_t aceleracao[3], gyro[3], temp;
-
-    // Loop principal do sistema
+    // Loop principal do sistema: trata os eventos e dorme até o próximo
     while (true) {
-        // Verifica se está em modo de captura
-        if (!is_capturing) {
-            // Atualiza menu e interface
-            update_menu_from_joystick();
-            draw_menu();
+        TRACE_BEGIN(TRACE_LOOP);
+
+        // Verifica se está em modo de captura (ou com o gatilho armado)
+        if (is_capturing || trigger_armed) {
+            // Consome as amostras geradas pelo timer em lotes
+            sample_t lote[CAPTURE_BATCH];
+            uint32_t n;
+            while ((n = sampler_pop_n(lote, CAPTURE_BATCH)) > 0) {
+                for (uint32_t i = 0; i < n; i++) {
+                    if (is_capturing)
+                        write_sample(&lote[i]);
+                    else if (trigger_armed) // Pode ter sido desarmado por um erro no lote
+                        trigger_sample(&lote[i]);
+                }
+            }
+            sd_wbuf_poll(&data_wbuf); // Avança as gravações diretas em andamento
+        }
+
+        // Botões, joystick e tiques enfileirados pelas interrupções
+        event_t event;
+        while (events_get(&event))
+            handle_event(&event);
+
+        if (!is_capturing && !trigger_armed && !led_is_playing())
+            turn_off_leds(); // Desliga LEDs enquanto o menu é exibido
+
+        // Atualiza a cena; o desenho fica com ui_task, depois das amostras do lote
+        ui_set_menu(&ui, current_state);
+        ui_set_sd_mounted(&ui, sd_card_is_mounted);
+        ui_set_filename(&ui, filename);
+        ui_set_choice(&ui, file_index < csv_file_count ? csv_files[file_index] : "");
+        ui_set_samples(&ui, amostra_count);
+        ui_set_envelope(&ui, is_capturing ? &capture_stats.live.env : NULL);
+        ui_set_trigger(&ui, trigger.events, trigger_in_event(&trigger));
+        TRACE_BEGIN(TRACE_UI);
+        ui_task(&ui);
+        TRACE_END(TRACE_UI);
+
+        trace_poll(); // Comandos 't' e 'r' do relatório de latências
+
+        // Gravando: volta logo para esvaziar a fila de amostras. No menu, dorme
+        // até uma interrupção enfileirar um evento (no máximo EVENT_TICK_MS)
+        if (is_capturing || trigger_armed) {
+            TRACE_END(TRACE_LOOP); // Só o trabalho da volta, sem o sleep
+            sleep_ms(1);
+        } else
+            events_wait();
+    }
+}
+
+// Tabela de estados do menu: ação de cada entrada em cada estado (NULL: ignora)
+typedef void (*menu_handler_t)(void);
+
+static const menu_handler_t menu_table[MENU_STATE_COUNT][EVT_INPUT_COUNT] = {
+    //                           EVT_BUTTON_A            EVT_BUTTON_B    EVT_JOY_LEFT      EVT_JOY_RIGHT
+    [MODO_MONTAR_DESMONTAR]   = { acao_montar_desmontar, NULL,           menu_anterior,    menu_proximo },
+    [MODO_GRAVAR]             = { init_stop_capture,     NULL,           menu_anterior,    menu_proximo },
+    [MODO_GATILHO]            = { acao_gatilho,          NULL,           menu_anterior,    menu_proximo },
+    [MODO_LER]                = { acao_ler,              NULL,           menu_anterior,    menu_proximo },
+    [MODO_ALTERAR_ARQUIVO]    = { acao_alterar_arquivo,  NULL,           menu_anterior,    menu_proximo },
+    [MODO_BOOTSEL]            = { acao_bootsel,          NULL,           menu_anterior,    menu_proximo },
+    [MODO_SELECIONAR_ARQUIVO] = { arquivo_confirmar,     arquivo_voltar, arquivo_anterior, arquivo_proximo },
+};
+
+// Despacha um evento de entrada pela tabela do estado atual
+void handle_event(const event_t *event) {
+    if (event->type >= EVT_INPUT_COUNT) return; // Tique: só acorda o laço
+
+    // Durante a gravação (ou com o gatilho armado) só o botão A (parar) é aceito
+    if ((is_capturing || trigger_armed) && event->type != EVT_BUTTON_A) return;
+
+    menu_handler_t handler = menu_table[current_state][event->type];
+    if (handler) {
+        handler();
+        ui_invalidate(&ui); // As ações podem ter desenhado mensagens por fora da cena
+    }
+}
+
+// Joystick no menu principal: opções em anel
+void menu_anterior() {
+    current_state = (current_state == MODO_MONTAR_DESMONTAR) ? MODO_BOOTSEL : current_state - 1;
+}
+
+void menu_proximo() {
+    current_state = (current_state == MODO_BOOTSEL) ? MODO_MONTAR_DESMONTAR : current_state + 1;
+}
+
+// Montar/desmontar cartão SD
+void acao_montar_desmontar() {
+    set_led_blue(); // Em processo (azul)
+    beep(3000, 1, 100); // Beep de início
+
+    // Aviso desenhado direto: a montagem bloqueia até terminar. O resultado
+    // fica na tela por FEEDBACK_MS, sem segurar o laço principal
+    ssd1306_fill(&ssd, false);
+    draw_centered_text(&ssd, sd_card_is_mounted ? "DESMONTANDO" : "MONTANDO", 20);
+    draw_centered_text(&ssd, "SD CARD", 30);
+    ssd1306_send_data(&ssd);
+
+    if (sd_card_is_mounted) {
+        if(sd_unmount() == SD_OK) {
+            ui_show_message(&ui, NULL, "SD DESMONTADO", NULL, FEEDBACK_MS);
+            led_feedback(LED_GREEN); // Pronto (verde)
+            beep(3000, 3, 100); // Beep de sucesso
+            sd_card_is_mounted = false;
+
         } else {
-            // Modo de captura ativo - lê dados do sensor
-            
-            // 1. Ler dados brutos do MPU6050
-            mpu6050_read_raw(I2C_PORT_MPU, aceleracao, gyro, &temp);
-            
-            // 2. Converter valores para unidades físicas
-            float accel_g[3] = {
-                aceleracao[0] / 16384.0f, // Conversão para g (±2g)
-                aceleracao[1] / 16384.0f,
-                aceleracao[2] / 16384.0f
-            };
-            
-            float gyro_dps[3] = {
-                gyro[0] / 131.0f, // Conversão para °/s (±250°/s)
-                gyro[1] / 131.0f,
-                gyro[2] / 131.0f
-            };
-            
-            // Converter temperatura para Celsius
-            float temp_c = (temp / 340.0f) + 36.53f;
-            
-            // 3. Formatar dados como linha CSV
-            char buffer[100];
-            int len = snprintf(buffer, sizeof(buffer),
-                "%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
-                amostra_count + 1,       // Número da amostra
-                accel_g[0], accel_g[1], accel_g[2],  // Dados de aceleração
-                gyro_dps[0], gyro_dps[1], gyro_dps[2], // Dados do giroscópio
-                temp_c);                 // Temperatura
-            
-            // 4. Escrever no arquivo
-            UINT bw;
-            f_write(&data_file, buffer, len, &bw);
-            amostra_count++;
-            
-            // 5. Atualizar display periodicamente
-            char status[30];
-            ssd1306_fill(&ssd, false);
-            draw_centered_text(&ssd, "GRAVANDO...", 10);
-            ssd1306_draw_string(&ssd, filename, 5, 20);
-            ssd1306_send_data(&ssd);
-            snprintf(status, sizeof(status), "Amostras: %lu", amostra_count);
-            ssd1306_draw_string(&ssd, status, 5, 45);
-            ssd1306_send_data(&ssd);
+            ui_show_message(&ui, "ERRO", "DESMONTAR SD", NULL, FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
+            beep(2000, 2, 100); // Beep de erro
         }
+    } else {
+        if(sd_mount() == SD_OK) {
+            ui_show_message(&ui, NULL, "SD MONTADO", NULL, FEEDBACK_MS);
+            led_feedback(LED_GREEN); // Pronto (verde)
+            beep(3000, 3, 100); // Beep de sucesso
+            list_csv_files(); // Gera novo nome de arquivo
+            sd_card_is_mounted = true;
 
-        // Verifica se houve seleção no menu
-        if (selecionar) {
-            selecionar = false; // Reseta o flag de seleção
-
-            switch (current_state) {
-                case MODO_MONTAR_DESMONTAR:
-                    // Montar/desmontar cartão SD
-                    set_led_blue(); // Em processo (azul)
-                    beep(3000, 1, 100); // Beep de início
-
-                    if (sd_card_is_mounted) {
-                        ssd1306_fill(&ssd, false);
-                        draw_centered_text(&ssd, "DESMONTANDO", 20);
-                        draw_centered_text(&ssd, "SD CARD", 30);
-                        ssd1306_send_data(&ssd);
-                        sleep_ms(2000); // Espera 2 segundos para mostrar a mensagem
-
-                        if(sd_unmount() == SD_OK) {
-                            ssd1306_fill(&ssd, false);
-                            draw_centered_text(&ssd, "SD DESMONTADO", 30);
-                            ssd1306_send_data(&ssd);
-                            set_led_green(); // Pronto (verde)
-                            beep(3000, 3, 100); // Beep de sucesso
-                            sd_card_is_mounted = false;
-
-                        } else {
-                            ssd1306_fill(&ssd, false);
-                            draw_centered_text(&ssd, "ERRO", 20);
-                            draw_centered_text(&ssd, "DESMONTAR SD", 30);
-                            ssd1306_send_data(&ssd);
-                            set_led_magenta(); // Erro (magenta)
-                            beep(2000, 2, 100); // Beep de erro
-                        }
-                    } else {
-                        ssd1306_fill(&ssd, false);
-                        draw_centered_text(&ssd, "MONTANDO", 20);
-                        draw_centered_text(&ssd, "SD CARD", 30);
-                        ssd1306_send_data(&ssd);
-                        sleep_ms(2000); // Espera 2 segundos para mostrar a mensagem
-
-                        if(sd_mount() == SD_OK) {
-                            ssd1306_fill(&ssd, false);
-                            draw_centered_text(&ssd, "SD MONTADO", 30);
-                            ssd1306_send_data(&ssd);
-                            set_led_green(); // Pronto (verde)
-                            beep(3000, 3, 100); // Beep de sucesso
-                            list_csv_files(); // Gera novo nome de arquivo
-                            sd_card_is_mounted = true;
-
-                        } else {
-                            ssd1306_fill(&ssd, false);
-                            draw_centered_text(&ssd, "ERRO", 20);
-                            draw_centered_text(&ssd, "MONTAR SD", 30);
-                            ssd1306_send_data(&ssd);
-                            set_led_magenta(); // Erro (magenta)
-                            beep(2000, 2, 100); // Beep de erro
-                        }
-                    }
-                    sleep_ms(2000); // Espera 2 segundos para mostrar a mensagem
-                    break;
-
-                case MODO_GRAVAR:
-                    // Iniciar/parar captura de dados
-                    init_stop_capture();
-                    break;
-                    
-                case MODO_LER:
-                    // Ler arquivo de dados
-                    read_file(filename);
-                    break;
-                
-                case MODO_ALTERAR_ARQUIVO:
-                    // Verifica se o cartão SD está montado
-                    if (!sd_card_is_mounted) {
-                        ssd1306_fill(&ssd, false);
-                        draw_centered_text(&ssd, "ERRO", 20);
-                        draw_centered_text(&ssd, "SD CARD", 30);
-                        draw_centered_text(&ssd, "NAO MONTADO", 40);
-                        ssd1306_send_data(&ssd);
-                        set_led_magenta(); // Erro (magenta)
-                        beep(2000, 2, 100); // Beep de erro
-                        sleep_ms(2000);
-                    }
-
-                    list_csv_files(); // Lista arquivos CSV disponíveis 
-                    selecionar_arquivo_csv(); // Seleciona um arquivo CSV
-                    break;
-                
-                case MODO_BOOTSEL:
-                    // Habilitar modo BOOTSEL
-                    printf("\nHABILITANDO O MODO BOOTSEL\n");
-
-                    // Se o cartão SD não estiver montado
-                    if(sd_card_is_mounted){
-                        sd_unmount(); // Desmonta o SD Card
-                        ssd1306_fill(&ssd, false);
-                        draw_centered_text(&ssd, "DESMONTANDO SSD", 30);
-                        ssd1306_send_data(&ssd);
-                        sleep_ms(2000);
-
-                        ssd1306_fill(&ssd, false);
-                        draw_centered_text(&ssd, "SSD DESMONTADO", 30);
-                        ssd1306_send_data(&ssd);
-                        sleep_ms(2000);
-                    }
-
-                    ssd1306_fill(&ssd, false);
-                    draw_centered_text(&ssd, "MODO BOOTSEL", 25);
-                    draw_centered_text(&ssd, "HABILITADO", 38);
-                    ssd1306_send_data(&ssd);
-                    reset_usb_boot(0, 0); // Reinicia em modo BOOTSEL
-                    break;
-            }
-            selecionar = false; // Reseta o flag de seleção
+        } else {
+            ui_show_message(&ui, "ERRO", "MONTAR SD", NULL, FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
+            beep(2000, 2, 100); // Beep de erro
         }
+    }
+}
+
+// Ler arquivo de dados
+void acao_ler() {
+    read_file(filename);
+}
+
+// Alterar o arquivo atual: lista os arquivos e passa à seleção pelo joystick
+void acao_alterar_arquivo() {
+    // Verifica se o cartão SD está montado
+    if (!sd_card_is_mounted) {
+        ui_show_message(&ui, "ERRO", "SD CARD", "NAO MONTADO", FEEDBACK_MS);
+        led_feedback(LED_MAGENTA); // Erro (magenta)
+        beep(2000, 2, 100); // Beep de erro
+        return;
+    }
+
+    list_csv_files(); // Lista arquivos CSV disponíveis
+    if (csv_file_count == 0) {
+        ui_show_message(&ui, "SEM CSV ENCONTRADO", NULL, NULL, FEEDBACK_MS);
+        led_feedback(LED_MAGENTA); // Erro (magenta)
+        beep(2000, 2, 100); // Beep de erro
+        return;
+    }
+    file_index = 0;
+    current_state = MODO_SELECIONAR_ARQUIVO;
+}
+
+// Seleção de arquivo: joystick percorre a lista, A escolhe e B volta
+void arquivo_anterior() {
+    file_index = (file_index - 1 + csv_file_count) % csv_file_count;
+}
+
+void arquivo_proximo() {
+    file_index = (file_index + 1) % csv_file_count;
+}
+
+void arquivo_confirmar() {
+    strncpy(filename, csv_files[file_index], sizeof(filename));
+    filename[sizeof(filename) - 1] = '\0';
+    current_state = MODO_ALTERAR_ARQUIVO;
+
+    led_feedback(LED_GREEN); // Pronto (verde)
+    beep(3000, 3, 100); // Beep de sucesso
+    ui_show_message(&ui, "ARQUIVO ATUAL:", NULL, filename, FEEDBACK_MS);
+}
+
+void arquivo_voltar() {
+    current_state = MODO_ALTERAR_ARQUIVO;
+}
+
+// Habilitar modo BOOTSEL
+void acao_bootsel() {
+    printf("\nHABILITANDO O MODO BOOTSEL\n");
 
-        // Pequena pausa entre iterações
-        sleep_ms(250);
+    // Se o cartão SD estiver montado, desmonta antes de reiniciar
+    bool unmounted = false;
+    if(sd_card_is_mounted){
+        unmounted = sd_unmount() == SD_OK; // Desmonta o SD Card
+        sd_card_is_mounted = false;
     }
+
+    // O display mantém o último quadro depois do reinício: o aviso continua
+    // visível no modo BOOTSEL sem esperar aqui
+    ssd1306_fill(&ssd, false);
+    draw_centered_text(&ssd, "MODO BOOTSEL", 20);
+    draw_centered_text(&ssd, "HABILITADO", 30);
+    if (unmounted) draw_centered_text(&ssd, "SD DESMONTADO", 40);
+    ssd1306_send_data(&ssd);
+    reset_usb_boot(0, 0); // Reinicia em modo BOOTSEL
 }
 
 // Função de inicialização os periféricos
@@ -300,13 +426,24 @@ void setup() {
     init_leds();
     init_buzzer(BUZZER_PIN, 4.0f);
 
-    // Configura ADC para joystick
+    // Fila de eventos e tique periódico (acorda o laço para as tarefas com prazo)
+    events_init();
+    events_start_tick(EVENT_TICK_MS);
+
+    // Configura ADC para joystick, amostrado por timer
     adc_init();
     adc_gpio_init(VRY_PIN);
     adc_gpio_init(VRX_PIN);
+    joystick_init(1, JOYSTICK_PERIOD_MS); // Entrada 1: eixo X
 
     // Inicializa display OLED
     init_display(&ssd);
+    i2c_async_init(&display_bus, SSD1306_I2C_PORT);
+    ssd1306_set_async(&ssd, &display_bus);
+    ui_init(&ui, &ssd);
+    ui_set_frame_interval(&ui, UI_SCREEN_MENU, 1000 / DISPLAY_MAX_FPS);
+    ui_set_frame_interval(&ui, UI_SCREEN_CAPTURE, CAPTURE_DISPLAY_INTERVAL_MS);
+    ui_set_frame_interval(&ui, UI_SCREEN_TRIGGER, CAPTURE_DISPLAY_INTERVAL_MS);
 
     // Configura I2C para o MPU6050
     i2c_init(I2C_PORT_MPU, 400 * 1000);
@@ -318,11 +455,16 @@ void setup() {
     // Inicializa MPU6050
     mpu6050_init(I2C_PORT_MPU);
 
+    // Configura a amostragem periódica do MPU6050
+    sampler_init(I2C_PORT_MPU, SAMPLE_RATE_HZ);
+    sampler_set_core(SAMPLER_USE_CORE1 ? SAMPLER_CORE1 : SAMPLER_CORE0);
+    sampler_set_mode(SAMPLER_USE_FIFO ? SAMPLER_MODE_FIFO : SAMPLER_MODE_TIMER);
+
     // Configura botões com interrupções
     button_init_predefined(true, true, true);
-    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_button_handler);
-    gpio_set_irq_enabled_with_callback(BUTTON_B, GPIO_IRQ_EDGE_FALL, true, &gpio_button_handler);
-    gpio_set_irq_enabled_with_callback(BUTTON_SW, GPIO_IRQ_EDGE_FALL, true, &gpio_button_handler);
+    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_callback);
+    gpio_set_irq_enabled_with_callback(BUTTON_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_callback);
+    gpio_set_irq_enabled_with_callback(BUTTON_SW, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_callback);
 }
 
 // Função para iniciar/parar a captura de dados
@@ -334,64 +476,323 @@ void init_stop_capture() {
 
         // Verifica se o cartão SD está montado
         if (!sd_card_is_mounted) {
-            ssd1306_fill(&ssd, false);
-            draw_centered_text(&ssd, "ERRO", 20);
-            draw_centered_text(&ssd, "SD CARD", 30);
-            draw_centered_text(&ssd, "NAO MONTADO", 40);
-            ssd1306_send_data(&ssd);
-            set_led_magenta(); // Erro (magenta)
+            ui_show_message(&ui, "ERRO", "SD CARD", "NAO MONTADO", FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
             beep(2000, 2, 100); // Beep de erro
-            sleep_ms(2000);
             return;
         }
 
-        // Tenta abrir o arquivo para escrita
-        FRESULT res = f_open(&data_file, filename, FA_WRITE | FA_CREATE_ALWAYS);
-        if (res != FR_OK) {
-            ssd1306_fill(&ssd, false);
-            draw_centered_text(&ssd, "ERRO", 20);
-            draw_centered_text(&ssd, "ABRIR ARQUIVO", 30);
-            ssd1306_send_data(&ssd);
-            set_led_magenta(); // Erro (magenta)
+        if (!capture_file_open(time_us_64(), CAPTURE_PREALLOC_S * sampler_get_rate())) return;
+
+        // Inicia captura
+        trace_reset();
+        if (!sampler_start()) {
+            capture_file_close(false);
+            ui_show_message(&ui, "ERRO", "TIMER", NULL, FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
             beep(2000, 2, 100); // Beep de erro
-            sleep_ms(2000);
             return;
         }
-
-        // Escreve cabeçalho no arquivo CSV
-        const char *header = "amostra,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,temp\n";
-        UINT bw;
-        f_write(&data_file, header, strlen(header), &bw);
-        f_sync(&data_file);
-
-        // Inicia captura
         is_capturing = true;
-        amostra_count = 0;
-        
-        // Feedback visual
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "GRAVANDO...", 10);
-        draw_centered_text(&ssd, filename, 20);
-        ssd1306_send_data(&ssd);
+        ui_set_screen(&ui, UI_SCREEN_CAPTURE);
     } else {
         // Para a captura e fecha o arquivo
+        sampler_stop();
         is_capturing = false;
-        f_close(&data_file);
+        ui_set_screen(&ui, UI_SCREEN_MENU);
+
+        // Grava as amostras que ainda estão na fila e o resto do buffer
+        sample_t amostra;
+        while (sampler_pop(&amostra))
+            write_sample(&amostra);
+        capture_file_close(true);
+        trace_dump();
         
-        // Feedback visual
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "DADOS SALVOS!", 10);
+        // Feedback visual (sem bloquear: o menu volta sozinho depois)
         char msg[30];
         snprintf(msg, sizeof(msg), "Amostras: %lu", amostra_count);
-        ssd1306_draw_string(&ssd, msg, 5, 40);
-        ssd1306_send_data(&ssd);
-        set_led_green(); // Volta para pronto (verde)
+        ui_show_message(&ui, "DADOS SALVOS!", NULL, msg, FEEDBACK_MS);
+        led_feedback(LED_GREEN); // Volta para pronto (verde)
         beep(3000, 3, 100); // Beep de fim de gravação
 
         list_csv_files(); // Atualiza lista de arquivos
+    }
+}
+
+// Cria o arquivo de dados (filename) de uma gravação que começa em start_us:
+// pré-alocação para prealloc_samples amostras (0 não pré-aloca), buffer de
+// escrita, cabeçalho, resumo e espectro. Retorna false, com a mensagem de erro
+// na tela, se o arquivo não puder ser criado
+bool capture_file_open(uint64_t start_us, uint32_t prealloc_samples) {
+    // Tenta abrir o arquivo para escrita
+    FRESULT res = f_open(&data_file, filename, FA_WRITE | FA_CREATE_ALWAYS);
+    if (res != FR_OK) {
+        ui_show_message(&ui, "ERRO", "ABRIR ARQUIVO", NULL, FEEDBACK_MS);
+        led_feedback(LED_MAGENTA); // Erro (magenta)
+        beep(2000, 2, 100); // Beep de erro
+        return false;
+    }
 
-        sleep_ms(2000);
+    // Reserva uma área contígua para a gravação inteira, evitando alocar
+    // clusters (e atualizar a FAT) durante a captura
+    capture_prealloc = false;
+    if (prealloc_samples > 0) {
+        FSIZE_t prealloc = (FSIZE_t)prealloc_samples * LOG_RECORD_SIZE;
+        capture_prealloc = f_expand(&data_file, prealloc, 1) == FR_OK;
+        if (!capture_prealloc) printf("Sem espaco contiguo para pre-alocar %llu bytes\n", (uint64_t)prealloc);
     }
+
+    // Todas as escritas passam pelo buffer, que entrega blocos alinhados ao f_write
+    sd_wbuf_init(&data_wbuf, &data_file, data_wbuf_storage, sizeof(data_wbuf_storage));
+    // Arquivo contíguo: blocos direto aos setores, com DMA e buffer duplo.
+    // Senão, blocos sequenciais seguem num único CMD25, fechado só no flush
+    if (!capture_prealloc || sd_wbuf_enable_raw(&data_wbuf) != SD_OK)
+        sd_stream_file_begin(&data_file);
+
+    // Escreve cabeçalho no arquivo
+    capture_start_us = start_us;
+#if LOG_FORMAT_BINARIO
+    binlog_header_t header;
+    binlog_init_header(&header, sampler_get_rate(), capture_start_us);
+    sd_wbuf_write(&data_wbuf, &header, sizeof(header));
+#else
+    const char *header = "amostra,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,temp\n";
+    sd_wbuf_write(&data_wbuf, header, strlen(header));
+#endif
+
+    amostra_count = 0;
+    runstats_reset(&capture_stats, sampler_get_rate() / CAPTURE_ENV_COLUMNS_PER_S);
+    spectrum_file_begin();
+    return true;
+}
+
+// Grava o resto do buffer e fecha o arquivo de dados e o do espectro. Com
+// summary, mostra as estatísticas no stdio e grava o .stats
+void capture_file_close(bool summary) {
+    sd_wbuf_flush(&data_wbuf);
+    sd_stream_file_end(&data_file);
+    // Descarta a parte pré-alocada que não foi usada (corta na posição atual)
+    if (capture_prealloc) f_truncate(&data_file);
+    f_close(&data_file);
+    spectrum_file_end(); // O bloco incompleto é descartado
+    if (!summary) return;
+
+    sd_wbuf_stats_t wstats;
+    sd_wbuf_get_stats(&data_wbuf, &wstats);
+    printf("SD: %llu bytes, %lu B/s, %lu escritas/s (pico %lu us)\n",
+           wstats.bytes, wstats.bytes_per_s, wstats.writes_per_s, wstats.max_write_us);
+    printf("Fila de amostras: pico %lu/%d, descartadas %lu, erros de I2C %lu\n",
+           sampler_high_water(), SAMPLER_QUEUE_LEN, sampler_dropped(), sampler_bus_errors());
+    if (SAMPLER_USE_FIFO)
+        printf("FIFO do MPU6050: %lu transbordos\n", sampler_fifo_overflows());
+    write_stats_file(&wstats);
+}
+
+// Armar/desarmar a gravação por evento. Armado, o sampler roda sem parar e
+// cada disparo do gatilho vira um arquivo datalogN com as amostras de antes
+// e de depois do evento
+void acao_gatilho() {
+    if (!trigger_armed) {
+        // Verifica se o cartão SD está montado
+        if (!sd_card_is_mounted) {
+            ui_show_message(&ui, "ERRO", "SD CARD", "NAO MONTADO", FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
+            beep(2000, 2, 100); // Beep de erro
+            return;
+        }
+
+        trigger_config_t config = {
+            .cond = TRIGGER_CONDITION,
+            .threshold = TRIGGER_THRESHOLD,
+            .pre_samples = TRIGGER_PRE_SAMPLES,
+            .post_samples = TRIGGER_POST_SAMPLES,
+        };
+        trigger_init(&trigger, &config);
+        trace_reset();
+        if (!sampler_start()) {
+            ui_show_message(&ui, "ERRO", "TIMER", NULL, FEEDBACK_MS);
+            led_feedback(LED_MAGENTA); // Erro (magenta)
+            beep(2000, 2, 100); // Beep de erro
+            return;
+        }
+        trigger_armed = true;
+        set_led_blue(); // Armado (azul)
+        beep(3000, 1, 100);
+        ui_set_screen(&ui, UI_SCREEN_TRIGGER);
+    } else {
+        sampler_stop();
+        trigger_armed = false;
+        ui_set_screen(&ui, UI_SCREEN_MENU);
+
+        // Evento pela metade: grava o que já chegou dele e fecha o arquivo.
+        // O resto da fila é só espera e fica de fora
+        sample_t amostra;
+        while (trigger_in_event(&trigger) && sampler_pop(&amostra))
+            trigger_sample(&amostra);
+        if (trigger_in_event(&trigger)) {
+            capture_file_close(true);
+            list_csv_files();
+        }
+        trace_dump();
+
+        char msg[30];
+        snprintf(msg, sizeof(msg), "Eventos: %lu", (unsigned long)trigger.events);
+        ui_show_message(&ui, "GATILHO", "DESARMADO", msg, FEEDBACK_MS);
+        led_feedback(LED_GREEN); // Volta para pronto (verde)
+        beep(3000, 3, 100);
+    }
+}
+
+// Uma amostra com o gatilho armado: no disparo abre o arquivo do evento e
+// grava o anel pré-disparo; as seguintes vão direto até o fim do evento
+void trigger_sample(const sample_t *amostra) {
+    switch (trigger_add(&trigger, amostra)) {
+        case TRIGGER_WAIT:
+            break;
+        case TRIGGER_FIRED: {
+            // O arquivo começa na amostra mais antiga do anel
+            uint32_t pre = trigger_pre_count(&trigger);
+            uint64_t start_us = pre ? trigger_pre_get(&trigger, 0)->timestamp_us : amostra->timestamp_us;
+            uint32_t prealloc = CAPTURE_PREALLOC_S > 0 ? TRIGGER_PRE_SAMPLES + TRIGGER_POST_SAMPLES : 0;
+            if (!capture_file_open(start_us, prealloc)) {
+                sampler_stop();
+                trigger_armed = false;
+                ui_set_screen(&ui, UI_SCREEN_MENU);
+                return;
+            }
+            printf("Evento %lu: %s\n", (unsigned long)trigger.events, filename);
+            set_led_red(); // Gravando (vermelho)
+            for (uint32_t i = 0; i < pre; i++)
+                write_sample(trigger_pre_get(&trigger, i));
+            write_sample(amostra);
+            if (!trigger_in_event(&trigger)) trigger_event_end();
+            break;
+        }
+        case TRIGGER_POST:
+            write_sample(amostra);
+            break;
+        case TRIGGER_DONE:
+            write_sample(amostra);
+            trigger_event_end();
+            break;
+    }
+}
+
+// Fim do evento: fecha o arquivo, passa ao próximo nome e volta a esperar
+void trigger_event_end() {
+    capture_file_close(true);
+    list_csv_files(); // Próximo nome de arquivo
+    set_led_blue(); // Armado (azul)
+    beep(3000, 1, 50);
+}
+
+// Função para gravar uma amostra no formato configurado (quadro binário ou linha CSV)
+void write_sample(const sample_t *amostra) {
+    TRACE_VALUE(TRACE_SAMPLE_AGE, (uint32_t)(time_us_64() - amostra->timestamp_us));
+    runstats_add(&capture_stats, amostra);
+#if CAPTURE_SPECTRUM
+    if (spectrum_file_open && spectrum_add(&capture_spectrum, amostra))
+        spectrum_file_block();
+#endif
+#if LOG_FORMAT_BINARIO
+    TRACE_BEGIN(TRACE_FORMAT);
+    binlog_frame_t frame;
+    binlog_pack_frame(&frame, amostra, capture_start_us);
+    TRACE_END(TRACE_FORMAT);
+    TRACE_BEGIN(TRACE_LOG_WRITE);
+    sd_wbuf_write(&data_wbuf, &frame, sizeof(frame));
+    TRACE_END(TRACE_LOG_WRITE);
+    amostra_count++;
+#else
+    // Formata a linha CSV só com inteiros (mesmo texto do "%.2f" em float)
+    TRACE_BEGIN(TRACE_FORMAT);
+    char buffer[CSVFMT_LINE_MAX];
+    int len = csvfmt_sample(buffer, amostra_count + 1, amostra);
+    TRACE_END(TRACE_FORMAT);
+
+    // Escrever no arquivo
+    TRACE_BEGIN(TRACE_LOG_WRITE);
+    sd_wbuf_write(&data_wbuf, buffer, len);
+    TRACE_END(TRACE_LOG_WRITE);
+    amostra_count++;
+#endif
+}
+
+// Nome de um arquivo auxiliar da gravação: o do arquivo de dados com a
+// extensão trocada por ext (ex.: datalog3.csv -> datalog3.stats)
+void sidecar_name(char *name, size_t size, const char *ext) {
+    snprintf(name, size, "%.*s%s", (int)(strlen(filename) - strlen(LOG_EXT)), filename, ext);
+}
+
+// Grava o resumo da gravação em datalogN.stats, ao lado do arquivo de dados
+void write_stats_file(const sd_wbuf_stats_t *wstats) {
+    static char text[RUNSTATS_TEXT_MAX];
+    char stats_name[sizeof(filename) + 8];
+    FIL file;
+    UINT bw = 0;
+
+    sidecar_name(stats_name, sizeof(stats_name), ".stats");
+
+    int len = runstats_format(&capture_stats, filename, wstats, text, sizeof(text));
+    FRESULT res = f_open(&file, stats_name, FA_WRITE | FA_CREATE_ALWAYS);
+    if (res == FR_OK) {
+        res = f_write(&file, text, len, &bw);
+        if (res == FR_OK && bw != (UINT)len) res = FR_DENIED; // Disco cheio
+        FRESULT close_res = f_close(&file);
+        if (res == FR_OK) res = close_res;
+    }
+    if (res != FR_OK)
+        printf("Erro ao gravar %s: %s\n", stats_name, FRESULT_str(res));
+    else
+        printf("Resumo gravado em %s\n", stats_name);
+}
+
+// Abre o datalogN.fft da gravação e escreve o cabeçalho. Sem o arquivo, a
+// gravação continua só com os dados
+void spectrum_file_begin(void) {
+#if CAPTURE_SPECTRUM
+    char name[sizeof(filename) + 8];
+    char header[SPECTRUM_TEXT_MAX];
+    UINT bw = 0;
+
+    spectrum_init(&capture_spectrum, sampler_get_rate());
+    sidecar_name(name, sizeof(name), ".fft");
+    FRESULT res = f_open(&spectrum_file, name, FA_WRITE | FA_CREATE_ALWAYS);
+    if (res == FR_OK) {
+        int len = spectrum_format_header(&capture_spectrum, header, sizeof(header));
+        res = f_write(&spectrum_file, header, len, &bw);
+        if (res != FR_OK) f_close(&spectrum_file);
+    }
+    spectrum_file_open = res == FR_OK;
+    if (!spectrum_file_open) printf("Espectro desativado: %s (%s)\n", name, FRESULT_str(res));
+#endif
+}
+
+// Bloco completo: analisa os três eixos e acrescenta as linhas ao .fft. As
+// linhas ficam no buffer do FIL até completar um setor
+void spectrum_file_block(void) {
+#if CAPTURE_SPECTRUM
+    static char text[SPECTRUM_TEXT_MAX];
+    UINT bw = 0;
+
+    int len = spectrum_format(&capture_spectrum, capture_start_us, text, sizeof(text));
+    FRESULT res = f_write(&spectrum_file, text, len, &bw);
+    if (res != FR_OK || bw != (UINT)len) {
+        printf("Erro ao gravar o espectro: %s\n", FRESULT_str(res));
+        f_close(&spectrum_file);
+        spectrum_file_open = false;
+    }
+#endif
+}
+
+void spectrum_file_end(void) {
+#if CAPTURE_SPECTRUM
+    if (!spectrum_file_open) return;
+    f_close(&spectrum_file);
+    spectrum_file_open = false;
+    printf("Espectro: %lu blocos de %d amostras\n",
+           (unsigned long)capture_spectrum.blocks, SPECTRUM_N);
+#endif
 }
 
 // Função para ler os arquivos csv existentes
@@ -408,8 +809,8 @@ void list_csv_files() {
     fr = f_getcwd(cwdbuf, sizeof(cwdbuf));
     if (fr != FR_OK) return;
 
-    // Abre o diretório e procura por arquivos .csv
-    fr = f_findfirst(&dir, &fno, cwdbuf, "*.csv");
+    // Abre o diretório e procura por arquivos de gravação (.csv ou .bin)
+    fr = f_findfirst(&dir, &fno, cwdbuf, "*" LOG_EXT);
     while (fr == FR_OK && fno.fname[0]) {
         // Adiciona ao vetor se couber
         if (csv_file_count < MAX_FILES) {
@@ -418,9 +819,9 @@ void list_csv_files() {
             csv_file_count++;
         }
 
-        // Se for no formato datalogN.csv, tenta extrair o número
+        // Se for no formato datalogN, tenta extrair o número
         int num;
-        if (sscanf(fno.fname, "datalog%d.csv", &num) == 1) {
+        if (sscanf(fno.fname, "datalog%d" LOG_EXT, &num) == 1) {
             if (num > max_index)
                 max_index = num;
         }
@@ -430,142 +831,22 @@ void list_csv_files() {
 
     f_closedir(&dir);
 
-    // Define o nome do próximo arquivo datalogN+1.csv
-    snprintf(filename, sizeof(filename), "datalog%d.csv", max_index + 1);
+    // Define o nome do próximo arquivo datalogN+1
+    snprintf(filename, sizeof(filename), "datalog%d" LOG_EXT, max_index + 1);
     printf("Próximo nome de arquivo: %s\n", filename);
 }
 
-// Função para selecionar um arquivo CSV
-void selecionar_arquivo_csv() {
-
-    if (csv_file_count == 0) {
-        set_led_magenta(); // Erro (magenta)
-        beep(2000, 2, 100); // Beep de erro
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "SEM CSV ENCONTRADO", 25);
-        ssd1306_send_data(&ssd);
-        sleep_ms(2000);
-        return;
-    }
-
-    int index = 0;
-    bool selecionar_arquivo = false;
-    bool sair_menu = false;
-
-    while (!selecionar_arquivo && !sair_menu) {
-        // Mostrar arquivo atual
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "SELECIONE CSV:", 5);
-        draw_centered_text(&ssd, csv_files[index], 25);
-        draw_centered_text(&ssd, "A: Selecionar", 45);
-        draw_centered_text(&ssd, "B: Voltar", 55);
-        ssd1306_send_data(&ssd);
-
-        // Leitura joystick
-        adc_select_input(1); // eixo X
-        uint16_t x_value = adc_read();
-
-        if (x_value < 500) {
-            index = (index - 1 + csv_file_count) % csv_file_count;
-        } else if (x_value > 2500) {
-            index = (index + 1) % csv_file_count;
-        }
-
-        // Verifica botões
-        if (selecionar) {
-            selecionar = false;
-            strncpy(filename, csv_files[index], sizeof(filename));
-            filename[sizeof(filename) - 1] = '\0';
-            selecionar_arquivo = true;
-        } else if (BUTTON_B_PRESSED == true) {
-            BUTTON_B_PRESSED = false; // Reseta o flag de botão B pressionado
-            sair_menu = true;
-        }
-
-        sleep_ms(200); // debounce
-    }
-
-    if (selecionar_arquivo) {
-        set_led_green(); // Pronto (verde)
-        beep(3000, 3, 100); // Beep de sucesso
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "ARQUIVO ATUAL:", 15);
-        draw_centered_text(&ssd, filename, 35);
-        ssd1306_send_data(&ssd);
-        sleep_ms(2000);
-    }
-}
-
-// Função para desenhar o menu na tela OLED
-void draw_menu() {
-    ssd1306_fill(&ssd, false);
-
-    turn_off_leds(); // Desliga LEDs durante a exibição do menu
-    
-    switch (current_state) {    
-        case MODO_MONTAR_DESMONTAR:
-            draw_centered_text(&ssd, "<>", 0);
-            draw_centered_text(&ssd, sd_card_is_mounted ? "DESMONTAR" : "MONTAR", 10);
-            draw_centered_text(&ssd, "A: Confirmar", 40);
-            
-            break;
-            
-        case MODO_GRAVAR:
-            draw_centered_text(&ssd, "<>", 0);
-            draw_centered_text(&ssd, "GRAVAR DADOS", 10);
-            draw_centered_text(&ssd, filename, 20);
-
-            draw_centered_text(&ssd, "A: Iniciar", 40);
-            break;
-            
-        case MODO_LER:
-            draw_centered_text(&ssd, "<>", 0);
-            draw_centered_text(&ssd, "LER ARQUIVO:", 10);
-            draw_centered_text(&ssd, filename, 20);
-            
-            draw_centered_text(&ssd, "A: Abrir", 40);
-            break;
-        case MODO_ALTERAR_ARQUIVO:
-            draw_centered_text(&ssd, "<>", 0);
-            draw_centered_text(&ssd, "ALTERAR ARQUIVO", 10);
-            draw_centered_text(&ssd, filename, 20);
-            
-            draw_centered_text(&ssd, "A: ALTERAR", 40);
-            break;
-        case MODO_BOOTSEL:
-            draw_centered_text(&ssd, "<>", 0);
-            draw_centered_text(&ssd, "HABILITAR", 10);
-            draw_centered_text(&ssd, "MODO BOOTSEL", 20);
-            draw_centered_text(&ssd, "A: Confirmar", 40);
-            break;
-    }
-    ssd1306_send_data(&ssd);
-}
-
-// Função para atualizar o menu com base no joystick
-void update_menu_from_joystick() {
-    adc_select_input(1); // Pino do eixo X do joystick
-    uint16_t x_value = adc_read();
-    
-    if (x_value < 500) { // Joystick para a ESQUERDA
-        if (current_state > MODO_MONTAR_DESMONTAR) current_state--;
-        else current_state = MODO_BOOTSEL; // Volta ao final
-    } 
-    else if (x_value > 2500) { // Joystick para a DIREITA
-        if (current_state < MODO_BOOTSEL) current_state++;
-        else current_state = MODO_MONTAR_DESMONTAR; // Volta ao início
-    }
-}
-
 // Função para tocar um beep com frequência e duração especificadas
-// Repetições é o número de vezes que o beep será tocado
+// Repetições é o número de vezes que o beep será tocado. Não bloqueia: os
+// tons seguem pelo sequenciador do buzzer
 void beep(uint frequency, uint repeticoes, uint duration) {
-    for (uint i = 0; i < repeticoes; i++) {
-        play_tone(BUZZER_PIN, frequency);
-        sleep_ms(duration);
-        stop_tone(BUZZER_PIN);
-        sleep_ms(duration);
-    }
+    buzzer_beep(BUZZER_PIN, frequency, repeticoes, duration);
+}
+
+// Mostra a cor de resultado por FEEDBACK_MS e apaga, sem bloquear
+void led_feedback(led_color_t color) {
+    led_step_t steps[] = { { color, FEEDBACK_MS }, { LED_OFF, 0 } };
+    led_play(steps, 2, false);
 }
 
 // Função para ler o conteúdo de um arquivo e exibir no terminal
@@ -577,67 +858,77 @@ void read_file(const char *filename)
 
     // Verifica se o cartão SD está montado
     if (!sd_card_is_mounted) {
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "ERRO", 20);
-        draw_centered_text(&ssd, "SD CARD", 30);
-        draw_centered_text(&ssd, "NAO MONTADO", 40);
-        ssd1306_send_data(&ssd);
-        set_led_magenta(); // Erro (magenta)
+        ui_show_message(&ui, "ERRO", "SD CARD", "NAO MONTADO", FEEDBACK_MS);
+        led_feedback(LED_MAGENTA); // Erro (magenta)
         beep(2000, 2, 100); // Beep de erro
-        sleep_ms(2000);
         return;
     }
 
-
+    // Aviso desenhado direto: a leitura bloqueia até terminar
     ssd1306_fill(&ssd, false);
     draw_centered_text(&ssd, "LENDO ARQUIVO", 10);
     draw_centered_text(&ssd, "(no terminal)", 20);
     draw_centered_text(&ssd, filename, 30);
     ssd1306_send_data(&ssd);
-    sleep_ms(2000); // Espera 2 segundos para mostrar a mensagem
-    
+
     FIL file;
     FRESULT res = f_open(&file, filename, FA_READ);
     if (res != FR_OK)
     {
         printf("[ERRO] Não foi possível abrir o arquivo para leitura. Verifique se o Cartão está montado ou se o arquivo existe.\n");
-        set_led_magenta(); // Erro (magenta)
+        led_feedback(LED_MAGENTA); // Erro (magenta)
         beep(2000, 2, 100); // Beep de erro
-        ssd1306_fill(&ssd, false);
-        draw_centered_text(&ssd, "ERRO AO LER", 20);
-        draw_centered_text(&ssd, "ARQUIVO", 30);
-        ssd1306_send_data(&ssd);
-        sleep_ms(2000);
+        ui_show_message(&ui, "ERRO AO LER", "ARQUIVO", NULL, FEEDBACK_MS);
         return;
     }
     char buffer[128];
     UINT br;
     printf("Conteúdo do arquivo %s:\n", filename);
-    while (f_read(&file, buffer, sizeof(buffer) - 1, &br) == FR_OK && br > 0)
+
+    // Arquivo binário: decodifica os quadros e exibe no formato CSV
+    binlog_header_t header;
+    if (f_read(&file, &header, sizeof(header), &br) == FR_OK && br == sizeof(header) &&
+        binlog_header_valid(&header))
+    {
+        binlog_frame_t frame;
+        uint32_t index = 0;
+        printf("amostra,accel_x,accel_y,accel_z,gyro_x,gyro_y,gyro_z,temp\n");
+        while (f_read(&file, &frame, sizeof(frame), &br) == FR_OK && br == sizeof(frame))
+        {
+            binlog_frame_to_csv(buffer, sizeof(buffer), &header, &frame, ++index);
+            printf("%s", buffer);
+        }
+    }
+    else
     {
-        buffer[br] = '\0';
-        printf("%s", buffer);
+        f_rewind(&file);
+        while (f_read(&file, buffer, sizeof(buffer) - 1, &br) == FR_OK && br > 0)
+        {
+            buffer[br] = '\0';
+            printf("%s", buffer);
+        }
     }
     f_close(&file);
-    ssd1306_fill(&ssd, false);
-    draw_centered_text(&ssd, "ARQUIVO LIDO", 20);
-    draw_centered_text(&ssd, "(no terminal)", 30);
-    ssd1306_draw_string(&ssd, filename, 5, 40);
-    ssd1306_send_data(&ssd);
-    set_led_green(); // Pronto (verde)
+    ui_show_message(&ui, "ARQUIVO LIDO", "(no terminal)", filename, FEEDBACK_MS);
+    led_feedback(LED_GREEN); // Pronto (verde)
     beep(3000, 3, 100); // Beep de sucesso
 
     printf("\nLeitura do arquivo %s concluída.\n\n", filename);
 }
 
-// Callback para os botões
-static void gpio_button_handler(uint gpio, uint32_t events){
+// Callback de GPIO do SDK: só as bordas de descida configuradas são botões
+static void gpio_irq_callback(uint gpio, uint32_t events) {
+    if (events & GPIO_IRQ_EDGE_FALL) gpio_button_handler(gpio);
+}
+
+// Botão pressionado: debounce e evento para o laço principal
+static void gpio_button_handler(uint gpio){
     uint32_t current_time = to_ms_since_boot(get_absolute_time());
     
         if(gpio == BUTTON_A && (current_time - last_time_debounce_button_a > delay_debounce)){
             printf("\nBOTAO A PRESSIONADO\n");
 
-            selecionar = true;
+            events_post(EVT_BUTTON_A, gpio);
         
 
             last_time_debounce_button_a = current_time; // Atualiza o tempo do último debounce do botão A
@@ -645,7 +936,7 @@ static void gpio_button_handler(uint gpio, uint32_t events){
         else if(gpio == BUTTON_B && (current_time - last_time_debounce_button_b > delay_debounce)){
             printf("\nBOTAO B PRESSIONADO\n");
 
-            if(MODO_ALTERAR_ARQUIVO) BUTTON_B_PRESSED = true; // Flag para indicar que o botão B foi pressionado
+            events_post(EVT_BUTTON_B, gpio);
 
             last_time_debounce_button_b = current_time; // Atualiza o tempo do último debounce do botão B
         }
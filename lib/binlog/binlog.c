@@ -0,0 +1,47 @@
+#include "binlog.h"
+#include <stdio.h>
+#include <string.h>
+
+void binlog_init_header(binlog_header_t *header, uint32_t sample_rate_hz, uint64_t start_time_us) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, BINLOG_MAGIC, sizeof(header->magic));
+    header->version = BINLOG_VERSION;
+    header->header_size = sizeof(binlog_header_t);
+    header->frame_size = sizeof(binlog_frame_t);
+    header->sample_rate_hz = sample_rate_hz;
+    header->accel_lsb_per_g = BINLOG_ACCEL_LSB_PER_G;
+    header->gyro_lsb_per_dps = BINLOG_GYRO_LSB_PER_DPS;
+    header->temp_lsb_per_c = BINLOG_TEMP_LSB_PER_C;
+    header->temp_offset_c = BINLOG_TEMP_OFFSET_C;
+    header->start_time_us = start_time_us;
+}
+
+bool binlog_header_valid(const binlog_header_t *header) {
+    return memcmp(header->magic, BINLOG_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == BINLOG_VERSION &&
+           header->header_size == sizeof(binlog_header_t) &&
+           header->frame_size == sizeof(binlog_frame_t);
+}
+
+void binlog_pack_frame(binlog_frame_t *frame, const sample_t *sample, uint64_t start_time_us) {
+    frame->timestamp_us = (uint32_t)(sample->timestamp_us - start_time_us);
+    for (int i = 0; i < 3; i++) {
+        frame->accel[i] = sample->accel[i];
+        frame->gyro[i] = sample->gyro[i];
+    }
+    frame->temp = sample->temp;
+}
+
+int binlog_frame_to_csv(char *buffer, size_t size, const binlog_header_t *header,
+                        const binlog_frame_t *frame, uint32_t index) {
+    return snprintf(buffer, size,
+        "%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n",
+        (unsigned long)index,
+        frame->accel[0] / header->accel_lsb_per_g,
+        frame->accel[1] / header->accel_lsb_per_g,
+        frame->accel[2] / header->accel_lsb_per_g,
+        frame->gyro[0] / header->gyro_lsb_per_dps,
+        frame->gyro[1] / header->gyro_lsb_per_dps,
+        frame->gyro[2] / header->gyro_lsb_per_dps,
+        (frame->temp / header->temp_lsb_per_c) + header->temp_offset_c);
+}
@@ -0,0 +1,57 @@
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../sampler/sampler.h"
+
+// Formato binário de gravação: um cabeçalho versionado seguido de quadros
+// compactos com as leituras cruas do MPU6050 (little-endian).
+// O script ArquivoDeDados/bin2csv.py converte de volta para o CSV usual.
+
+#define BINLOG_MAGIC "MPUL"
+#define BINLOG_VERSION 1
+
+// Fatores de escala do MPU6050 (mesmos usados na gravação em CSV)
+#define BINLOG_ACCEL_LSB_PER_G   16384.0f // ±2g
+#define BINLOG_GYRO_LSB_PER_DPS  131.0f   // ±250°/s
+#define BINLOG_TEMP_LSB_PER_C    340.0f
+#define BINLOG_TEMP_OFFSET_C     36.53f
+
+// Cabeçalho do arquivo (40 bytes)
+typedef struct __attribute__((packed)) {
+    char magic[4];            // "MPUL"
+    uint16_t version;         // BINLOG_VERSION
+    uint16_t header_size;     // sizeof(binlog_header_t)
+    uint16_t frame_size;      // sizeof(binlog_frame_t)
+    uint16_t reserved;
+    uint32_t sample_rate_hz;  // Taxa de amostragem nominal
+    float accel_lsb_per_g;    // Escala do acelerômetro
+    float gyro_lsb_per_dps;   // Escala do giroscópio
+    float temp_lsb_per_c;     // Escala da temperatura
+    float temp_offset_c;      // Offset da temperatura
+    uint64_t start_time_us;   // Instante da primeira amostra (us desde o boot)
+} binlog_header_t;
+
+// Quadro de uma amostra (18 bytes)
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_us;    // Tempo desde start_time_us (volta a zero após ~71 min)
+    int16_t accel[3];         // Aceleração crua (X, Y, Z)
+    int16_t gyro[3];          // Giroscópio cru (X, Y, Z)
+    int16_t temp;             // Temperatura crua
+} binlog_frame_t;
+
+// Preenche o cabeçalho com as escalas do sensor e a taxa de amostragem
+void binlog_init_header(binlog_header_t *header, uint32_t sample_rate_hz, uint64_t start_time_us);
+
+// Verifica se o cabeçalho é de um arquivo binário compatível
+bool binlog_header_valid(const binlog_header_t *header);
+
+// Empacota uma amostra em um quadro (tempo relativo ao início do arquivo)
+void binlog_pack_frame(binlog_frame_t *frame, const sample_t *sample, uint64_t start_time_us);
+
+// Converte um quadro para a linha CSV usual (amostra,accel_x,...,temp). Retorna o tamanho
+int binlog_frame_to_csv(char *buffer, size_t size, const binlog_header_t *header,
+                        const binlog_frame_t *frame, uint32_t index);
+
+#endif // BINLOG_H
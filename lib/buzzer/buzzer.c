@@ -1,6 +1,7 @@
 #include "buzzer.h"
 #include "hardware/pwm.h"
 #include "hardware/clocks.h"
+#include "hardware/sync.h"
 
 // Inicializa o PWM no pino do buzzer
 int init_buzzer(uint pin, float clk_div)
@@ -31,4 +32,87 @@ void stop_tone(uint pin)
 {
     uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_set_gpio_level(pin, 0); // Desliga o PWM
-}
\ No newline at end of file
+}
+
+// Sequência em andamento (o alarme roda no núcleo que chamou buzzer_play)
+static buzzer_step_t buzzer_steps[BUZZER_PATTERN_MAX];
+static uint8_t buzzer_count;
+static volatile uint8_t buzzer_step;
+static uint buzzer_pin;
+static volatile alarm_id_t buzzer_alarm;
+
+// Liga o tom do passo atual (ou silêncio)
+static void buzzer_apply_step(void)
+{
+    uint16_t frequency = buzzer_steps[buzzer_step].frequency;
+    if (frequency)
+        play_tone(buzzer_pin, frequency);
+    else
+        stop_tone(buzzer_pin);
+}
+
+// Fim de um passo: avança e reagenda o alarme a partir do instante previsto
+static int64_t buzzer_alarm_callback(alarm_id_t id, void *user_data)
+{
+    (void)id;
+    (void)user_data;
+
+    if (++buzzer_step >= buzzer_count) {
+        stop_tone(buzzer_pin);
+        buzzer_alarm = 0;
+        return 0;
+    }
+    buzzer_apply_step();
+    return -(int64_t)buzzer_steps[buzzer_step].duration_ms * 1000;
+}
+
+bool buzzer_play(uint pin, const buzzer_step_t *steps, uint8_t count)
+{
+    buzzer_stop();
+    if (count == 0 || count > BUZZER_PATTERN_MAX) return false;
+
+    for (uint8_t i = 0; i < count; i++) {
+        buzzer_steps[i] = steps[i];
+        if (buzzer_steps[i].duration_ms == 0) buzzer_steps[i].duration_ms = 1; // 0 cancelaria o alarme
+    }
+    buzzer_count = count;
+    buzzer_step = 0;
+    buzzer_pin = pin;
+    buzzer_apply_step();
+
+    // Sem interrupções até guardar o id: o alarme não pode terminar a sequência antes
+    uint32_t save = save_and_disable_interrupts();
+    alarm_id_t id = add_alarm_in_ms(buzzer_steps[0].duration_ms, buzzer_alarm_callback, NULL, true);
+    // Com o passo já vencido, o callback pode ter rodado dentro do add_alarm_in_ms
+    if (id > 0 && buzzer_step < buzzer_count) buzzer_alarm = id;
+    restore_interrupts(save);
+
+    if (id < 0) stop_tone(pin); // Sem alarmes livres (0: o passo já venceu e foi tratado)
+    return id >= 0;
+}
+
+bool buzzer_beep(uint pin, uint frequency, uint repeticoes, uint duration)
+{
+    buzzer_step_t steps[BUZZER_PATTERN_MAX];
+    uint8_t count = 0;
+
+    for (uint i = 0; i < repeticoes && count + 2 <= BUZZER_PATTERN_MAX; i++) {
+        steps[count++] = (buzzer_step_t){ frequency, duration };
+        steps[count++] = (buzzer_step_t){ 0, duration };
+    }
+    return buzzer_play(pin, steps, count);
+}
+
+void buzzer_stop(void)
+{
+    if (buzzer_alarm) {
+        cancel_alarm(buzzer_alarm);
+        buzzer_alarm = 0;
+        stop_tone(buzzer_pin);
+    }
+}
+
+bool buzzer_is_playing(void)
+{
+    return buzzer_alarm != 0;
+}
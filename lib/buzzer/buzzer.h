@@ -11,4 +11,18 @@ int init_buzzer(uint pin, float clk_div); // Inicializa o PWM no pino do buzzer
 void play_tone(uint pin, uint frequency); // Toca uma nota com a frequência e duração especificadas
 void stop_tone(uint pin);                 // Desliga o tom no pino do buzzer
 
+// Sequenciador: toca uma sequência de tons a partir de um alarme, sem bloquear.
+// Uma nova sequência substitui a que estiver tocando
+#define BUZZER_PATTERN_MAX 16
+
+typedef struct {
+    uint16_t frequency;   // Hz (0: silêncio)
+    uint16_t duration_ms; // Duração do passo
+} buzzer_step_t;
+
+bool buzzer_play(uint pin, const buzzer_step_t *steps, uint8_t count); // Copia os passos e começa já
+bool buzzer_beep(uint pin, uint frequency, uint repeticoes, uint duration); // Bipes com pausas de mesma duração
+void buzzer_stop(void);       // Interrompe a sequência e desliga o tom
+bool buzzer_is_playing(void);
+
 #endif // BUZZER_H
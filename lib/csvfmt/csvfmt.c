@@ -0,0 +1,66 @@
+#include "csvfmt.h"
+
+char *csvfmt_u32(char *p, uint32_t v) {
+    char tmp[10];
+    int n = 0;
+
+    do {
+        tmp[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    while (n) *p++ = tmp[--n];
+    return p;
+}
+
+char *csvfmt_hundredths(char *p, int32_t num, int32_t den) {
+    // O sinal sai mesmo quando o valor arredonda para zero ("-0.00"), como no printf
+    if (num < 0) *p++ = '-';
+    uint32_t mag = num < 0 ? -(uint32_t)num : (uint32_t)num;
+
+    uint32_t q = mag / (uint32_t)den;
+    uint32_t r2 = (mag % (uint32_t)den) * 2;
+    if (r2 > (uint32_t)den || (r2 == (uint32_t)den && (q & 1))) q++;
+
+    p = csvfmt_u32(p, q / 100);
+    uint32_t frac = q % 100;
+    p[0] = '.';
+    p[1] = '0' + frac / 10;
+    p[2] = '0' + frac % 10;
+    return p + 3;
+}
+
+// 100 * raw / 16384 = raw * 25 / 4096. A divisão em float é exata (potência de 2)
+// e pode cair exatamente na metade, por isso o arredondamento para o par
+char *csvfmt_accel(char *p, int16_t raw) {
+    return csvfmt_hundredths(p, (int32_t)raw * 25, 4096);
+}
+
+// 100 * raw / 131. Nunca cai na metade, e o erro do float (< 8e-6) é menor que
+// a menor distância até a metade (1/26200), então o resultado coincide
+char *csvfmt_gyro(char *p, int16_t raw) {
+    return csvfmt_hundredths(p, (int32_t)raw * 100, 131);
+}
+
+// 100 * (raw / 340 + 36.53) = (5 * raw + 62101) / 17. Mesma folga do giroscópio
+// em relação aos erros do float (incluindo o 36.53f inexato)
+char *csvfmt_temp(char *p, int16_t raw) {
+    return csvfmt_hundredths(p, (int32_t)raw * 5 + 62101, 17);
+}
+
+int csvfmt_sample(char *buffer, uint32_t index, const sample_t *sample) {
+    char *p = csvfmt_u32(buffer, index);
+
+    for (int i = 0; i < 3; i++) {
+        *p++ = ',';
+        p = csvfmt_accel(p, sample->accel[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+        *p++ = ',';
+        p = csvfmt_gyro(p, sample->gyro[i]);
+    }
+    *p++ = ',';
+    p = csvfmt_temp(p, sample->temp);
+    *p++ = '\n';
+    *p = '\0';
+    return p - buffer;
+}
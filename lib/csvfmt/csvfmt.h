@@ -0,0 +1,33 @@
+#ifndef CSVFMT_H
+#define CSVFMT_H
+
+#include <stdint.h>
+#include "../sampler/sampler.h"
+
+// Formatação das linhas CSV só com inteiros (sem printf de ponto flutuante).
+// Gera exatamente o mesmo texto que
+//   snprintf("%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", ...)
+// com as conversões em float usadas na gravação: accel / 16384.0f,
+// gyro / 131.0f e temp / 340.0f + 36.53f (inclusive o "-0.00" e o
+// arredondamento de empates para o par do %.2f).
+
+// Tamanho máximo de uma linha (com o '\0'): "4294967295," + 7 x "-250.13,"
+#define CSVFMT_LINE_MAX 72
+
+// Escreve v em decimal. Retorna o ponteiro após o último caractere
+char *csvfmt_u32(char *p, uint32_t v);
+
+// Escreve num / den / 100 com duas casas decimais, arredondando como o %.2f
+// (metade para o par). den deve ser positivo. Retorna o ponteiro após o texto
+char *csvfmt_hundredths(char *p, int32_t num, int32_t den);
+
+// Valores crus do MPU6050 em unidades físicas, com duas casas
+char *csvfmt_accel(char *p, int16_t raw); // g (±2g)
+char *csvfmt_gyro(char *p, int16_t raw);  // °/s (±250°/s)
+char *csvfmt_temp(char *p, int16_t raw);  // °C
+
+// Monta a linha "indice,ax,ay,az,gx,gy,gz,temp\n" em buffer (ao menos
+// CSVFMT_LINE_MAX bytes). Retorna o tamanho, sem o '\0'
+int csvfmt_sample(char *buffer, uint32_t index, const sample_t *sample);
+
+#endif // CSVFMT_H
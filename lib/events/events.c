@@ -0,0 +1,52 @@
+#include "events.h"
+#include "hardware/sync.h"
+#include "../ringbuf/ringbuf.h"
+
+static ringbuf_t events_queue;
+static event_t events_storage[EVENTS_QUEUE_LEN];
+static repeating_timer_t events_tick_timer;
+
+static bool events_tick_callback(repeating_timer_t *rt) {
+    (void)rt;
+    events_post(EVT_TICK, 0);
+    return true;
+}
+
+void events_init(void) {
+    ringbuf_init(&events_queue, events_storage, sizeof(event_t), EVENTS_QUEUE_LEN);
+}
+
+bool events_post(event_type_t type, uint32_t data) {
+    event_t event = { .type = type, .data = data };
+
+    // Vários produtores (interrupções de prioridades diferentes): o lado do
+    // produtor da fila SPSC é protegido desligando as interrupções
+    uint32_t save = save_and_disable_interrupts();
+    bool ok = ringbuf_push(&events_queue, &event);
+    restore_interrupts(save);
+
+    __sev(); // Acorda o laço principal parado em events_wait
+    return ok;
+}
+
+bool events_get(event_t *event) {
+    return ringbuf_pop(&events_queue, event);
+}
+
+bool events_pending(void) {
+    return ringbuf_count(&events_queue) > 0;
+}
+
+void events_wait(void) {
+    // Um evento postado entre o teste e o WFE deixa o registrador de evento
+    // ligado (SEV), então o WFE retorna na hora
+    if (!events_pending()) __wfe();
+}
+
+bool events_start_tick(uint32_t period_ms) {
+    return add_repeating_timer_ms(-(int32_t)period_ms, events_tick_callback, NULL, &events_tick_timer);
+}
+
+uint32_t events_dropped(void) {
+    return events_queue.overruns;
+}
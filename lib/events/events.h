@@ -0,0 +1,50 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Fila de eventos do laço principal. Produtores: interrupções (botões, timers
+// do joystick e do tique); consumidor: o laço principal no núcleo 0, que pode
+// dormir com events_wait enquanto a fila estiver vazia.
+
+// Tamanho da fila (potência de 2)
+#define EVENTS_QUEUE_LEN 32
+
+typedef enum {
+    // Entradas do usuário (índices da tabela de estados do menu)
+    EVT_BUTTON_A,
+    EVT_BUTTON_B,
+    EVT_JOY_LEFT,
+    EVT_JOY_RIGHT,
+    EVT_INPUT_COUNT,
+
+    EVT_TICK = EVT_INPUT_COUNT // Tique periódico (tarefas com prazo, ex.: display)
+} event_type_t;
+
+typedef struct {
+    uint8_t type;   // event_type_t
+    uint32_t data;  // Dado do produtor (ex.: GPIO do botão)
+} event_t;
+
+void events_init(void);
+
+// Enfileira um evento e acorda o núcleo (seguro em interrupções do núcleo 0).
+// Retorna false se a fila estiver cheia
+bool events_post(event_type_t type, uint32_t data);
+
+// Retira o próximo evento; false se a fila estiver vazia
+bool events_get(event_t *event);
+bool events_pending(void);
+
+// Dorme (WFE) até algum evento ser enfileirado; retorna na hora se já houver
+void events_wait(void);
+
+// Gera EVT_TICK a cada period_ms
+bool events_start_tick(uint32_t period_ms);
+
+// Eventos recusados por fila cheia
+uint32_t events_dropped(void);
+
+#endif // EVENTS_H
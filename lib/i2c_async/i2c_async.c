@@ -0,0 +1,168 @@
+#include "i2c_async.h"
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Interrupções do controlador tratadas pelo motor
+#define I2C_ASYNC_INTR_MASK (I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS)
+
+// Motor de cada instância de I2C, para o tratador de interrupção
+static i2c_async_t *i2c_async_bus[2];
+
+// Monta as palavras de DATA_CMD e dispara os dois canais de DMA
+static void i2c_async_start(i2c_async_t *bus) {
+    i2c_async_xfer_t *x = bus->queue[bus->head];
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < x->tx_len; i++)
+        bus->cmd[n++] = x->tx[i];
+    for (uint32_t i = 0; i < x->rx_len; i++) {
+        uint16_t word = I2C_IC_DATA_CMD_CMD_BITS; // Leitura
+        if (i == 0 && x->tx_len > 0) word |= I2C_IC_DATA_CMD_RESTART_BITS;
+        bus->cmd[n++] = word;
+    }
+    bus->cmd[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS; // STOP após o último byte
+
+    // O endereço só pode ser trocado com o controlador desligado. Um STOP_DET
+    // deixado por uma escrita bloqueante não pode encerrar esta transação
+    hw->enable = 0;
+    hw->tar = x->addr;
+    (void)hw->clr_stop_det;
+    hw->enable = 1;
+    hw->intr_mask = I2C_ASYNC_INTR_MASK;
+
+    if (x->rx_len > 0) {
+        dma_channel_config c = dma_channel_get_default_config(bus->rx_dma);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, i2c_get_dreq(bus->i2c, false));
+        dma_channel_configure(bus->rx_dma, &c, x->rx, &hw->data_cmd, x->rx_len, true);
+    }
+
+    // Escritas de 16 bits num registrador do APB são replicadas nas duas metades
+    // da palavra; os bits 16-31 de DATA_CMD são reservados, então não há efeito
+    dma_channel_config c = dma_channel_get_default_config(bus->tx_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(bus->i2c, true));
+    dma_channel_configure(bus->tx_dma, &c, &hw->data_cmd, bus->cmd, n, true);
+}
+
+// Fim da transação atual (STOP_DET): avisa o chamador e inicia a próxima
+static void i2c_async_irq(i2c_async_t *bus) {
+    i2c_hw_t *hw = i2c_get_hw(bus->i2c);
+    uint32_t stat = hw->intr_stat;
+    if (!(stat & (I2C_IC_INTR_STAT_R_STOP_DET_BITS | I2C_IC_INTR_STAT_R_TX_ABRT_BITS)))
+        return;
+
+    // Fila vazia: o evento não é nosso. Os bits ficam para quem os espera
+    // (as funções bloqueantes do SDK consultam STOP_DET e TX_ABRT)
+    if (bus->count == 0) {
+        hw->intr_mask = 0;
+        return;
+    }
+
+    i2c_async_xfer_t *x = bus->queue[bus->head];
+    int status = I2C_ASYNC_OK;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // O controlador descarta o resto da FIFO: os canais param antes de
+        // liberar o TX_ABRT, senão o DMA segue empurrando palavras nela
+        dma_channel_abort(bus->tx_dma);
+        dma_channel_abort(bus->rx_dma);
+        (void)hw->clr_tx_abrt;
+        status = I2C_ASYNC_ERR_ABORT;
+        // O STOP_DET que vem em seguida encerra a transação
+        if (!(stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS)) {
+            x->status = status;
+            return;
+        }
+    }
+    (void)hw->clr_stop_det;
+    if (x->status != I2C_ASYNC_OK) status = x->status;
+
+    // O último byte lido pode ainda estar a caminho da memória
+    if (status == I2C_ASYNC_OK && x->rx_len > 0)
+        while (dma_channel_is_busy(bus->rx_dma)) tight_loop_contents();
+
+    bus->head = (bus->head + 1) % I2C_ASYNC_QUEUE_LEN;
+    bus->count--;
+    if (bus->count > 0) i2c_async_start(bus);
+    else hw->intr_mask = 0; // Barramento livre para as funções bloqueantes
+
+    x->status = status;
+    x->busy = false;
+    if (x->done) x->done(x, status);
+}
+
+static void i2c_async_irq0(void) {
+    i2c_async_irq(i2c_async_bus[0]);
+}
+
+static void i2c_async_irq1(void) {
+    i2c_async_irq(i2c_async_bus[1]);
+}
+
+void i2c_async_init(i2c_async_t *bus, i2c_inst_t *i2c) {
+    uint index = i2c_hw_index(i2c);
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+
+    bus->i2c = i2c;
+    bus->head = 0;
+    bus->count = 0;
+    bus->tx_dma = dma_claim_unused_channel(true);
+    bus->rx_dma = dma_claim_unused_channel(true);
+    i2c_async_bus[index] = bus;
+
+    // DREQ assim que houver espaço (TX) ou um byte (RX) na FIFO
+    hw->dma_tdlr = 4;
+    hw->dma_rdlr = 0;
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = 0; // Só habilitadas enquanto houver transações
+
+    uint irq = index ? I2C1_IRQ : I2C0_IRQ;
+    irq_set_exclusive_handler(irq, index ? i2c_async_irq1 : i2c_async_irq0);
+    irq_set_enabled(irq, true);
+}
+
+bool i2c_async_submit(i2c_async_t *bus, i2c_async_xfer_t *xfer) {
+    uint32_t len = (uint32_t)xfer->tx_len + xfer->rx_len;
+    if (len == 0 || len > I2C_ASYNC_MAX_LEN) return false;
+
+    uint32_t save = save_and_disable_interrupts();
+    if (bus->count == I2C_ASYNC_QUEUE_LEN) {
+        restore_interrupts(save);
+        return false;
+    }
+    xfer->status = I2C_ASYNC_OK;
+    xfer->busy = true;
+    bus->queue[(bus->head + bus->count) % I2C_ASYNC_QUEUE_LEN] = xfer;
+    if (bus->count++ == 0) i2c_async_start(bus); // Barramento livre: começa já
+    restore_interrupts(save);
+    return true;
+}
+
+bool i2c_async_write_read(i2c_async_t *bus, i2c_async_xfer_t *xfer, uint8_t addr,
+                          const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len,
+                          i2c_async_done_t done, void *context) {
+    xfer->addr = addr;
+    xfer->tx = tx;
+    xfer->tx_len = tx_len;
+    xfer->rx = rx;
+    xfer->rx_len = rx_len;
+    xfer->done = done;
+    xfer->context = context;
+    return i2c_async_submit(bus, xfer);
+}
+
+bool i2c_async_busy(const i2c_async_t *bus) {
+    return bus->count > 0;
+}
+
+void i2c_async_wait(const i2c_async_t *bus) {
+    while (bus->count > 0) tight_loop_contents();
+}
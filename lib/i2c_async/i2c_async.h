@@ -0,0 +1,77 @@
+#ifndef I2C_ASYNC_H
+#define I2C_ASYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/i2c.h"
+
+// Transferências I2C sem bloquear a CPU.
+// Cada transação (escrita seguida opcionalmente de leitura com RESTART) entra
+// numa fila; o controlador recebe as palavras de DATA_CMD (dado + bits
+// CMD/STOP/RESTART) por DMA e outro canal de DMA recolhe os bytes lidos.
+// O fim é detectado pela interrupção STOP_DET do próprio I2C, que chama o
+// callback da transação e inicia a próxima da fila.
+//
+// Enquanto houver transações em andamento, o barramento não deve ser usado
+// pelas funções bloqueantes (i2c_write_blocking/i2c_read_blocking). Com a
+// fila vazia elas podem ser usadas: as interrupções STOP_DET/TX_ABRT só ficam
+// habilitadas enquanto há transações, e o tratador não toca nos bits delas.
+
+// Transações na fila de cada barramento
+#define I2C_ASYNC_QUEUE_LEN 8
+
+// Maior transação (bytes escritos + lidos): um quadro completo do SSD1306
+#define I2C_ASYNC_MAX_LEN 1040
+
+// Resultado passado ao callback
+#define I2C_ASYNC_OK         0
+#define I2C_ASYNC_ERR_ABORT -1 // NACK ou perda de arbitragem (TX_ABRT)
+
+typedef struct i2c_async_xfer i2c_async_xfer_t;
+
+// Chamado na interrupção do I2C quando a transação termina
+typedef void (*i2c_async_done_t)(i2c_async_xfer_t *xfer, int status);
+
+// Transação. Deve permanecer válida (assim como tx e rx) até o callback
+struct i2c_async_xfer {
+    uint8_t addr;             // Endereço de 7 bits
+    const uint8_t *tx;        // Bytes escritos primeiro (pode ser NULL)
+    uint16_t tx_len;
+    uint8_t *rx;              // Bytes lidos depois, com RESTART (pode ser NULL)
+    uint16_t rx_len;
+    i2c_async_done_t done;    // Callback de conclusão (pode ser NULL)
+    void *context;            // Livre para o chamador
+    volatile int status;      // Resultado; I2C_ASYNC_OK ou I2C_ASYNC_ERR_*
+    volatile bool busy;       // Na fila ou em andamento
+};
+
+// Estado de um barramento
+typedef struct {
+    i2c_inst_t *i2c;
+    uint tx_dma, rx_dma;
+    i2c_async_xfer_t *queue[I2C_ASYNC_QUEUE_LEN];
+    volatile uint8_t head;    // Transação em andamento
+    volatile uint8_t count;   // Transações na fila (incluindo a em andamento)
+    uint16_t cmd[I2C_ASYNC_MAX_LEN]; // Palavras de DATA_CMD da transação atual
+} i2c_async_t;
+
+// Associa o motor a um barramento já inicializado com i2c_init.
+// Reserva dois canais de DMA e a interrupção do I2C no núcleo atual
+void i2c_async_init(i2c_async_t *bus, i2c_inst_t *i2c);
+
+// Coloca a transação na fila. Retorna false se a fila estiver cheia ou a
+// transação for grande demais. Deve ser chamada no núcleo do i2c_async_init
+bool i2c_async_submit(i2c_async_t *bus, i2c_async_xfer_t *xfer);
+
+// Preenche e enfileira uma transação (atalho para i2c_async_submit)
+bool i2c_async_write_read(i2c_async_t *bus, i2c_async_xfer_t *xfer, uint8_t addr,
+                          const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len,
+                          i2c_async_done_t done, void *context);
+
+// true enquanto houver transações na fila
+bool i2c_async_busy(const i2c_async_t *bus);
+
+// Aguarda o fim de todas as transações
+void i2c_async_wait(const i2c_async_t *bus);
+
+#endif // I2C_ASYNC_H
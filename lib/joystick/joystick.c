@@ -0,0 +1,38 @@
+#include "joystick.h"
+#include "hardware/adc.h"
+#include "../events/events.h"
+
+static repeating_timer_t joystick_timer;
+static uint joystick_adc_input;
+static uint32_t joystick_period_ms;
+static int8_t joystick_direction;  // -1 esquerda, 0 centro, 1 direita
+static uint32_t joystick_held_ms;  // Tempo desde o último evento na direção atual
+
+static bool joystick_callback(repeating_timer_t *rt) {
+    (void)rt;
+
+    adc_select_input(joystick_adc_input);
+    uint16_t value = adc_read();
+    int8_t direction = value < JOYSTICK_LOW ? -1 : value > JOYSTICK_HIGH ? 1 : 0;
+
+    if (direction != joystick_direction) {
+        joystick_direction = direction;
+        joystick_held_ms = 0;
+        if (direction == 0) return true;
+    } else {
+        if (direction == 0) return true;
+        joystick_held_ms += joystick_period_ms;
+        if (joystick_held_ms < JOYSTICK_REPEAT_MS) return true;
+        joystick_held_ms = 0;
+    }
+    events_post(direction < 0 ? EVT_JOY_LEFT : EVT_JOY_RIGHT, value);
+    return true;
+}
+
+bool joystick_init(uint adc_input, uint32_t period_ms) {
+    joystick_adc_input = adc_input;
+    joystick_period_ms = period_ms;
+    joystick_direction = 0;
+    joystick_held_ms = 0;
+    return add_repeating_timer_ms(-(int32_t)period_ms, joystick_callback, NULL, &joystick_timer);
+}
@@ -0,0 +1,19 @@
+#ifndef JOYSTICK_H
+#define JOYSTICK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+// Amostragem do eixo X do joystick por timer: gera EVT_JOY_LEFT/EVT_JOY_RIGHT
+// (lib/events) ao sair do centro e, mantido inclinado, repete a cada
+// JOYSTICK_REPEAT_MS. O ADC passa a ser usado só pelo timer.
+
+#define JOYSTICK_LOW 500        // Abaixo: esquerda
+#define JOYSTICK_HIGH 2500      // Acima: direita
+#define JOYSTICK_REPEAT_MS 300  // Repetição com o joystick mantido inclinado
+
+// adc_input: entrada do ADC do eixo X (o GPIO já configurado com adc_gpio_init)
+bool joystick_init(uint adc_input, uint32_t period_ms);
+
+#endif // JOYSTICK_H
@@ -1,4 +1,24 @@
 #include "led.h"
+#include "hardware/sync.h"
+
+// Sequência em andamento
+static led_step_t led_steps[LED_PATTERN_MAX];
+static uint8_t led_count;
+static volatile uint8_t led_step;
+static bool led_repeat;
+static volatile alarm_id_t led_alarm;
+
+// Acende a combinação de LEDs da cor
+static void led_apply(led_color_t color)
+{
+    bool red = color == LED_RED || color == LED_YELLOW || color == LED_MAGENTA || color == LED_WHITE;
+    bool green = color == LED_GREEN || color == LED_YELLOW || color == LED_CYAN || color == LED_WHITE;
+    bool blue = color == LED_BLUE || color == LED_CYAN || color == LED_MAGENTA || color == LED_WHITE;
+
+    gpio_put(RED_LED_PIN, red);
+    gpio_put(GREEN_LED_PIN, green);
+    gpio_put(BLUE_LED_PIN, blue);
+}
 
 void init_led(uint8_t pin)
 {
@@ -15,53 +35,99 @@ void init_leds()
 
 void turn_on_leds()
 {
-    gpio_put(GREEN_LED_PIN, true);
-    gpio_put(BLUE_LED_PIN, true);
-    gpio_put(RED_LED_PIN, true);
+    set_led_color(LED_WHITE);
 }
 
 void turn_off_leds()
 {
-    gpio_put(GREEN_LED_PIN, false);
-    gpio_put(BLUE_LED_PIN, false);
-    gpio_put(RED_LED_PIN, false);
+    set_led_color(LED_OFF);
 }
 
 void set_led_green()
 {
-    turn_off_leds();
-    gpio_put(GREEN_LED_PIN, true);
+    set_led_color(LED_GREEN);
 }
 
 void set_led_blue()
 {
-    turn_off_leds();
-    gpio_put(BLUE_LED_PIN, true);
+    set_led_color(LED_BLUE);
 }
 
 void set_led_red()
 {
-    turn_off_leds();
-    gpio_put(RED_LED_PIN, true);
+    set_led_color(LED_RED);
 }
 
 void set_led_yellow()
 {
-    turn_off_leds();
-    gpio_put(GREEN_LED_PIN, true);
-    gpio_put(RED_LED_PIN, true);
+    set_led_color(LED_YELLOW);
 }
 
 void set_led_cyan()
 {
-    turn_off_leds();
-    gpio_put(GREEN_LED_PIN, true);
-    gpio_put(BLUE_LED_PIN, true);
+    set_led_color(LED_CYAN);
 }
 
 void set_led_magenta()
 {
-    turn_off_leds();
-    gpio_put(RED_LED_PIN, true);
-    gpio_put(BLUE_LED_PIN, true);
-}
\ No newline at end of file
+    set_led_color(LED_MAGENTA);
+}
+
+void set_led_color(led_color_t color)
+{
+    led_stop();
+    led_apply(color);
+}
+
+// Fim de um passo: avança (ou volta ao início) e reagenda o alarme
+static int64_t led_alarm_callback(alarm_id_t id, void *user_data)
+{
+    (void)id;
+    (void)user_data;
+
+    uint8_t next = led_step + 1;
+    if (next >= led_count) next = 0; // Só chega aqui com repetição
+    led_step = next;
+    led_apply(led_steps[next].color);
+
+    if (next == led_count - 1 && !led_repeat) {
+        led_alarm = 0; // A cor do último passo permanece
+        return 0;
+    }
+    uint16_t duration = led_steps[next].duration_ms;
+    return -(int64_t)(duration ? duration : 1) * 1000; // 0 cancelaria o alarme
+}
+
+bool led_play(const led_step_t *steps, uint8_t count, bool repeat)
+{
+    led_stop();
+    if (count == 0 || count > LED_PATTERN_MAX) return false;
+
+    for (uint8_t i = 0; i < count; i++)
+        led_steps[i] = steps[i];
+    led_count = count;
+    led_step = 0;
+    led_repeat = repeat;
+    led_apply(led_steps[0].color);
+    if (count == 1 && !repeat) return true; // Cor fixa
+
+    // Sem interrupções até guardar o id: o alarme não pode terminar a sequência antes
+    uint32_t save = save_and_disable_interrupts();
+    alarm_id_t id = add_alarm_in_ms(led_steps[0].duration_ms, led_alarm_callback, NULL, true);
+    if (id > 0) led_alarm = id;
+    restore_interrupts(save);
+    return id >= 0;
+}
+
+void led_stop(void)
+{
+    if (led_alarm) {
+        cancel_alarm(led_alarm);
+        led_alarm = 0;
+    }
+}
+
+bool led_is_playing(void)
+{
+    return led_alarm != 0;
+}
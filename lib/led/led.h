@@ -19,4 +19,31 @@ void set_led_yellow();
 void set_led_cyan();
 void set_led_magenta();
 
+// Cores do LED RGB
+typedef enum {
+    LED_OFF,
+    LED_RED,
+    LED_GREEN,
+    LED_BLUE,
+    LED_YELLOW,
+    LED_CYAN,
+    LED_MAGENTA,
+    LED_WHITE
+} led_color_t;
+
+// Sequenciador: troca as cores a partir de um alarme, sem bloquear. Ao fim de
+// uma sequência sem repetição, a cor do último passo permanece. As funções
+// set_led_* e turn_*_leds interrompem a sequência em andamento
+#define LED_PATTERN_MAX 8
+
+typedef struct {
+    led_color_t color;
+    uint16_t duration_ms;
+} led_step_t;
+
+void set_led_color(led_color_t color);
+bool led_play(const led_step_t *steps, uint8_t count, bool repeat);
+void led_stop(void);
+bool led_is_playing(void);
+
 #endif // LED_H
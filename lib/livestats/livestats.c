@@ -0,0 +1,134 @@
+#include "livestats.h"
+#include <string.h>
+
+// Bits de fração de m2_q: o produto dos desvios tem 2 * LIVESTATS_FRAC_BITS
+#define LIVESTATS_M2_FRAC_BITS 4
+#define LIVESTATS_M2_SHIFT (2 * LIVESTATS_FRAC_BITS - LIVESTATS_M2_FRAC_BITS)
+
+uint32_t livestats_isqrt64(uint64_t v) {
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+static uint32_t livestats_isqrt32(uint32_t v) {
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= root + bit) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+// Divisão com arredondamento para o mais próximo (d > 0)
+static int32_t livestats_div_round(int32_t n, int32_t d) {
+    return n >= 0 ? (n + d / 2) / d : (n - d / 2) / d;
+}
+
+int32_t livestats_round(int64_t value_q) {
+    int64_t half = 1 << (LIVESTATS_FRAC_BITS - 1);
+    return (int32_t)(value_q >= 0 ? (value_q + half) >> LIVESTATS_FRAC_BITS
+                                  : -((-value_q + half) >> LIVESTATS_FRAC_BITS));
+}
+
+void livestats_channel_reset(livestats_channel_t *ch) {
+    memset(ch, 0, sizeof(*ch));
+    ch->min = INT16_MAX;
+    ch->max = INT16_MIN;
+}
+
+// Welford: delta usa a média anterior e o segundo fator a nova, então o
+// produto nunca é negativo. |x| < 2^15 deixa delta abaixo de 2^28 (cabe em
+// 32 bits) e o produto abaixo de 2^56
+void livestats_channel_add(livestats_channel_t *ch, int16_t x) {
+    int32_t x_q = (int32_t)x << LIVESTATS_FRAC_BITS;
+
+    ch->count++;
+    int32_t delta = x_q - ch->mean_q;
+    ch->mean_q += livestats_div_round(delta, (int32_t)ch->count);
+    int64_t prod = (int64_t)delta * (x_q - ch->mean_q);
+    if (prod > 0) ch->m2_q += ((uint64_t)prod + (1u << (LIVESTATS_M2_SHIFT - 1))) >> LIVESTATS_M2_SHIFT;
+
+    if (x < ch->min) ch->min = x;
+    if (x > ch->max) ch->max = x;
+}
+
+int32_t livestats_mean_q(const livestats_channel_t *ch) {
+    return ch->mean_q;
+}
+
+// Variância em LSB² com 2 * LIVESTATS_FRAC_BITS bits de fração
+static uint64_t livestats_var_q2(const livestats_channel_t *ch) {
+    if (ch->count == 0) return 0;
+    return (ch->m2_q / ch->count) << LIVESTATS_M2_SHIFT;
+}
+
+uint32_t livestats_std_q(const livestats_channel_t *ch) {
+    return livestats_isqrt64(livestats_var_q2(ch));
+}
+
+// RMS² = variância + média²
+uint32_t livestats_rms_q(const livestats_channel_t *ch) {
+    int64_t mean = ch->mean_q;
+    return livestats_isqrt64(livestats_var_q2(ch) + (uint64_t)(mean * mean));
+}
+
+static void livestats_env_add(livestats_env_t *env, uint16_t v) {
+    if (env->pending == 0 || v < env->cur_min) env->cur_min = v;
+    if (env->pending == 0 || v > env->cur_max) env->cur_max = v;
+    if (++env->pending < env->decimation) return;
+
+    // Bloco completo: fecha a coluna, sobrescrevendo a mais antiga
+    env->min[env->head] = env->cur_min;
+    env->max[env->head] = env->cur_max;
+    env->head = (env->head + 1) % LIVESTATS_ENV_LEN;
+    if (env->filled < LIVESTATS_ENV_LEN) env->filled++;
+    env->columns++;
+    env->pending = 0;
+}
+
+void livestats_reset(livestats_t *ls, uint32_t decimation) {
+    for (int i = 0; i < 3; i++) {
+        livestats_channel_reset(&ls->accel[i]);
+        livestats_channel_reset(&ls->gyro[i]);
+    }
+    memset(&ls->env, 0, sizeof(ls->env));
+    ls->env.decimation = decimation ? decimation : 1;
+}
+
+void livestats_add(livestats_t *ls, const sample_t *sample) {
+    uint32_t sq = 0;
+
+    for (int i = 0; i < 3; i++) {
+        livestats_channel_add(&ls->accel[i], sample->accel[i]);
+        livestats_channel_add(&ls->gyro[i], sample->gyro[i]);
+        sq += (uint32_t)((int32_t)sample->accel[i] * sample->accel[i]);
+    }
+    // 3 * 2^30 ainda cabe em 32 bits; o módulo vai até ~56756 LSB (3,46 g)
+    livestats_env_add(&ls->env, (uint16_t)livestats_isqrt32(sq));
+}
+
+void livestats_env_column(const livestats_env_t *env, uint32_t i, uint16_t *min, uint16_t *max) {
+    uint32_t index = (env->head + LIVESTATS_ENV_LEN - env->filled + i) % LIVESTATS_ENV_LEN;
+    *min = env->min[index];
+    *max = env->max[index];
+}
@@ -0,0 +1,72 @@
+#ifndef LIVESTATS_H
+#define LIVESTATS_H
+
+#include <stdint.h>
+#include "../sampler/sampler.h"
+
+// Estatísticas incrementais da gravação, atualizadas a cada amostra em O(1),
+// só com inteiros e sem alocação:
+// - por canal: mínimo, máximo, média e variância (Welford) e RMS;
+// - envelope dizimado do módulo da aceleração: cada coluna guarda o mínimo e
+//   o máximo de um bloco de amostras, para o gráfico da tela de gravação.
+//
+// Valores em LSB do sensor (converter com as escalas de lib/csvfmt). A média
+// guarda LIVESTATS_FRAC_BITS bits de fração, para a variância não depender
+// do arredondamento da média.
+
+#define LIVESTATS_FRAC_BITS 12
+
+// Colunas do envelope (largura do gráfico na tela)
+#define LIVESTATS_ENV_LEN 116
+
+typedef struct {
+    uint32_t count;
+    int32_t mean_q;   // Média em LSB, com LIVESTATS_FRAC_BITS bits de fração
+    uint64_t m2_q;    // Soma dos quadrados dos desvios em LSB², com 4 bits de fração
+    int16_t min;
+    int16_t max;
+} livestats_channel_t;
+
+typedef struct {
+    uint16_t min[LIVESTATS_ENV_LEN]; // Módulo da aceleração em LSB
+    uint16_t max[LIVESTATS_ENV_LEN];
+    uint32_t head;       // Próxima coluna a ser escrita
+    uint32_t filled;     // Colunas válidas (até LIVESTATS_ENV_LEN)
+    uint32_t columns;    // Colunas fechadas desde o reset (muda a cada coluna nova)
+    uint32_t decimation; // Amostras por coluna
+    uint32_t pending;    // Amostras já acumuladas na coluna aberta
+    uint16_t cur_min;
+    uint16_t cur_max;
+} livestats_env_t;
+
+typedef struct {
+    livestats_channel_t accel[3];
+    livestats_channel_t gyro[3];
+    livestats_env_t env; // Módulo da aceleração
+} livestats_t;
+
+void livestats_channel_reset(livestats_channel_t *ch);
+void livestats_channel_add(livestats_channel_t *ch, int16_t x);
+
+// Média, desvio padrão (populacional) e RMS em LSB, com LIVESTATS_FRAC_BITS
+// bits de fração
+int32_t livestats_mean_q(const livestats_channel_t *ch);
+uint32_t livestats_std_q(const livestats_channel_t *ch);
+uint32_t livestats_rms_q(const livestats_channel_t *ch);
+
+// Raiz quadrada inteira (piso), bit a bit: só somas e deslocamentos
+uint32_t livestats_isqrt64(uint64_t v);
+
+// Arredonda um valor com LIVESTATS_FRAC_BITS bits de fração para LSB inteiros
+int32_t livestats_round(int64_t value_q);
+
+// Zera tudo. decimation: amostras por coluna do envelope (mínimo 1)
+void livestats_reset(livestats_t *ls, uint32_t decimation);
+
+// Acumula uma amostra nos seis eixos e no envelope
+void livestats_add(livestats_t *ls, const sample_t *sample);
+
+// Coluna i do envelope, da mais antiga (0) à mais recente (filled - 1)
+void livestats_env_column(const livestats_env_t *env, uint32_t i, uint16_t *min, uint16_t *max);
+
+#endif // LIVESTATS_H
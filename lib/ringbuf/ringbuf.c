@@ -0,0 +1,142 @@
+#include "ringbuf.h"
+#include <string.h>
+
+bool ringbuf_init(ringbuf_t *rb, void *storage, uint32_t record_size, uint32_t capacity) {
+    if (rb == NULL || storage == NULL || record_size == 0) return false;
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) return false;
+
+    rb->buffer = storage;
+    rb->record_size = record_size;
+    rb->capacity = capacity;
+    rb->mask = capacity - 1;
+    ringbuf_reset(rb);
+    return true;
+}
+
+void ringbuf_reset(ringbuf_t *rb) {
+    atomic_store_explicit(&rb->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, 0, memory_order_relaxed);
+    rb->overruns = 0;
+    rb->high_water = 0;
+    atomic_thread_fence(memory_order_seq_cst);
+}
+
+uint32_t ringbuf_count(const ringbuf_t *rb) {
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    return head - tail;
+}
+
+uint32_t ringbuf_free(const ringbuf_t *rb) {
+    return rb->capacity - ringbuf_count(rb);
+}
+
+// Copia n registros para a fila a partir do índice head (pode dar a volta)
+static void ringbuf_copy_in(ringbuf_t *rb, uint32_t head, const uint8_t *src, uint32_t n) {
+    uint32_t idx = head & rb->mask;
+    uint32_t first = rb->capacity - idx;
+    if (first > n) first = n;
+
+    memcpy(rb->buffer + idx * rb->record_size, src, first * rb->record_size);
+    if (n > first)
+        memcpy(rb->buffer, src + first * rb->record_size, (n - first) * rb->record_size);
+}
+
+// Copia n registros da fila a partir do índice tail (pode dar a volta)
+static void ringbuf_copy_out(const ringbuf_t *rb, uint32_t tail, uint8_t *dst, uint32_t n) {
+    uint32_t idx = tail & rb->mask;
+    uint32_t first = rb->capacity - idx;
+    if (first > n) first = n;
+
+    memcpy(dst, rb->buffer + idx * rb->record_size, first * rb->record_size);
+    if (n > first)
+        memcpy(dst + first * rb->record_size, rb->buffer, (n - first) * rb->record_size);
+}
+
+// Publica o novo head e atualiza a ocupação máxima
+static void ringbuf_publish(ringbuf_t *rb, uint32_t head, uint32_t tail) {
+    atomic_store_explicit(&rb->head, head, memory_order_release);
+    if (head - tail > rb->high_water) rb->high_water = head - tail;
+}
+
+bool ringbuf_push(ringbuf_t *rb, const void *record) {
+    return ringbuf_push_n(rb, record, 1) == 1;
+}
+
+uint32_t ringbuf_push_n(ringbuf_t *rb, const void *records, uint32_t n) {
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    uint32_t space = rb->capacity - (head - tail);
+    uint32_t count = n < space ? n : space;
+
+    if (count > 0) {
+        ringbuf_copy_in(rb, head, records, count);
+        ringbuf_publish(rb, head + count, tail);
+    }
+    rb->overruns += n - count;
+    return count;
+}
+
+uint32_t ringbuf_write_reserve(ringbuf_t *rb, void **span) {
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    uint32_t space = rb->capacity - (head - tail);
+    uint32_t idx = head & rb->mask;
+    uint32_t contiguous = rb->capacity - idx;
+
+    *span = rb->buffer + idx * rb->record_size;
+    return space < contiguous ? space : contiguous;
+}
+
+void ringbuf_write_commit(ringbuf_t *rb, uint32_t n) {
+    if (n == 0) return;
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    ringbuf_publish(rb, head + n, tail);
+}
+
+void ringbuf_add_overruns(ringbuf_t *rb, uint32_t n) {
+    rb->overruns += n;
+}
+
+bool ringbuf_pop(ringbuf_t *rb, void *record) {
+    return ringbuf_pop_n(rb, record, 1) == 1;
+}
+
+uint32_t ringbuf_pop_n(ringbuf_t *rb, void *records, uint32_t n) {
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    uint32_t avail = head - tail;
+    uint32_t count = n < avail ? n : avail;
+
+    if (count > 0) {
+        ringbuf_copy_out(rb, tail, records, count);
+        atomic_store_explicit(&rb->tail, tail + count, memory_order_release);
+    }
+    return count;
+}
+
+uint32_t ringbuf_read_peek(ringbuf_t *rb, const void **span) {
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    uint32_t avail = head - tail;
+    uint32_t idx = tail & rb->mask;
+    uint32_t contiguous = rb->capacity - idx;
+
+    *span = rb->buffer + idx * rb->record_size;
+    return avail < contiguous ? avail : contiguous;
+}
+
+void ringbuf_read_release(ringbuf_t *rb, uint32_t n) {
+    if (n == 0) return;
+    uint32_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    atomic_store_explicit(&rb->tail, tail + n, memory_order_release);
+}
+
+uint32_t ringbuf_overruns(const ringbuf_t *rb) {
+    return rb->overruns;
+}
+
+uint32_t ringbuf_high_water(const ringbuf_t *rb) {
+    return rb->high_water;
+}
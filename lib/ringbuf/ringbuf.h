@@ -0,0 +1,78 @@
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Fila circular lock-free para um produtor e um consumidor (SPSC) de registros
+// de tamanho fixo. Não depende do SDK do Pico: compila também no host.
+//
+// O produtor escreve apenas head e o consumidor apenas tail; cada índice fica
+// em sua própria linha de cache para evitar falso compartilhamento.
+
+// Alinhamento dos índices (tamanho de linha de cache no host)
+#ifndef RINGBUF_CACHE_LINE
+#define RINGBUF_CACHE_LINE 64
+#endif
+
+typedef struct {
+    uint8_t *buffer;      // Área de armazenamento (capacity * record_size bytes)
+    uint32_t record_size; // Tamanho de cada registro (bytes)
+    uint32_t capacity;    // Quantidade de registros (potência de 2)
+    uint32_t mask;        // capacity - 1
+
+    // Lado do produtor
+    _Alignas(RINGBUF_CACHE_LINE) _Atomic uint32_t head;
+    uint32_t overruns;    // Registros recusados por fila cheia
+    uint32_t high_water;  // Maior ocupação observada
+
+    // Lado do consumidor
+    _Alignas(RINGBUF_CACHE_LINE) _Atomic uint32_t tail;
+} ringbuf_t;
+
+// Inicializa a fila sobre uma área fornecida pelo chamador.
+// Retorna false se capacity não for potência de 2 ou os parâmetros forem inválidos
+bool ringbuf_init(ringbuf_t *rb, void *storage, uint32_t record_size, uint32_t capacity);
+
+// Esvazia a fila e zera os contadores (não pode haver produtor/consumidor ativo)
+void ringbuf_reset(ringbuf_t *rb);
+
+// Ocupação e espaço livre (em registros)
+uint32_t ringbuf_count(const ringbuf_t *rb);
+uint32_t ringbuf_free(const ringbuf_t *rb);
+
+/*================== PRODUTOR ==================*/
+// Insere um registro. Retorna false (e conta um overrun) se a fila estiver cheia
+bool ringbuf_push(ringbuf_t *rb, const void *record);
+
+// Insere até n registros. Retorna quantos couberam; os demais contam como overrun
+uint32_t ringbuf_push_n(ringbuf_t *rb, const void *records, uint32_t n);
+
+// Acesso sem cópia: obtém o trecho contíguo livre (em registros) e seu endereço
+uint32_t ringbuf_write_reserve(ringbuf_t *rb, void **span);
+
+// Publica n registros escritos no trecho obtido por ringbuf_write_reserve
+void ringbuf_write_commit(ringbuf_t *rb, uint32_t n);
+
+// Contabiliza n registros perdidos pelo produtor (ex.: reserve sem espaço)
+void ringbuf_add_overruns(ringbuf_t *rb, uint32_t n);
+
+/*================== CONSUMIDOR ==================*/
+// Retira um registro. Retorna false se a fila estiver vazia
+bool ringbuf_pop(ringbuf_t *rb, void *record);
+
+// Retira até n registros. Retorna quantos foram copiados
+uint32_t ringbuf_pop_n(ringbuf_t *rb, void *records, uint32_t n);
+
+// Acesso sem cópia: obtém o trecho contíguo legível (em registros) e seu endereço
+uint32_t ringbuf_read_peek(ringbuf_t *rb, const void **span);
+
+// Libera n registros lidos do trecho obtido por ringbuf_read_peek
+void ringbuf_read_release(ringbuf_t *rb, uint32_t n);
+
+/*================== ESTATÍSTICAS ==================*/
+uint32_t ringbuf_overruns(const ringbuf_t *rb);
+uint32_t ringbuf_high_water(const ringbuf_t *rb);
+
+#endif // RINGBUF_H
@@ -0,0 +1,130 @@
+#include "runstats.h"
+#include <stdio.h>
+#include "../csvfmt/csvfmt.h"
+
+// Nome e conversão para unidades físicas de cada canal, na ordem do CSV
+typedef char *(*runstats_fmt_t)(char *p, int16_t raw);
+
+// Escala das dispersões (desvio padrão e RMS), sem o deslocamento da
+// temperatura: centésimos = LSB * num / den
+typedef struct {
+    int32_t num;
+    int32_t den;
+} runstats_scale_t;
+
+static const char *const runstats_names[RUNSTATS_CHANNELS] = {
+    "accel_x_g", "accel_y_g", "accel_z_g",
+    "gyro_x_dps", "gyro_y_dps", "gyro_z_dps",
+    "temp_c",
+};
+
+static const runstats_fmt_t runstats_fmts[RUNSTATS_CHANNELS] = {
+    csvfmt_accel, csvfmt_accel, csvfmt_accel,
+    csvfmt_gyro, csvfmt_gyro, csvfmt_gyro,
+    csvfmt_temp,
+};
+
+static const runstats_scale_t runstats_scales[RUNSTATS_CHANNELS] = {
+    {25, 4096}, {25, 4096}, {25, 4096},  // 100 / 16384
+    {100, 131}, {100, 131}, {100, 131},
+    {5, 17},                             // 100 / 340
+};
+
+static const livestats_channel_t *runstats_channel(const runstats_t *rs, int c) {
+    if (c < 3) return &rs->live.accel[c];
+    if (c < 6) return &rs->live.gyro[c - 3];
+    return &rs->temp;
+}
+
+void runstats_reset(runstats_t *rs, uint32_t decimation) {
+    rs->count = 0;
+    rs->first_us = 0;
+    rs->last_us = 0;
+    rs->interval_min_us = UINT32_MAX;
+    rs->interval_max_us = 0;
+    livestats_reset(&rs->live, decimation);
+    livestats_channel_reset(&rs->temp);
+}
+
+void runstats_add(runstats_t *rs, const sample_t *sample) {
+    if (rs->count == 0) {
+        rs->first_us = sample->timestamp_us;
+    } else {
+        uint32_t interval = (uint32_t)(sample->timestamp_us - rs->last_us);
+        if (interval < rs->interval_min_us) rs->interval_min_us = interval;
+        if (interval > rs->interval_max_us) rs->interval_max_us = interval;
+    }
+    rs->last_us = sample->timestamp_us;
+    rs->count++;
+
+    livestats_add(&rs->live, sample);
+    livestats_channel_add(&rs->temp, sample->temp);
+}
+
+int runstats_format(const runstats_t *rs, const char *data_file,
+                    const sd_wbuf_stats_t *sd, char *buffer, size_t size) {
+    uint64_t span_us = rs->count > 1 ? rs->last_us - rs->first_us : 0;
+    uint32_t intervals = rs->count > 1 ? rs->count - 1 : 0;
+    // Taxa efetiva em centésimos de Hz: intervalos medidos pela duração
+    uint64_t rate_centi = span_us ? (uint64_t)intervals * 100000000u / span_us : 0;
+    int n = 0;
+
+    n += snprintf(buffer + n, size - n,
+                  "arquivo=%s\n"
+                  "amostras=%lu\n"
+                  "duracao_s=%llu.%02llu\n"
+                  "taxa_configurada_hz=%lu\n"
+                  "taxa_efetiva_hz=%llu.%02llu\n",
+                  data_file, (unsigned long)rs->count,
+                  (unsigned long long)(span_us / 1000000u), (unsigned long long)(span_us / 10000u % 100),
+                  (unsigned long)sampler_get_rate(),
+                  (unsigned long long)(rate_centi / 100), (unsigned long long)(rate_centi % 100));
+    n += snprintf(buffer + n, size - n,
+                  "intervalo_min_us=%lu\n"
+                  "intervalo_medio_us=%llu\n"
+                  "intervalo_max_us=%lu\n"
+                  "descartadas=%lu\n"
+                  "fifo_transbordos=%lu\n"
+                  "erros_i2c=%lu\n",
+                  (unsigned long)(intervals ? rs->interval_min_us : 0),
+                  (unsigned long long)(intervals ? span_us / intervals : 0),
+                  (unsigned long)rs->interval_max_us,
+                  (unsigned long)sampler_dropped(),
+                  (unsigned long)sampler_fifo_overflows(),
+                  (unsigned long)sampler_bus_errors());
+    n += snprintf(buffer + n, size - n,
+                  "sd_bytes=%llu\n"
+                  "sd_escritas=%lu\n"
+                  "sd_bytes_por_s=%lu\n"
+                  "sd_escrita_p50_us=%lu\n"
+                  "sd_escrita_p90_us=%lu\n"
+                  "sd_escrita_p99_us=%lu\n"
+                  "sd_escrita_max_us=%lu\n"
+                  "\n"
+                  "canal,min,media,max,desvio,rms\n",
+                  (unsigned long long)sd->bytes, (unsigned long)sd->writes,
+                  (unsigned long)sd->bytes_per_s,
+                  (unsigned long)sd->p50_write_us, (unsigned long)sd->p90_write_us,
+                  (unsigned long)sd->p99_write_us, (unsigned long)sd->max_write_us);
+
+    // Valores em unidades físicas com as mesmas conversões do CSV. O RMS da
+    // temperatura não tem sentido (escala com deslocamento) e fica vazio
+    for (int c = 0; c < RUNSTATS_CHANNELS && rs->count > 0; c++) {
+        const livestats_channel_t *ch = runstats_channel(rs, c);
+        const runstats_scale_t *sc = &runstats_scales[c];
+        char line[CSVFMT_LINE_MAX];
+        char *p = line;
+        p = runstats_fmts[c](p, ch->min);
+        *p++ = ',';
+        p = runstats_fmts[c](p, (int16_t)livestats_round(livestats_mean_q(ch)));
+        *p++ = ',';
+        p = runstats_fmts[c](p, ch->max);
+        *p++ = ',';
+        p = csvfmt_hundredths(p, livestats_round(livestats_std_q(ch)) * sc->num, sc->den);
+        *p++ = ',';
+        if (c < 6) p = csvfmt_hundredths(p, livestats_round(livestats_rms_q(ch)) * sc->num, sc->den);
+        *p = '\0';
+        n += snprintf(buffer + n, size - n, "%s,%s\n", runstats_names[c], line);
+    }
+    return n < (int)size ? n : (int)size - 1;
+}
@@ -0,0 +1,43 @@
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../sampler/sampler.h"
+#include "../sd/sd_wbuf.h"
+#include "../livestats/livestats.h"
+
+// Resumo de uma gravação, acumulado amostra a amostra (O(1), sem guardar as
+// amostras): intervalo entre amostras e as estatísticas de cada canal
+// (lib/livestats, que a tela de gravação também usa). No fim vira o texto do
+// arquivo datalogN.stats, ao lado do arquivo de dados.
+
+// Canais de uma amostra: accel X/Y/Z, gyro X/Y/Z e temperatura
+#define RUNSTATS_CHANNELS 7
+
+// Tamanho suficiente para o texto de runstats_format
+#define RUNSTATS_TEXT_MAX 1024
+
+typedef struct {
+    uint32_t count;            // Amostras acumuladas
+    uint64_t first_us;         // Carimbo da primeira amostra
+    uint64_t last_us;          // Carimbo da última amostra
+    uint32_t interval_min_us;  // Menor intervalo entre amostras consecutivas
+    uint32_t interval_max_us;  // Maior intervalo (mostra amostras perdidas)
+    livestats_t live;          // Eixos do acelerômetro e do giroscópio, envelope
+    livestats_channel_t temp;  // Temperatura
+} runstats_t;
+
+// Zera o resumo (início da gravação). decimation: amostras por coluna do
+// envelope de livestats
+void runstats_reset(runstats_t *rs, uint32_t decimation);
+
+// Acumula uma amostra (na ordem da gravação)
+void runstats_add(runstats_t *rs, const sample_t *sample);
+
+// Monta o texto do resumo em buffer (ao menos RUNSTATS_TEXT_MAX bytes), junto
+// com os contadores do sampler e as estatísticas do SD. Retorna o tamanho
+int runstats_format(const runstats_t *rs, const char *data_file,
+                    const sd_wbuf_stats_t *sd, char *buffer, size_t size);
+
+#endif // RUNSTATS_H
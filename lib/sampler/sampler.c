@@ -0,0 +1,255 @@
+#include "sampler.h"
+#include "pico/multicore.h"
+#include "../sensors/mpu6050/mpu6050.h"
+#include "../ringbuf/ringbuf.h"
+#include "../trace/trace.h"
+
+// Comandos enviados ao núcleo 1 pela FIFO entre núcleos
+#define SAMPLER_CMD_START 1u
+#define SAMPLER_CMD_STOP  2u
+#define SAMPLER_ACK_OK    0u
+#define SAMPLER_ACK_FAIL  1u
+
+// Filtro do sensor no modo FIFO (mantém a base de 1 kHz do divisor)
+#define SAMPLER_FIFO_DLPF MPU6050_DLPF_184HZ
+#define SAMPLER_FIFO_BASE_HZ 1000u
+
+// Registros recolhidos por callback no modo FIFO: a FIFO cheia mais o que
+// chega enquanto ela é lida
+#define SAMPLER_FIFO_DRAIN_MAX (MPU6050_FIFO_MAX_RECORDS + 2 * SAMPLER_FIFO_BATCH)
+
+// Estado do amostrador
+static i2c_inst_t *sampler_i2c = NULL;
+static uint32_t sampler_rate_hz = 100;
+static sampler_core_t sampler_core = SAMPLER_CORE0;
+static sampler_core_t sampler_active_core = SAMPLER_CORE0;
+static sampler_mode_t sampler_mode = SAMPLER_MODE_TIMER;
+static repeating_timer_t sampler_timer;
+static repeating_timer_callback_t sampler_callback; // Callback do modo ativo
+static int64_t sampler_timer_period_us;              // Período do timer do modo ativo
+static volatile uint32_t sampler_fifo_overflow_count = 0;
+static volatile uint32_t sampler_bus_error_count = 0;
+static volatile bool sampler_running = false;
+static bool sampler_core1_launched = false;
+
+// Fila lock-free produtor único/consumidor único:
+// o callback do timer produz (núcleo 0 ou 1) e o laço principal consome (núcleo 0)
+static sample_t sampler_storage[SAMPLER_QUEUE_LEN];
+static ringbuf_t sampler_rb;
+
+// Copia uma leitura do sensor para a amostra
+static inline void sampler_fill(sample_t *s, const mpu6050_raw_t *raw) {
+    for (int i = 0; i < 3; i++) {
+        s->accel[i] = raw->accel[i];
+        s->gyro[i] = raw->gyro[i];
+    }
+    s->temp = raw->temp;
+}
+
+// Callback do timer: lê o sensor no instante agendado, independente da UI e do SD
+static bool sampler_timer_callback(repeating_timer_t *rt) {
+    uint64_t now = time_us_64();
+    void *span;
+
+    // Fila cheia: descarta a amostra e contabiliza
+    if (ringbuf_write_reserve(&sampler_rb, &span) == 0) {
+        ringbuf_add_overruns(&sampler_rb, 1);
+        return sampler_running;
+    }
+
+    // Uma única transação I2C: accel, temp e gyro do mesmo instante
+    mpu6050_raw_t raw;
+    TRACE_BEGIN(TRACE_SENSOR_READ);
+    bool ok = mpu6050_read_burst(sampler_i2c, &raw);
+    TRACE_END(TRACE_SENSOR_READ);
+    if (!ok) {
+        sampler_bus_error_count++; // Falha no I2C, não na fila
+        return sampler_running;
+    }
+    sample_t *s = span;
+    s->timestamp_us = now;
+    sampler_fill(s, &raw);
+    ringbuf_write_commit(&sampler_rb, 1);
+
+    return sampler_running;
+}
+
+// Callback do modo FIFO: esvazia a FIFO do sensor inteira e só então data os
+// registros. O mais novo (o último lido) recebe o instante medido antes da
+// rajada que o trouxe; os demais recuam um período por posição no conjunto,
+// de modo que rajadas seguidas não repetem nem invertem instantes
+static bool sampler_fifo_callback(repeating_timer_t *rt) {
+    static mpu6050_raw_t records[SAMPLER_FIFO_DRAIN_MAX];
+    uint32_t period_us = sampler_get_period_us();
+    uint32_t total = 0;
+    uint64_t newest_us = 0;
+    uint32_t max;
+    int n;
+
+    do {
+        max = SAMPLER_FIFO_DRAIN_MAX - total;
+        if (max > 2 * SAMPLER_FIFO_BATCH) max = 2 * SAMPLER_FIFO_BATCH;
+        uint64_t now = time_us_64();
+        TRACE_BEGIN(TRACE_SENSOR_READ);
+        n = mpu6050_fifo_read(sampler_i2c, &records[total], max);
+        TRACE_END(TRACE_SENSOR_READ);
+        if (n == MPU6050_FIFO_ERR_OVERFLOW) sampler_fifo_overflow_count++;
+        if (n == MPU6050_FIFO_ERR_BUS) sampler_bus_error_count++;
+        if (n > 0) {
+            total += n;
+            newest_us = now;
+        }
+    } while (n == (int)max && total < SAMPLER_FIFO_DRAIN_MAX); // Ainda pode haver mais na FIFO
+
+    for (uint32_t i = 0; i < total; i++) {
+        void *span;
+        if (ringbuf_write_reserve(&sampler_rb, &span) == 0) {
+            ringbuf_add_overruns(&sampler_rb, total - i);
+            break;
+        }
+        sample_t *s = span;
+        s->timestamp_us = newest_us - (uint64_t)(total - 1 - i) * period_us;
+        sampler_fill(s, &records[i]);
+        ringbuf_write_commit(&sampler_rb, 1);
+    }
+
+    return sampler_running;
+}
+
+// Laço do núcleo 1: mantém um pool de alarmes próprio e atende comandos do núcleo 0
+static void sampler_core1_entry(void) {
+    alarm_pool_t *pool = alarm_pool_create_with_unused_hardware_alarm(4);
+
+    while (true) {
+        uint32_t cmd = multicore_fifo_pop_blocking();
+        uint32_t ack = SAMPLER_ACK_OK;
+
+        if (cmd == SAMPLER_CMD_START) {
+            if (!alarm_pool_add_repeating_timer_us(pool, -sampler_timer_period_us, sampler_callback, NULL, &sampler_timer))
+                ack = SAMPLER_ACK_FAIL;
+        } else if (cmd == SAMPLER_CMD_STOP) {
+            cancel_repeating_timer(&sampler_timer);
+        }
+        multicore_fifo_push_blocking(ack);
+    }
+}
+
+// Envia um comando ao núcleo 1 e aguarda a confirmação
+static bool sampler_core1_command(uint32_t cmd) {
+    if (!sampler_core1_launched) {
+        multicore_launch_core1(sampler_core1_entry);
+        sampler_core1_launched = true;
+    }
+    multicore_fifo_push_blocking(cmd);
+    return multicore_fifo_pop_blocking() == SAMPLER_ACK_OK;
+}
+
+void sampler_init(i2c_inst_t *i2c_port, uint32_t rate_hz) {
+    sampler_i2c = i2c_port;
+    sampler_set_rate(rate_hz);
+    ringbuf_init(&sampler_rb, sampler_storage, sizeof(sample_t), SAMPLER_QUEUE_LEN);
+}
+
+void sampler_set_core(sampler_core_t core) {
+    sampler_core = core;
+}
+
+void sampler_set_mode(sampler_mode_t mode) {
+    sampler_mode = mode;
+}
+
+void sampler_set_rate(uint32_t rate_hz) {
+    if (rate_hz < SAMPLER_RATE_MIN_HZ) rate_hz = SAMPLER_RATE_MIN_HZ;
+    if (rate_hz > SAMPLER_RATE_MAX_HZ) rate_hz = SAMPLER_RATE_MAX_HZ;
+    sampler_rate_hz = rate_hz;
+}
+
+uint32_t sampler_get_rate(void) {
+    if (sampler_mode == SAMPLER_MODE_FIFO)
+        return SAMPLER_FIFO_BASE_HZ / (SAMPLER_FIFO_BASE_HZ / sampler_rate_hz);
+    return sampler_rate_hz;
+}
+
+uint32_t sampler_get_period_us(void) {
+    return 1000000u / sampler_get_rate();
+}
+
+bool sampler_start(void) {
+    if (sampler_running || sampler_i2c == NULL) return false;
+
+    // Esvazia a fila e zera os contadores
+    ringbuf_reset(&sampler_rb);
+    sampler_fifo_overflow_count = 0;
+    sampler_bus_error_count = 0;
+
+    if (sampler_mode == SAMPLER_MODE_FIFO) {
+        // O sensor passa a amostrar sozinho; o timer só recolhe as rajadas
+        if (mpu6050_fifo_enable(sampler_i2c, sampler_get_rate(), SAMPLER_FIFO_DLPF) == 0)
+            return false;
+        sampler_callback = sampler_fifo_callback;
+        sampler_timer_period_us = (int64_t)sampler_get_period_us() * SAMPLER_FIFO_BATCH;
+    } else {
+        sampler_callback = sampler_timer_callback;
+        sampler_timer_period_us = sampler_get_period_us();
+    }
+    sampler_running = true;
+    sampler_active_core = sampler_core;
+
+    bool ok;
+    if (sampler_active_core == SAMPLER_CORE1) {
+        ok = sampler_core1_command(SAMPLER_CMD_START);
+    } else {
+        // Período negativo: intervalo medido entre inícios de callback (taxa fixa)
+        ok = add_repeating_timer_us(-sampler_timer_period_us, sampler_callback, NULL, &sampler_timer);
+    }
+
+    if (!ok) {
+        sampler_running = false;
+        if (sampler_mode == SAMPLER_MODE_FIFO) mpu6050_fifo_disable(sampler_i2c);
+    }
+    return ok;
+}
+
+void sampler_stop(void) {
+    if (!sampler_running) return;
+    sampler_running = false;
+
+    if (sampler_active_core == SAMPLER_CORE1)
+        sampler_core1_command(SAMPLER_CMD_STOP);
+    else
+        cancel_repeating_timer(&sampler_timer);
+
+    // Recolhe o que ficou na FIFO do sensor e a desliga
+    if (sampler_callback == sampler_fifo_callback) {
+        sampler_fifo_callback(&sampler_timer);
+        mpu6050_fifo_disable(sampler_i2c);
+    }
+}
+
+bool sampler_pop(sample_t *sample) {
+    return ringbuf_pop(&sampler_rb, sample);
+}
+
+uint32_t sampler_pop_n(sample_t *samples, uint32_t max) {
+    return ringbuf_pop_n(&sampler_rb, samples, max);
+}
+
+uint32_t sampler_available(void) {
+    return ringbuf_count(&sampler_rb);
+}
+
+uint32_t sampler_dropped(void) {
+    return ringbuf_overruns(&sampler_rb);
+}
+
+uint32_t sampler_high_water(void) {
+    return ringbuf_high_water(&sampler_rb);
+}
+
+uint32_t sampler_fifo_overflows(void) {
+    return sampler_fifo_overflow_count;
+}
+
+uint32_t sampler_bus_errors(void) {
+    return sampler_bus_error_count;
+}
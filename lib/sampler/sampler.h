@@ -0,0 +1,86 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Limites da taxa de amostragem (em Hz)
+#define SAMPLER_RATE_MIN_HZ 1
+#define SAMPLER_RATE_MAX_HZ 1000
+
+// Tamanho da fila de amostras (deve ser potência de 2)
+#define SAMPLER_QUEUE_LEN 256
+
+// Amostra crua do MPU6050 com carimbo de tempo
+typedef struct {
+    uint64_t timestamp_us; // Instante da leitura (us desde o boot)
+    int16_t accel[3];      // Aceleração crua (X, Y, Z)
+    int16_t gyro[3];       // Giroscópio cru (X, Y, Z)
+    int16_t temp;          // Temperatura crua
+} sample_t;
+
+// Núcleo onde o timer de aquisição é executado
+typedef enum {
+    SAMPLER_CORE0, // Timer no núcleo 0, junto com UI e SD
+    SAMPLER_CORE1  // Timer dedicado no núcleo 1 (produtor/consumidor entre núcleos)
+} sampler_core_t;
+
+// Forma de aquisição
+typedef enum {
+    SAMPLER_MODE_TIMER, // Uma leitura dos registradores por período do timer
+    SAMPLER_MODE_FIFO   // O sensor amostra sozinho; o timer esvazia a FIFO dele em rajadas
+} sampler_mode_t;
+
+// Modo FIFO: períodos de amostragem entre duas rajadas (a FIFO do MPU6050
+// comporta MPU6050_FIFO_MAX_RECORDS = 73 amostras, então sobra folga)
+#define SAMPLER_FIFO_BATCH 16
+
+// Configura o amostrador (taxa limitada a SAMPLER_RATE_MIN_HZ..SAMPLER_RATE_MAX_HZ)
+void sampler_init(i2c_inst_t *i2c_port, uint32_t rate_hz);
+
+// Seleciona o núcleo da aquisição (só tem efeito no próximo sampler_start)
+void sampler_set_core(sampler_core_t core);
+
+// Seleciona a forma de aquisição (só tem efeito no próximo sampler_start)
+void sampler_set_mode(sampler_mode_t mode);
+
+// Altera a taxa de amostragem (só tem efeito no próximo sampler_start)
+void sampler_set_rate(uint32_t rate_hz);
+
+// Retorna a taxa de amostragem configurada (em Hz). No modo FIFO é a taxa que
+// o divisor do sensor consegue gerar (1000 / n Hz)
+uint32_t sampler_get_rate(void);
+
+// Retorna o período de amostragem (em us)
+uint32_t sampler_get_period_us(void);
+
+// Inicia a amostragem periódica pelo timer de hardware
+bool sampler_start(void);
+
+// Para a amostragem
+void sampler_stop(void);
+
+// Retira a amostra mais antiga da fila. Retorna false se a fila estiver vazia
+bool sampler_pop(sample_t *sample);
+
+// Retira até max amostras de uma vez. Retorna quantas foram copiadas
+uint32_t sampler_pop_n(sample_t *samples, uint32_t max);
+
+// Quantidade de amostras aguardando na fila
+uint32_t sampler_available(void);
+
+// Quantidade de amostras descartadas por fila cheia desde o último start (overruns)
+uint32_t sampler_dropped(void);
+
+// Maior ocupação da fila observada desde o último start
+uint32_t sampler_high_water(void);
+
+// Modo FIFO: vezes que a FIFO do sensor transbordou desde o último start
+uint32_t sampler_fifo_overflows(void);
+
+// Leituras do sensor que falharam no I2C desde o último start (amostras
+// perdidas sem passar pela fila)
+uint32_t sampler_bus_errors(void);
+
+#endif // SAMPLER_H
@@ -28,6 +28,8 @@ specific language governing permissions and limitations under the License.
  * limitations under the License.
  */
 
+#include <stdbool.h>
+
 #include "crc.h"
 
 static const char m_Crc7Table[] = {0x00, 0x09, 0x12, 0x1B, 0x24, 0x2D, 0x36,
@@ -84,12 +86,55 @@ static const unsigned short m_Crc16Table[256] = {0x0000, 0x1021, 0x2042,
 	0x8FD9, 0x9FF8, 0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1,
 	0x1EF0};
 
+/* Slice-by-8 tables for CRC16-CCITT (polynomial 0x1021, MSB first).
+ * m_Crc16Slices[k][b] is the CRC of byte b followed by k + 1 zero bytes, so
+ * eight input bytes are folded with eight independent lookups instead of a
+ * chain of eight dependent ones. The slices are derived from m_Crc16Table
+ * on first use and live in RAM (3.5 KiB), which is faster than the XIP flash
+ * for random access. */
+static unsigned short m_Crc16Slices[7][256];
+static volatile bool m_Crc16SlicesReady;
+
+static void crc16_init_slices(void) {
+	// Both cores may get here at once; they write the same values
+	for (int b = 0; b < 256; b++) {
+		unsigned short crc = m_Crc16Table[b];
+		for (int k = 0; k < 7; k++) {
+			crc = (unsigned short)((crc << 8) ^ m_Crc16Table[crc >> 8]);
+			m_Crc16Slices[k][b] = crc;
+		}
+	}
+	m_Crc16SlicesReady = true;
+}
+
+static unsigned short crc16_slice8(unsigned short crc, const unsigned char *p, size_t length) {
+	if (!m_Crc16SlicesReady) crc16_init_slices();
+
+	while (length >= 8) {
+		crc = m_Crc16Slices[6][p[0] ^ (crc >> 8)] ^
+		      m_Crc16Slices[5][p[1] ^ (crc & 0xFF)] ^
+		      m_Crc16Slices[4][p[2]] ^
+		      m_Crc16Slices[3][p[3]] ^
+		      m_Crc16Slices[2][p[4]] ^
+		      m_Crc16Slices[1][p[5]] ^
+		      m_Crc16Slices[0][p[6]] ^
+		      m_Crc16Table[p[7]];
+		p += 8;
+		length -= 8;
+	}
+	while (length--) {
+		crc = (unsigned short)((crc << 8) ^ m_Crc16Table[(crc >> 8) ^ *p++]);
+	}
+	return crc;
+}
+
 char crc7(const char* data, int length)
 {
 	//Calculate the CRC7 checksum for the specified data block
-	char crc = 0;
+	//(unsigned index: char is signed on some hosts)
+	unsigned char crc = 0;
 	for (int i = 0; i < length; i++) {
-		crc = m_Crc7Table[(crc << 1) ^ data[i]];
+		crc = m_Crc7Table[(crc << 1) ^ (unsigned char)data[i]];
 	}
 
 	//Return the calculated checksum
@@ -99,18 +144,11 @@ char crc7(const char* data, int length)
 unsigned short crc16(const char* data, int length)
 {
 	//Calculate the CRC16 checksum for the specified data block
-	unsigned short crc = 0;
-	for (int i = 0; i < length; i++) {
-		crc = (crc << 8) ^ m_Crc16Table[((crc >> 8) ^ data[i]) & 0x00FF];
-	}
-
-	//Return the calculated checksum
-	return crc;
+	if (length <= 0) return 0;
+	return crc16_slice8(0, (const unsigned char *)data, (size_t)length);
 }
 
 void update_crc16(unsigned short *pCrc16, const char data[], size_t length) {
-	for (size_t i = 0; i < length; i++) {
-		*pCrc16 = (*pCrc16 << 8) ^ m_Crc16Table[((*pCrc16 >> 8) ^ data[i]) & 0x00FF];
-	}    
+	*pCrc16 = crc16_slice8(*pCrc16, (const unsigned char *)data, length);
 }
 /* [] END OF FILE */
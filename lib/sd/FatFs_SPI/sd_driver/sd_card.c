@@ -164,6 +164,7 @@ specific language governing permissions and limitations under the License.
 #include <string.h>
 //
 #include "pico/mutex.h"
+#include "pico/platform.h"
 //
 #include "hw_config.h"  // Hardware Configuration of the SPI and SD Card "objects"
 #include "my_debug.h"
@@ -174,6 +175,8 @@ specific language governing permissions and limitations under the License.
 #include "ff.h" /* Obtains integer types */
 //
 #include "diskio.h" /* Declarations of disk functions */  // Needed for STA_NOINIT, ...
+//
+#include "../../../trace/trace.h"  // Latency probes (compiled out unless TRACE_ENABLED)
 
 #ifndef SD_CRC_ENABLED
 #define SD_CRC_ENABLED 1
@@ -351,11 +354,13 @@ static bool sd_wait_ready(sd_card_t *pSD, int timeout) {
 
     // Keep sending dummy clocks with DI held high until the card releases the
     // DO line
+    TRACE_BEGIN(TRACE_SD_WAIT);
     absolute_time_t timeout_time = make_timeout_time_ms(timeout);
     do {
         resp = sd_spi_write(pSD, 0xFF);
     } while (resp == 0x00 &&
              0 < absolute_time_diff_us(get_absolute_time(), timeout_time));
+    TRACE_END(TRACE_SD_WAIT);
 
     if (resp == 0x00) DBG_PRINTF("%s failed\r\n", __FUNCTION__);
 
@@ -363,9 +368,14 @@ static bool sd_wait_ready(sd_card_t *pSD, int timeout) {
     return (resp > 0x00);
 }
 
+static int sd_stream_close(sd_card_t *pSD);
+
 // An SD card can only do one thing at a time.
 static void sd_lock(sd_card_t *pSD) {
     myASSERT(mutex_is_initialized(&pSD->mutex));
+    // An open stream already holds the card on this core: end it first
+    if (pSD->stream.open && pSD->stream.core == get_core_num())
+        sd_stream_close(pSD);
     mutex_enter_blocking(&pSD->mutex);
 }
 static void sd_unlock(sd_card_t *pSD) {
@@ -890,6 +900,8 @@ static int in_sd_read_blocks(sd_card_t *pSD, uint8_t *buffer,
 
 int sd_read_blocks(sd_card_t *pSD, uint8_t *buffer, uint64_t ulSectorNumber,
                    uint32_t ulSectorCount) {
+    // The card is held for the whole of an asynchronous request
+    if (pSD->async.count) sd_write_async_wait(pSD);
     sd_acquire(pSD);
     TRACE_PRINTF("sd_read_blocks(0x%p, 0x%llx, 0x%lx)\r\n", buffer,
                  ulSectorNumber, ulSectorCount);
@@ -1014,8 +1026,124 @@ static int in_sd_write_blocks(sd_card_t *pSD, const uint8_t *buffer,
     return status;
 }
 
+/* Streaming writes
+ * ----------------
+ * An open stream keeps the card acquired (mutex, SPI and chip select) between
+ * calls, with a CMD25 in progress and 'next' being the sector it expects.
+ * sd_lock() closes it when anything else needs the card.
+ */
+
+// Send 'Stop Tran', check the card status and release the card
+static int sd_stream_close(sd_card_t *pSD) {
+    sd_stream_t *st = &pSD->stream;
+    if (!st->open) return SD_BLOCK_DEVICE_ERROR_NONE;
+    st->open = false;
+
+    sd_spi_write(pSD, SPI_STOP_TRAN);
+    uint32_t stat = 0;
+    // Some SD cards want to be deselected between every bus transaction:
+    sd_spi_deselect_pulse(pSD);
+    int status = sd_cmd(pSD, CMD13_SEND_STATUS, 0, false, &stat);
+    sd_release(pSD);
+    return status;
+}
+
+// Continue (or open) the stream with blockCnt blocks at ulSectorNumber
+static int sd_stream_write(sd_card_t *pSD, const uint8_t *buffer,
+                           uint64_t ulSectorNumber, uint32_t blockCnt) {
+    sd_stream_t *st = &pSD->stream;
+    int status;
+
+    if (st->open && st->next != ulSectorNumber) {
+        status = sd_stream_close(pSD);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != status) return status;
+    }
+    if (!st->open) {
+        if (pSD->m_Status & (STA_NOINIT | STA_NODISK))
+            return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+        uint64_t addr;
+        // SDSC Card (CCS=0) uses byte unit address
+        // SDHC and SDXC Cards (CCS=1) use block unit address (512 Bytes unit)
+        if (SDCARD_V2HC == pSD->card_type) {
+            addr = ulSectorNumber;
+        } else {
+            addr = ulSectorNumber * _block_size;
+        }
+        sd_acquire(pSD);
+        // Pre-erase the rest of the region (or just this write if unbounded)
+        uint64_t erase = st->bounded ? st->end - ulSectorNumber : blockCnt;
+        sd_cmd(pSD, ACMD23_SET_WR_BLK_ERASE_COUNT,
+               erase > 0x7FFFFF ? 0x7FFFFF : (uint32_t)erase, 1, 0);
+        // Some SD cards want to be deselected between every bus transaction:
+        sd_spi_deselect_pulse(pSD);
+        status = sd_cmd(pSD, CMD25_WRITE_MULTIPLE_BLOCK, addr, false, 0);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != status) {
+            sd_release(pSD);
+            return status;
+        }
+        st->open = true;
+        st->core = get_core_num();
+        st->next = ulSectorNumber;
+    }
+    // Write the data: one block at a time
+    do {
+        uint8_t response =
+            sd_write_block(pSD, buffer, SPI_START_BLK_MUL_WRITE, _block_size);
+        if (response != SPI_DATA_ACCEPTED) {
+            DBG_PRINTF("Stream Block Write failed: 0x%x\r\n", response);
+            sd_stream_close(pSD);
+            return SD_BLOCK_DEVICE_ERROR_WRITE;
+        }
+        buffer += _block_size;
+        st->next++;
+    } while (--blockCnt);
+
+    // The card expects no more than the pre-erased region
+    if (st->next == st->end) return sd_stream_close(pSD);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_stream_begin(sd_card_t *pSD, uint64_t ulSectorNumber, uint32_t blockCnt) {
+    sd_stream_t *st = &pSD->stream;
+    int status = sd_stream_sync(pSD);
+
+    st->bounded = blockCnt != 0;
+    if (!st->bounded) {
+        ulSectorNumber = 0;
+        blockCnt = pSD->sectors;
+    }
+    if (ulSectorNumber + blockCnt > pSD->sectors)
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    st->start = ulSectorNumber;
+    st->end = ulSectorNumber + blockCnt;
+    st->armed = true;
+    return status;
+}
+
+int sd_stream_sync(sd_card_t *pSD) {
+    if (pSD->async.count) sd_write_async_wait(pSD);
+    if (!pSD->stream.open) return SD_BLOCK_DEVICE_ERROR_NONE;
+    myASSERT(pSD->stream.core == get_core_num());
+    return sd_stream_close(pSD);
+}
+
+int sd_stream_end(sd_card_t *pSD) {
+    int status = sd_stream_sync(pSD);
+    pSD->stream.armed = false;
+    return status;
+}
+
 int sd_write_blocks(sd_card_t *pSD, const uint8_t *buffer,
                     uint64_t ulSectorNumber, uint32_t blockCnt) {
+    // The card is held for the whole of an asynchronous request
+    if (pSD->async.count) sd_write_async_wait(pSD);
+    sd_stream_t *st = &pSD->stream;
+    if (st->armed && ulSectorNumber >= st->start &&
+        ulSectorNumber + blockCnt <= st->end) {
+        TRACE_PRINTF("sd_stream_write(0x%p, 0x%llx, 0x%lx)\r\n", buffer,
+                     ulSectorNumber, blockCnt);
+        return sd_stream_write(pSD, buffer, ulSectorNumber, blockCnt);
+    }
     sd_acquire(pSD);
     TRACE_PRINTF("sd_write_blocks(0x%p, 0x%llx, 0x%lx)\r\n", buffer,
                  ulSectorNumber, blockCnt);
@@ -1024,6 +1152,218 @@ int sd_write_blocks(sd_card_t *pSD, const uint8_t *buffer,
     return status;
 }
 
+/* Asynchronous block writes
+ * --------------------------
+ * The same protocol as in_sd_write_blocks(), split into steps so that the
+ * caller is not held while a block is clocked out or while the card programs
+ * it:
+ *   DATA       block being sent by DMA (spi_transfer_start)
+ *   BUSY       data response received, card holds DO low while programming
+ *   STOP_BUSY  'Stop Tran' token sent, card busy finishing the CMD25
+ * The card (mutex and SPI) stays acquired from the command until the final
+ * CMD13, so the request must be polled from the core that submitted it.
+ */
+enum {
+    SD_ASYNC_IDLE = 0,
+    SD_ASYNC_DATA,
+    SD_ASYNC_BUSY,
+    SD_ASYNC_STOP_BUSY
+};
+
+// Start clocking out the next block of the active request
+static void sd_async_send_block(sd_card_t *pSD) {
+    sd_async_t *a = &pSD->async;
+    sd_async_request_t *req = &a->queue[a->head];
+    const uint8_t *buffer = req->buffer + a->block * _block_size;
+
+    // indicate start of block
+    sd_spi_write(pSD, req->count > 1 ? SPI_START_BLK_MUL_WRITE : SPI_START_BLOCK);
+    spi_transfer_start(pSD->spi, buffer, NULL, _block_size);
+    a->state = SD_ASYNC_DATA;
+}
+
+// Issue the write command for the active request and send its first block
+static int sd_async_begin(sd_card_t *pSD) {
+    sd_async_t *a = &pSD->async;
+    sd_async_request_t *req = &a->queue[a->head];
+
+    if (req->sector + req->count > pSD->sectors)
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    if (pSD->m_Status & (STA_NOINIT | STA_NODISK))
+        return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+
+    uint64_t addr;
+    // SDSC Card (CCS=0) uses byte unit address
+    // SDHC and SDXC Cards (CCS=1) use block unit address (512 Bytes unit)
+    if (SDCARD_V2HC == pSD->card_type) {
+        addr = req->sector;
+    } else {
+        addr = req->sector * _block_size;
+    }
+
+    sd_acquire(pSD);
+    int status;
+    if (req->count == 1) {
+        status = sd_cmd(pSD, CMD24_WRITE_BLOCK, addr, false, 0);
+    } else {
+        // Pre-erase setting prior to multiple block write operation
+        sd_cmd(pSD, ACMD23_SET_WR_BLK_ERASE_COUNT, req->count, 1, 0);
+        // Some SD cards want to be deselected between every bus transaction:
+        sd_spi_deselect_pulse(pSD);
+        status = sd_cmd(pSD, CMD25_WRITE_MULTIPLE_BLOCK, addr, false, 0);
+    }
+    if (SD_BLOCK_DEVICE_ERROR_NONE != status) {
+        sd_release(pSD);
+        return status;
+    }
+    a->block = 0;
+    a->status = SD_BLOCK_DEVICE_ERROR_NONE;
+    sd_async_send_block(pSD);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+// Remove the head request from the queue and report it
+static void sd_async_complete(sd_card_t *pSD, int status) {
+    sd_async_t *a = &pSD->async;
+    sd_async_request_t req = a->queue[a->head];
+
+    a->head = (a->head + 1) % SD_ASYNC_QUEUE_LEN;
+    a->count--;
+    a->state = SD_ASYNC_IDLE;
+    a->last_status = status;
+
+    // Start the next queued request before reporting, so the bus keeps busy
+    if (a->count) {
+        int rc = sd_async_begin(pSD);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != rc) sd_async_complete(pSD, rc);
+    }
+    if (req.done) req.done(pSD, req.buffer, status, req.context);
+}
+
+// Check the card status after the request and release the card
+static void sd_async_finish(sd_card_t *pSD) {
+    sd_async_t *a = &pSD->async;
+    uint32_t stat = 0;
+    // Some SD cards want to be deselected between every bus transaction:
+    sd_spi_deselect_pulse(pSD);
+    int status = sd_cmd(pSD, CMD13_SEND_STATUS, 0, false, &stat);
+    if (SD_BLOCK_DEVICE_ERROR_NONE == a->status) a->status = status;
+    sd_release(pSD);
+    sd_async_complete(pSD, a->status);
+}
+
+// One probe of DO; true while the card is still programming
+static bool sd_async_card_busy(sd_card_t *pSD) {
+    sd_async_t *a = &pSD->async;
+    if (sd_spi_write(pSD, SPI_FILL_CHAR) != 0x00) return false;
+    if (0 < absolute_time_diff_us(get_absolute_time(), a->deadline)) return true;
+    DBG_PRINTF("%s: card busy timeout\r\n", __FUNCTION__);
+    a->status = SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+    return false;
+}
+
+bool sd_write_async_poll(sd_card_t *pSD) {
+    sd_async_t *a = &pSD->async;
+    sd_async_request_t *req = &a->queue[a->head];
+
+    switch (a->state) {
+        case SD_ASYNC_IDLE:
+            return 0 == a->count;
+
+        case SD_ASYNC_DATA: {
+            if (!spi_transfer_is_done(pSD->spi)) return false;
+            // Consume the DMA completion notification
+            bool ret = spi_transfer_wait_complete(pSD->spi, SD_COMMAND_TIMEOUT);
+            myASSERT(ret);
+
+            uint16_t crc = (~0);
+#if SD_CRC_ENABLED
+            if (crc_on) {
+                crc = crc16((void *)(req->buffer + a->block * _block_size), _block_size);
+            }
+#endif
+            // write the checksum CRC16
+            sd_spi_write(pSD, crc >> 8);
+            sd_spi_write(pSD, crc);
+
+            // check the response token
+            uint8_t response = sd_spi_write(pSD, SPI_FILL_CHAR) & SPI_DATA_RESPONSE_MASK;
+            if (response != SPI_DATA_ACCEPTED) {
+                DBG_PRINTF("Async Block Write failed: 0x%x\r\n", response);
+                a->status = SD_BLOCK_DEVICE_ERROR_WRITE;
+            }
+            a->block++;
+            a->deadline = make_timeout_time_ms(SD_COMMAND_TIMEOUT);
+            a->state = SD_ASYNC_BUSY;
+        }
+        // fallthrough
+        case SD_ASYNC_BUSY:
+            if (sd_async_card_busy(pSD)) return false;
+            if (SD_BLOCK_DEVICE_ERROR_NONE == a->status && a->block < req->count) {
+                sd_async_send_block(pSD);
+                return false;
+            }
+            if (req->count > 1) {
+                /* In a Multiple Block write operation, the stop transmission
+                 * is done by sending 'Stop Tran' token instead of 'Start
+                 * Block' token at the beginning of the next block */
+                sd_spi_write(pSD, SPI_STOP_TRAN);
+                sd_spi_write(pSD, SPI_FILL_CHAR);  // Nbr: busy starts one byte later
+                a->deadline = make_timeout_time_ms(SD_COMMAND_TIMEOUT);
+                a->state = SD_ASYNC_STOP_BUSY;
+                return false;
+            }
+            sd_async_finish(pSD);
+            return 0 == a->count;
+
+        case SD_ASYNC_STOP_BUSY:
+            if (sd_async_card_busy(pSD)) return false;
+            sd_async_finish(pSD);
+            return 0 == a->count;
+
+        default:
+            myASSERT(false);
+            return true;
+    }
+}
+
+int sd_write_blocks_async(sd_card_t *pSD, const uint8_t *buffer,
+                          uint64_t ulSectorNumber, uint32_t blockCnt,
+                          sd_write_done_t done, void *context) {
+    sd_async_t *a = &pSD->async;
+
+    if (!buffer || !blockCnt) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    if (a->count >= SD_ASYNC_QUEUE_LEN) return SD_BLOCK_DEVICE_ERROR_WOULD_BLOCK;
+
+    sd_async_request_t *req = &a->queue[(a->head + a->count) % SD_ASYNC_QUEUE_LEN];
+    req->buffer = buffer;
+    req->sector = ulSectorNumber;
+    req->count = blockCnt;
+    req->done = done;
+    req->context = context;
+    a->count++;
+
+    TRACE_PRINTF("sd_write_blocks_async(0x%p, 0x%llx, 0x%lx)\r\n", buffer,
+                 ulSectorNumber, blockCnt);
+    if (SD_ASYNC_IDLE == a->state) {
+        int status = sd_async_begin(pSD);
+        if (SD_BLOCK_DEVICE_ERROR_NONE != status) {
+            a->count--;
+            return status;
+        }
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_write_async_wait(sd_card_t *pSD) {
+    while (!sd_write_async_poll(pSD)) tight_loop_contents();
+    return pSD->async.last_status;
+}
+
+uint32_t sd_write_async_pending(sd_card_t *pSD) {
+    return pSD->async.count;
+}
+
 static int sd_init_medium(sd_card_t *pSD) {
     int32_t status = SD_BLOCK_DEVICE_ERROR_NONE;
     uint32_t response, arg;
@@ -21,6 +21,7 @@ specific language governing permissions and limitations under the License.
 //
 #include "hardware/gpio.h"
 #include "pico/mutex.h"
+#include "pico/time.h"
 //
 #include "ff.h"
 //
@@ -32,6 +33,46 @@ extern "C" {
 
 typedef struct sd_card_t sd_card_t;
 
+// Completion callback for asynchronous block writes. Called from
+// sd_write_async_poll() once the card has programmed the data, after which
+// the buffer may be reused.
+typedef void (*sd_write_done_t)(sd_card_t *sd_card_p, const uint8_t *buffer,
+                                int status, void *context);
+
+// Double buffering: one request in flight plus one queued behind it
+#define SD_ASYNC_QUEUE_LEN 2
+
+typedef struct {
+    const uint8_t *buffer;
+    uint64_t sector;
+    uint32_t count;
+    sd_write_done_t done;
+    void *context;
+} sd_async_request_t;
+
+// State of the asynchronous write engine (see sd_write_blocks_async)
+typedef struct {
+    sd_async_request_t queue[SD_ASYNC_QUEUE_LEN];
+    uint8_t head;              // Index of the active request
+    uint8_t count;             // Requests in the queue (active included)
+    uint8_t state;             // Engine state; internal to sd_card.c
+    uint32_t block;            // Blocks of the active request already sent
+    absolute_time_t deadline;  // Timeout for the card busy period
+    int status;                // Status of the active request
+    int last_status;           // Status of the last completed request
+} sd_async_t;
+
+// Open-ended multiple block write (see sd_stream_begin)
+typedef struct {
+    bool armed;            // Sequential writes inside [start, end) are streamed
+    bool open;             // A CMD25 is in progress and the card is held
+    bool bounded;          // Region length known: ACMD23 covers all of it
+    uint8_t core;          // Core that holds the card while open
+    uint64_t start;        // First sector of the streamable region
+    uint64_t end;          // End (exclusive) of the region
+    uint64_t next;         // Sector the open CMD25 will program next
+} sd_stream_t;
+
 // "Class" representing SD Cards
 struct sd_card_t {
     const char *pcName;
@@ -64,6 +105,9 @@ struct sd_card_t {
     // Useful when use_card_detect is false - call periodically to check for presence of SD card
     // Returns true if and only if SD card was sensed on the bus
     bool (*sd_test_com)(sd_card_t *sd_card_p);
+
+    sd_async_t async;  // Asynchronous write engine state
+    sd_stream_t stream;  // Open-ended CMD25 state
 };
 
 #define SD_BLOCK_DEVICE_ERROR_NONE 0
@@ -93,6 +137,42 @@ uint64_t sd_sectors(sd_card_t *pSD);
 bool sd_init_driver();
 bool sd_card_detect(sd_card_t *sd_card_p);
 
+/* Asynchronous block writes.
+ * sd_write_blocks_async() queues a write and returns at once; the data is
+ * sent by DMA and the card's busy (programming) period is overlapped with
+ * whatever the caller does next. Up to SD_ASYNC_QUEUE_LEN requests may be
+ * outstanding, so one buffer can be filled while the other is written.
+ * Progress is made only by calling sd_write_async_poll() (or _wait()), which
+ * must be done from the core that submitted the request. Synchronous reads
+ * and writes drain pending asynchronous writes first.
+ * Returns SD_BLOCK_DEVICE_ERROR_WOULD_BLOCK if the queue is full. */
+int sd_write_blocks_async(sd_card_t *sd_card_p, const uint8_t *buffer,
+                          uint64_t ulSectorNumber, uint32_t blockCnt,
+                          sd_write_done_t done, void *context);
+// Advance the engine without blocking; true when no request is pending
+bool sd_write_async_poll(sd_card_t *sd_card_p);
+// Block until every queued request completes; returns the last status
+int sd_write_async_wait(sd_card_t *sd_card_p);
+// Number of requests still queued or in flight
+uint32_t sd_write_async_pending(sd_card_t *sd_card_p);
+
+/* Streaming writes.
+ * After sd_stream_begin(), writes that continue exactly where the previous one
+ * ended and fall inside [ulSectorNumber, ulSectorNumber + blockCnt) share a
+ * single CMD25 transaction: each call only sends its data blocks, without the
+ * command, the 'Stop Tran' token and the CMD13 of a normal write. ACMD23 is
+ * given the remaining length of the region so the card can pre-erase it.
+ * blockCnt 0 means the region extends to the end of the card (the pre-erase
+ * count is then just the length of the first write).
+ * Any other access (read, non-sequential write, sd_stream_sync()) closes the
+ * open transaction first. While a transaction is open the card is held by the
+ * core that opened it, so streaming should be used from a single core. */
+int sd_stream_begin(sd_card_t *sd_card_p, uint64_t ulSectorNumber, uint32_t blockCnt);
+// Close the open transaction, if any; streaming stays enabled (CTRL_SYNC)
+int sd_stream_sync(sd_card_t *sd_card_p);
+// Close the open transaction and disable streaming
+int sd_stream_end(sd_card_t *sd_card_p);
+
 #ifdef __cplusplus
 }
 #endif
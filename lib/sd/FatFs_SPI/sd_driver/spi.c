@@ -59,7 +59,9 @@ void set_spi_dma_irq_channel(bool useChannel1, bool shared) {
 //   If the data that will be transmitted is not important,
 //     pass NULL as tx and then the SPI_FILL_CHAR is sent out as each data
 //     element.
-bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
+//   Starts the DMA and returns immediately; the buffers must remain valid
+//   until spi_transfer_wait_complete() returns or spi_transfer_is_done() is true.
+void spi_transfer_start(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
     // assert(512 == length || 1 == length);
     assert(tx || rx);
     // assert(!(tx && rx));
@@ -110,11 +112,19 @@ bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
     // start them exactly simultaneously to avoid races (in extreme cases
     // the FIFO could overflow)
     dma_start_channel_mask((1u << spi_p->tx_dma) | (1u << spi_p->rx_dma));
+}
+
+// Non-blocking check for completion of a transfer begun by spi_transfer_start.
+// Since rx completes after tx, the rx channel alone tells when it is over.
+bool spi_transfer_is_done(spi_t *spi_p) {
+    return !dma_channel_is_busy(spi_p->rx_dma);
+}
 
+// Wait for a transfer begun by spi_transfer_start to finish
+bool spi_transfer_wait_complete(spi_t *spi_p, uint32_t timeout_ms) {
     /* Wait until master completes transfer or time out has occured. */
-    uint32_t timeOut = 1000; /* Timeout 1 sec */
     bool rc = sem_acquire_timeout_ms(
-        &spi_p->sem, timeOut);  // Wait for notification from ISR
+        &spi_p->sem, timeout_ms);  // Wait for notification from ISR
     if (!rc) {
         // If the timeout is reached the function will return false
         DBG_PRINTF("Notification wait timed out in %s\n", __FUNCTION__);
@@ -131,6 +141,11 @@ bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
     return true;
 }
 
+bool spi_transfer(spi_t *spi_p, const uint8_t *tx, uint8_t *rx, size_t length) {
+    spi_transfer_start(spi_p, tx, rx, length);
+    return spi_transfer_wait_complete(spi_p, 1000); /* Timeout 1 sec */
+}
+
 void spi_lock(spi_t *spi_p) {
     assert(mutex_is_initialized(&spi_p->mutex));
     mutex_enter_blocking(&spi_p->mutex);
@@ -60,6 +60,10 @@ extern "C" {
 #endif
   
 bool __not_in_flash_func(spi_transfer)(spi_t *pSPI, const uint8_t *tx, uint8_t *rx, size_t length);  
+// Asynchronous transfer: start the DMA, then poll or wait for completion
+void spi_transfer_start(spi_t *pSPI, const uint8_t *tx, uint8_t *rx, size_t length);
+bool spi_transfer_is_done(spi_t *pSPI);
+bool spi_transfer_wait_complete(spi_t *pSPI, uint32_t timeout_ms);
 void spi_lock(spi_t *pSPI);
 void spi_unlock(spi_t *pSPI);
 bool my_spi_init(spi_t *pSPI);
@@ -161,7 +161,8 @@ DRESULT disk_ioctl(BYTE pdrv, /* Physical drive nmuber (0..) */
             return RES_OK;
         }
         case CTRL_SYNC:
-            return RES_OK;
+            // Finish any open multiple block write (see sd_stream_begin)
+            return sdrc2dresult(sd_stream_sync(p_sd));
         default:
             return RES_PARERR;
     }
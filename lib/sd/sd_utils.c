@@ -34,6 +34,46 @@ int sd_mount(void) {
     return SD_OK;
 }
 
+int sd_file_extent(FIL *fp, uint64_t *sector, uint32_t *count) {
+    FATFS *fs = fp->obj.fs;
+    if (!fp->obj.sclust || f_size(fp) == 0) return SD_ERR_UNKNOWN;
+
+    // Mapa de fragmentos do arquivo (fast seek): uma tabela de 4 palavras
+    // só comporta um fragmento, então FR_OK significa arquivo contíguo
+    DWORD tbl[4];
+    tbl[0] = 4;
+    fp->cltbl = tbl;
+    FRESULT fr = f_lseek(fp, CREATE_LINKMAP);
+    fp->cltbl = NULL;
+    if (fr != FR_OK) return SD_ERR_UNKNOWN;
+
+    uint64_t first = fs->database + (uint64_t)(tbl[2] - 2) * fs->csize;
+    uint32_t offset = f_tell(fp) / FF_MAX_SS;
+    *sector = first + offset;
+    *count = tbl[1] * fs->csize - offset;
+    return SD_OK;
+}
+
+int sd_stream_file_begin(FIL *fp) {
+    sd_card_t *pSD = sd_get_by_num(fp->obj.fs->pdrv);
+    if (!pSD) return SD_ERR_UNKNOWN;
+
+    // Fora de uma área contígua, o fluxo vale para o cartão todo
+    uint64_t sector = 0;
+    uint32_t count = 0;
+    if (sd_file_extent(fp, &sector, &count) != SD_OK) {
+        sector = 0;
+        count = 0;
+    }
+    return sd_stream_begin(pSD, sector, count) == 0 ? SD_OK : SD_ERR_WRITE;
+}
+
+int sd_stream_file_end(FIL *fp) {
+    sd_card_t *pSD = sd_get_by_num(fp->obj.fs->pdrv);
+    if (!pSD) return SD_ERR_UNKNOWN;
+    return sd_stream_end(pSD) == 0 ? SD_OK : SD_ERR_WRITE;
+}
+
 // Implementação da função de erro
 const char* sd_strerror(int err_code) {
     static const char* errors[] = {
@@ -35,6 +35,19 @@ int sd_ls(void);
 // Exibe conteúdo de um arquivo
 int sd_cat(const char *filename);
 
+// Obtém o setor do cartão correspondente à posição atual do arquivo e quantos
+// setores contíguos há dali até o fim da área alocada. Retorna SD_ERR_UNKNOWN
+// se a área alocada não for contígua (ex.: arquivo criado sem f_expand)
+int sd_file_extent(FIL *fp, uint64_t *sector, uint32_t *count);
+
+// Ativa a escrita em fluxo (um CMD25 aberto entre chamadas) para as gravações
+// sequenciais do arquivo. Se a área alocada do arquivo for contígua, o cartão
+// pré-apaga todo o restante dela (ACMD23); senão o fluxo vale para o cartão todo
+int sd_stream_file_begin(FIL *fp);
+
+// Encerra o fluxo (STOP_TRAN) e volta às escritas normais
+int sd_stream_file_end(FIL *fp);
+
 // Função utilitária para mensagens de erro
 const char* sd_strerror(int err_code);
 
@@ -0,0 +1,252 @@
+#include "sd_wbuf.h"
+#include "sd_utils.h"
+#include "../trace/trace.h"
+#include <string.h>
+#include "pico/stdlib.h"
+
+// Atualiza as estatísticas com uma gravação de len bytes que levou elapsed us
+static void sd_wbuf_account(sd_wbuf_t *wb, uint32_t len, uint32_t elapsed) {
+    wb->busy_us += elapsed;
+    wb->writes++;
+    wb->bytes += len;
+    if (elapsed > wb->max_write_us) wb->max_write_us = elapsed;
+
+    uint32_t bucket = 0;
+    while (elapsed >> bucket && bucket < SD_WBUF_HIST_BUCKETS - 1) bucket++;
+    wb->write_hist[bucket]++;
+}
+
+// Duração abaixo da qual ficam pct% das gravações, pela resolução do histograma
+static uint32_t sd_wbuf_percentile(const sd_wbuf_t *wb, uint32_t pct) {
+    if (wb->writes == 0) return 0;
+
+    uint32_t rank = (uint32_t)(((uint64_t)wb->writes * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (uint32_t k = 0; k < SD_WBUF_HIST_BUCKETS - 1; k++) {
+        seen += wb->write_hist[k];
+        if (seen >= rank) {
+            uint32_t upper = (1u << k) - 1;
+            return upper < wb->max_write_us ? upper : wb->max_write_us;
+        }
+    }
+    return wb->max_write_us;
+}
+
+// Chama f_write medindo o tempo e atualizando as estatísticas
+static int sd_wbuf_commit(sd_wbuf_t *wb, uint32_t len) {
+    UINT bw = 0;
+    uint64_t t0 = time_us_64();
+    FRESULT fr = f_write(wb->file, wb->data + wb->base, len, &bw);
+    uint32_t elapsed = (uint32_t)(time_us_64() - t0);
+    sd_wbuf_account(wb, bw, elapsed);
+    TRACE_VALUE(TRACE_F_WRITE, elapsed);
+
+    if (fr != FR_OK || bw != len) {
+        wb->last_error = (fr != FR_OK) ? fr : FR_DENIED; // bw < len: disco cheio
+        return SD_ERR_WRITE;
+    }
+    return SD_OK;
+}
+
+// Chamado pelo driver quando o cartão termina de gravar uma metade do buffer
+static void sd_wbuf_raw_done(sd_card_t *sd, const uint8_t *buffer, int status, void *context) {
+    sd_wbuf_t *wb = context;
+    (void)sd;
+
+    wb->raw_busy &= ~(1u << ((buffer - wb->data) / (wb->capacity / 2)));
+    if (status != 0 && wb->raw_status == 0) wb->raw_status = status;
+}
+
+// Sai do modo direto: espera as gravações e devolve a posição do arquivo ao FatFs.
+// Os dados ainda não gravados vão para o início do buffer, como no modo normal
+static int sd_wbuf_raw_leave(sd_wbuf_t *wb) {
+    int status = SD_OK;
+    uint64_t t0 = time_us_64();
+
+    sd_write_async_wait(wb->raw_sd);
+    wb->busy_us += time_us_64() - t0;
+    wb->raw_sd = NULL;
+    wb->raw_busy = 0;
+    if (wb->raw_status != 0) {
+        wb->last_error = FR_DISK_ERR;
+        status = SD_ERR_WRITE;
+    }
+
+    // raw_pos é múltiplo de capacity / 2 e já está dentro do arquivo pré-alocado
+    FRESULT fr = f_lseek(wb->file, wb->raw_pos);
+    if (fr != FR_OK) {
+        wb->last_error = fr;
+        status = SD_ERR_WRITE;
+    }
+    memmove(wb->data, wb->data + wb->base, wb->fill);
+    wb->base = 0;
+    wb->limit = wb->capacity - (uint32_t)(wb->raw_pos % wb->capacity);
+    return status;
+}
+
+// Envia a metade cheia ao cartão e passa a preencher a outra
+static int sd_wbuf_raw_submit(sd_wbuf_t *wb) {
+    uint32_t half = wb->capacity / 2;
+    uint32_t count = half / SD_WBUF_SECTOR_SIZE;
+    uint64_t t0 = time_us_64();
+    int rc;
+
+    wb->raw_busy |= 1u << wb->raw_half;
+    // Fila do driver cheia: avança as gravações até abrir espaço
+    while ((rc = sd_write_blocks_async(wb->raw_sd, wb->data + wb->base, wb->raw_sector, count,
+                                       sd_wbuf_raw_done, wb)) == SD_BLOCK_DEVICE_ERROR_WOULD_BLOCK)
+        sd_write_async_poll(wb->raw_sd);
+    if (rc != SD_BLOCK_DEVICE_ERROR_NONE) {
+        wb->raw_busy &= ~(1u << wb->raw_half);
+        if (wb->raw_status == 0) wb->raw_status = rc;
+        wb->last_error = FR_DISK_ERR;
+        return SD_ERR_WRITE;
+    }
+    wb->raw_sector += count;
+    wb->raw_pos += half;
+
+    // A outra metade pode ainda estar sendo gravada
+    wb->raw_half ^= 1;
+    wb->base = wb->raw_half * half;
+    wb->fill = 0;
+    wb->limit = half;
+    TRACE_BEGIN(TRACE_RAW_WAIT);
+    while (wb->raw_busy & (1u << wb->raw_half))
+        sd_write_async_poll(wb->raw_sd);
+    TRACE_END(TRACE_RAW_WAIT);
+
+    sd_wbuf_account(wb, half, (uint32_t)(time_us_64() - t0));
+    return wb->raw_status != 0 ? SD_ERR_WRITE : SD_OK;
+}
+
+// Grava o bloco completo (fill == limit)
+static int sd_wbuf_emit(sd_wbuf_t *wb) {
+    int status = SD_OK;
+
+    if (wb->raw_sd) {
+        uint32_t count = wb->limit / SD_WBUF_SECTOR_SIZE;
+        if (wb->raw_sector + count <= wb->raw_end) return sd_wbuf_raw_submit(wb);
+
+        // Acabou a área pré-alocada: o arquivo continua crescendo pelo FatFs
+        status = sd_wbuf_raw_leave(wb);
+        if (wb->fill < wb->limit) return status;
+    }
+    if (sd_wbuf_commit(wb, wb->fill) != SD_OK) status = SD_ERR_WRITE;
+    wb->fill = 0;
+    wb->limit = wb->capacity;
+    return status;
+}
+
+int sd_wbuf_init(sd_wbuf_t *wb, FIL *file, uint8_t *storage, uint32_t capacity) {
+    if (!wb || !file || !storage) return SD_ERR_UNKNOWN;
+    if (capacity == 0 || capacity % SD_WBUF_SECTOR_SIZE != 0) return SD_ERR_UNKNOWN;
+
+    memset(wb, 0, sizeof(*wb));
+    wb->file = file;
+    wb->data = storage;
+    wb->capacity = capacity;
+    wb->last_error = FR_OK;
+
+    // O primeiro bloco termina na próxima fronteira de capacity dentro do arquivo;
+    // a partir daí todos os f_write começam alinhados
+    wb->limit = capacity - (uint32_t)(f_tell(file) % capacity);
+    wb->start_us = time_us_64();
+    return SD_OK;
+}
+
+int sd_wbuf_enable_raw(sd_wbuf_t *wb) {
+    uint32_t half = wb->capacity / 2;
+    if (wb->raw_sd || wb->fill > 0) return SD_ERR_UNKNOWN;
+    if (half == 0 || half % SD_WBUF_SECTOR_SIZE != 0) return SD_ERR_UNKNOWN;
+    if (f_tell(wb->file) % half != 0) return SD_ERR_UNKNOWN;
+
+    uint64_t sector;
+    uint32_t count;
+    if (sd_file_extent(wb->file, &sector, &count) != SD_OK) return SD_ERR_UNKNOWN;
+
+    sd_card_t *sd = sd_get_by_num(wb->file->obj.fs->pdrv);
+    if (!sd) return SD_ERR_UNKNOWN;
+
+    // O FatFs não pode ter dados pendentes do arquivo antes de escrevermos por fora
+    FRESULT fr = f_sync(wb->file);
+    if (fr != FR_OK) {
+        wb->last_error = fr;
+        return SD_ERR_WRITE;
+    }
+
+    wb->raw_sd = sd;
+    wb->raw_sector = sector;
+    wb->raw_end = sector + count;
+    wb->raw_pos = f_tell(wb->file);
+    wb->raw_half = 0;
+    wb->raw_busy = 0;
+    wb->raw_status = 0;
+    wb->base = 0;
+    wb->limit = half;
+    return SD_OK;
+}
+
+void sd_wbuf_poll(sd_wbuf_t *wb) {
+    if (wb->raw_sd && wb->raw_busy)
+        sd_write_async_poll(wb->raw_sd);
+}
+
+int sd_wbuf_write(sd_wbuf_t *wb, const void *data, uint32_t len) {
+    const uint8_t *src = data;
+    int status = SD_OK;
+
+    while (len > 0) {
+        uint32_t n = wb->limit - wb->fill;
+        if (n > len) n = len;
+
+        memcpy(wb->data + wb->base + wb->fill, src, n);
+        wb->fill += n;
+        src += n;
+        len -= n;
+
+        // Bloco completo: entrega ao FatFs (ou ao cartão) de uma vez
+        if (wb->fill == wb->limit) {
+            if (sd_wbuf_emit(wb) != SD_OK) status = SD_ERR_WRITE;
+        }
+    }
+    return status;
+}
+
+int sd_wbuf_flush(sd_wbuf_t *wb) {
+    int status = SD_OK;
+
+    // O bloco parcial do modo direto é gravado pelo FatFs, que fica com a posição certa
+    if (wb->raw_sd) status = sd_wbuf_raw_leave(wb);
+
+    if (wb->fill > 0) {
+        if (sd_wbuf_commit(wb, wb->fill) != SD_OK) status = SD_ERR_WRITE;
+        wb->limit -= wb->fill; // Mantém o alinhamento para as próximas escritas
+        wb->fill = 0;
+        if (wb->limit == 0) wb->limit = wb->capacity;
+    }
+
+    FRESULT fr = f_sync(wb->file);
+    if (fr != FR_OK) {
+        wb->last_error = fr;
+        status = SD_ERR_WRITE;
+    }
+    return status;
+}
+
+void sd_wbuf_get_stats(const sd_wbuf_t *wb, sd_wbuf_stats_t *stats) {
+    uint64_t elapsed = time_us_64() - wb->start_us;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->bytes = wb->bytes;
+    stats->writes = wb->writes;
+    stats->max_write_us = wb->max_write_us;
+    stats->p50_write_us = sd_wbuf_percentile(wb, 50);
+    stats->p90_write_us = sd_wbuf_percentile(wb, 90);
+    stats->p99_write_us = sd_wbuf_percentile(wb, 99);
+    if (elapsed > 0) {
+        stats->bytes_per_s = (uint32_t)(wb->bytes * 1000000u / elapsed);
+        stats->writes_per_s = (uint32_t)((uint64_t)wb->writes * 1000000u / elapsed);
+    }
+    if (wb->busy_us > 0)
+        stats->busy_bytes_per_s = (uint32_t)(wb->bytes * 1000000u / wb->busy_us);
+}
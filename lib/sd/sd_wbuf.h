@@ -0,0 +1,90 @@
+#ifndef SD_WBUF_H
+#define SD_WBUF_H
+
+#include <stdint.h>
+#include "ff.h"
+#include "sd_card.h"
+
+// Buffer de combinação de escritas na frente do f_write.
+// Acumula registros pequenos e só chama f_write com blocos inteiros, alinhados
+// à posição do arquivo, para que o FatFs use o caminho direto multi-setor
+// (disk_write com count > 1) em vez de ler-modificar-escrever o setor.
+//
+// Modo direto: com o arquivo pré-alocado e contíguo (f_expand), os blocos vão
+// direto aos setores do arquivo por sd_write_blocks_async, sem passar pelo
+// FatFs. O buffer é dividido em duas metades: uma é preenchida enquanto a
+// outra é gravada. O FatFs só volta a ser usado no flush.
+
+#define SD_WBUF_SECTOR_SIZE 512
+
+// Tamanho padrão do buffer: 8 setores (4 KiB). Deve ser múltiplo do setor e,
+// de preferência, divisor do tamanho do cluster para nunca cruzar clusters.
+#define SD_WBUF_DEFAULT_SIZE (8 * SD_WBUF_SECTOR_SIZE)
+
+// Histograma log2 da duração das gravações (para os percentis): o balde 0
+// conta as de 0 us e o balde k as de 2^(k-1) a 2^k - 1 us; o último, o resto
+#define SD_WBUF_HIST_BUCKETS 24
+
+typedef struct {
+    FIL *file;              // Arquivo de destino
+    uint8_t *data;          // Área do buffer
+    uint32_t capacity;      // Tamanho do buffer (múltiplo de SD_WBUF_SECTOR_SIZE)
+    uint32_t base;          // Início do bloco sendo preenchido dentro de data
+    uint32_t fill;          // Bytes acumulados
+    uint32_t limit;         // Bytes até a próxima fronteira alinhada do arquivo
+    FRESULT last_error;     // Último erro do FatFs (FR_OK se nenhum)
+
+    // Modo direto
+    sd_card_t *raw_sd;      // Cartão (NULL: escritas via f_write)
+    uint64_t raw_sector;    // Setor do cartão do bloco sendo preenchido
+    uint64_t raw_end;       // Fim (exclusivo) da área contígua do arquivo
+    FSIZE_t raw_pos;        // Posição no arquivo do bloco sendo preenchido
+    uint8_t raw_half;       // Metade sendo preenchida (0 ou 1)
+    uint8_t raw_busy;       // Um bit por metade: gravação em andamento
+    int raw_status;         // Primeiro erro das gravações assíncronas
+
+    // Estatísticas
+    uint64_t start_us;      // Instante do sd_wbuf_init
+    uint64_t busy_us;       // Tempo total gasto dentro de f_write (ou esperando o cartão)
+    uint64_t bytes;         // Bytes entregues ao f_write (ou ao cartão)
+    uint32_t writes;        // Chamadas a f_write (ou gravações diretas)
+    uint32_t max_write_us;  // Maior duração de um f_write
+    uint32_t write_hist[SD_WBUF_HIST_BUCKETS]; // Durações das gravações
+} sd_wbuf_t;
+
+typedef struct {
+    uint32_t bytes_per_s;   // Vazão média desde o init (tempo de parede)
+    uint32_t writes_per_s;  // Chamadas a f_write por segundo
+    uint32_t busy_bytes_per_s; // Vazão considerando só o tempo dentro de f_write
+    uint32_t max_write_us;  // Maior duração de um f_write
+    uint64_t bytes;         // Total de bytes gravados
+    uint32_t writes;        // Total de chamadas a f_write
+    // Percentis da duração de um f_write: limite superior do balde do
+    // histograma onde o percentil cai (nunca acima de max_write_us)
+    uint32_t p50_write_us;
+    uint32_t p90_write_us;
+    uint32_t p99_write_us;
+} sd_wbuf_stats_t;
+
+// Associa o buffer a um arquivo aberto. storage deve ter capacity bytes
+int sd_wbuf_init(sd_wbuf_t *wb, FIL *file, uint8_t *storage, uint32_t capacity);
+
+// Passa ao modo direto, se a área alocada a partir da posição atual do arquivo
+// for contígua (ex.: logo após f_expand) e a posição estiver alinhada à metade
+// do buffer. Retorna SD_ERR_UNKNOWN (e continua via f_write) caso contrário
+int sd_wbuf_enable_raw(sd_wbuf_t *wb);
+
+// Avança as gravações do modo direto sem bloquear (chamar no laço principal)
+void sd_wbuf_poll(sd_wbuf_t *wb);
+
+// Acrescenta dados ao buffer, gravando blocos completos quando necessário
+int sd_wbuf_write(sd_wbuf_t *wb, const void *data, uint32_t len);
+
+// Grava o que restou no buffer (bloco parcial) e sincroniza o arquivo.
+// No modo direto, espera as gravações pendentes e volta a usar o f_write
+int sd_wbuf_flush(sd_wbuf_t *wb);
+
+// Calcula as estatísticas de vazão
+void sd_wbuf_get_stats(const sd_wbuf_t *wb, sd_wbuf_stats_t *stats);
+
+#endif // SD_WBUF_H
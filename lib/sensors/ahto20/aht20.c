@@ -28,6 +28,17 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false;  // Falhou na calibração
 }
 
+// Converte os 6 bytes lidos (status + umidade e temperatura de 20 bits)
+static void aht20_decode(const uint8_t *buffer, AHT20_Data *data) {
+    // Processa os dados de umidade (20 bits)
+    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
+    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
+
+    // Processa os dados de temperatura (20 bits)
+    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
+    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
+}
+
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
     uint8_t buffer[6];
@@ -55,14 +66,7 @@ bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
         return false;
     }
 
-    // Processa os dados de umidade (20 bits)
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) | ((uint32_t)buffer[2] << 4) | (buffer[3] >> 4);
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;
-
-    // Processa os dados de temperatura (20 bits)
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) | ((uint32_t)buffer[4] << 8) | buffer[5];
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0;
-
+    aht20_decode(buffer, data);
     return true;
 }
 
@@ -76,4 +80,33 @@ void aht20_reset(i2c_inst_t *i2c) {
 bool aht20_check(i2c_inst_t *i2c) {
     uint8_t status;
     return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1;
-}
\ No newline at end of file
+}
+
+// Conclusão das etapas assíncronas
+static void aht20_async_done(i2c_async_xfer_t *xfer, int status) {
+    aht20_async_t *op = xfer->context;
+    bool ok = status == I2C_ASYNC_OK;
+    if (ok && op->data) {
+        if (op->buf[0] & AHT20_STATUS_BUSY) ok = false;
+        else aht20_decode(op->buf, op->data);
+    }
+    if (op->done) op->done(op, ok);
+}
+
+bool aht20_trigger_async(i2c_async_t *bus, aht20_async_t *op, aht20_done_t done, void *context) {
+    op->buf[0] = AHT20_CMD_TRIGGER;
+    op->buf[1] = 0x33;
+    op->buf[2] = 0x00;
+    op->data = NULL;
+    op->done = done;
+    op->context = context;
+    return i2c_async_write_read(bus, &op->xfer, AHT20_I2C_ADDR, op->buf, 3, NULL, 0, aht20_async_done, op);
+}
+
+bool aht20_read_async(i2c_async_t *bus, aht20_async_t *op, AHT20_Data *data,
+                      aht20_done_t done, void *context) {
+    op->data = data;
+    op->done = done;
+    op->context = context;
+    return i2c_async_write_read(bus, &op->xfer, AHT20_I2C_ADDR, NULL, 0, op->buf, 6, aht20_async_done, op);
+}
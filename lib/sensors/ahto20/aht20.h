@@ -2,6 +2,9 @@
 #define AHT20_H
 
 
+#include "hardware/i2c.h"
+#include "../../i2c_async/i2c_async.h"
+
 // Endereço I2C do AHT20
 #define AHT20_I2C_ADDR  0x38
 
@@ -27,4 +30,21 @@ void aht20_reset(i2c_inst_t *i2c);
 
 bool aht20_check(i2c_inst_t *i2c);
 
+// Leitura sem bloquear (ver lib/i2c_async), em duas etapas: aht20_trigger_async
+// inicia a medição e, ~80 ms depois, aht20_read_async busca o resultado.
+// Os callbacks são chamados na interrupção do I2C
+typedef struct aht20_async aht20_async_t;
+typedef void (*aht20_done_t)(aht20_async_t *op, bool ok);
+struct aht20_async {
+    i2c_async_xfer_t xfer;
+    uint8_t buf[6];
+    AHT20_Data *data;
+    aht20_done_t done;
+    void *context;          // Livre para o chamador
+};
+bool aht20_trigger_async(i2c_async_t *bus, aht20_async_t *op, aht20_done_t done, void *context);
+// ok é false se o sensor ainda estiver ocupado
+bool aht20_read_async(i2c_async_t *bus, aht20_async_t *op, AHT20_Data *data,
+                      aht20_done_t done, void *context);
+
 #endif // AHT20_H
\ No newline at end of file
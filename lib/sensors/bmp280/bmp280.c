@@ -30,6 +30,26 @@ void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
 
 }
 
+// Conclusão da leitura assíncrona: monta os valores de 20 bits
+static void bmp280_read_raw_done(i2c_async_xfer_t *xfer, int status) {
+    bmp280_async_t *op = xfer->context;
+    if (status == I2C_ASYNC_OK) {
+        *op->pressure = (op->buf[0] << 12) | (op->buf[1] << 4) | (op->buf[2] >> 4);
+        *op->temp = (op->buf[3] << 12) | (op->buf[4] << 4) | (op->buf[5] >> 4);
+    }
+    if (op->done) op->done(op, status == I2C_ASYNC_OK);
+}
+
+bool bmp280_read_raw_async(i2c_async_t *bus, bmp280_async_t *op, int32_t *temp, int32_t *pressure,
+                           bmp280_done_t done, void *context) {
+    op->reg = REG_PRESSURE_MSB;
+    op->temp = temp;
+    op->pressure = pressure;
+    op->done = done;
+    op->context = context;
+    return i2c_async_write_read(bus, &op->xfer, ADDR, &op->reg, 1, op->buf, 6, bmp280_read_raw_done, op);
+}
+
 void bmp280_reset(i2c_inst_t *i2c) {
     uint8_t buf[2] = { REG_RESET, 0xB6 };
     i2c_write_blocking(i2c, ADDR, buf, 2, false);
@@ -2,6 +2,7 @@
 #define BMP280_H
 
 #include "hardware/i2c.h"
+#include "../../i2c_async/i2c_async.h"
 
 // Defina os endereços e registros conforme o código original
 #define ADDR _u(0x76)
@@ -69,4 +70,19 @@ int32_t bmp280_convert_temp(int32_t temp, struct bmp280_calib_param* params);
 int32_t bmp280_convert_pressure(int32_t pressure, int32_t temp, struct bmp280_calib_param* params);
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params);
 
+// Leitura crua sem bloquear (ver lib/i2c_async). O callback é chamado na
+// interrupção do I2C, com temp e pressure já preenchidos
+typedef struct bmp280_async bmp280_async_t;
+typedef void (*bmp280_done_t)(bmp280_async_t *op, bool ok);
+struct bmp280_async {
+    i2c_async_xfer_t xfer;
+    uint8_t reg;
+    uint8_t buf[6];
+    int32_t *temp, *pressure;
+    bmp280_done_t done;
+    void *context;          // Livre para o chamador
+};
+bool bmp280_read_raw_async(i2c_async_t *bus, bmp280_async_t *op, int32_t *temp, int32_t *pressure,
+                           bmp280_done_t done, void *context);
+
 #endif
\ No newline at end of file
@@ -1,6 +1,34 @@
 #include "mpu6050.h"
 #include "pico/stdlib.h"
 
+// Registradores
+#define REG_SMPLRT_DIV 0x19
+#define REG_CONFIG     0x1A
+#define REG_FIFO_EN    0x23
+#define REG_INT_STATUS 0x3A
+#define REG_ACCEL_XOUT_H 0x3B // Início de accel, temp e gyro (14 bytes)
+#define REG_USER_CTRL  0x6A
+#define REG_FIFO_COUNT 0x72
+#define REG_FIFO_R_W   0x74
+
+// Bits
+#define FIFO_EN_TEMP_GYRO_ACCEL 0xF8 // TEMP, XG, YG, ZG e ACCEL
+#define USER_CTRL_FIFO_EN       0x40
+#define USER_CTRL_FIFO_RESET    0x04
+#define INT_STATUS_FIFO_OFLOW   0x10
+
+// Escreve um registrador
+static bool mpu6050_write_reg(i2c_inst_t *i2c_port, uint8_t reg, uint8_t value) {
+    uint8_t buf[] = {reg, value};
+    return i2c_write_blocking(i2c_port, MPU6050_ADDR, buf, 2, false) == 2;
+}
+
+// Lê len bytes a partir de reg (o MPU6050 incrementa o endereço, exceto na FIFO)
+static bool mpu6050_read_regs(i2c_inst_t *i2c_port, uint8_t reg, uint8_t *buffer, size_t len) {
+    if (i2c_write_blocking(i2c_port, MPU6050_ADDR, &reg, 1, true) != 1) return false;
+    return i2c_read_blocking(i2c_port, MPU6050_ADDR, buffer, len, false) == (int)len;
+}
+
 // Função para resetar e inicializar o MPU6050
 void mpu6050_init(i2c_inst_t *i2c_port) {
     // Dois bytes para reset: primeiro o registrador, segundo o dado
@@ -14,28 +42,109 @@ void mpu6050_init(i2c_inst_t *i2c_port) {
     sleep_ms(10); // Aguarda estabilização após acordar
 }
 
+// Converte registros de 14 bytes lidos do sensor (big-endian) no próprio lugar
+static void mpu6050_decode(mpu6050_raw_t *raw, uint32_t count) {
+    uint8_t *bytes = (uint8_t *)raw;
+    for (uint32_t i = 0; i < count * sizeof(mpu6050_raw_t); i += 2) {
+        uint8_t hi = bytes[i];
+        bytes[i] = bytes[i + 1];
+        bytes[i + 1] = hi;
+    }
+}
+
+// Lê acelerômetro, temperatura e giroscópio (0x3B - 0x48) numa única transação
+bool mpu6050_read_burst(i2c_inst_t *i2c_port, mpu6050_raw_t *raw) {
+    if (!mpu6050_read_regs(i2c_port, REG_ACCEL_XOUT_H, (uint8_t *)raw, sizeof(*raw)))
+        return false;
+    mpu6050_decode(raw, 1);
+    return true;
+}
+
 // Função para ler dados crus do acelerômetro, giroscópio e temperatura
-void mpu6050_read_raw(i2c_inst_t *i2c_port, int16_t accel[3], int16_t gyro[3], int16_t *temp) {
-    uint8_t reg;
-    uint8_t buffer[6];
-
-    // Acelerômetro (0x3B - 0x40)
-    reg = 0x3B;
-    i2c_write_blocking(i2c_port, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c_port, MPU6050_ADDR, buffer, 6, false);
-    for (int i = 0; i < 3; i++)
-        accel[i] = (buffer[i * 2] << 8) | buffer[i * 2 + 1];
-
-    // Giroscópio (0x43 - 0x48)
-    reg = 0x43;
-    i2c_write_blocking(i2c_port, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c_port, MPU6050_ADDR, buffer, 6, false);
-    for (int i = 0; i < 3; i++)
-        gyro[i] = (buffer[i * 2] << 8) | buffer[i * 2 + 1];
-
-    // Temperatura (0x41 - 0x42)
-    reg = 0x41;
-    i2c_write_blocking(i2c_port, MPU6050_ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c_port, MPU6050_ADDR, buffer, 2, false);
-    *temp = (buffer[0] << 8) | buffer[1];
+bool mpu6050_read_raw(i2c_inst_t *i2c_port, int16_t accel[3], int16_t gyro[3], int16_t *temp) {
+    mpu6050_raw_t raw;
+    bool ok = mpu6050_read_burst(i2c_port, &raw);
+    if (!ok) raw = (mpu6050_raw_t){0}; // Não repassa uma leitura pela metade
+    for (int i = 0; i < 3; i++) {
+        accel[i] = raw.accel[i];
+        gyro[i] = raw.gyro[i];
+    }
+    *temp = raw.temp;
+    return ok;
+}
+
+uint32_t mpu6050_fifo_enable(i2c_inst_t *i2c_port, uint32_t rate_hz, mpu6050_dlpf_t dlpf) {
+    // Com o filtro ligado o giroscópio amostra a 1 kHz; sem ele, a 8 kHz
+    uint32_t base_hz = (dlpf == MPU6050_DLPF_260HZ) ? 8000 : 1000;
+    if (rate_hz == 0) rate_hz = 1;
+    if (rate_hz > base_hz) rate_hz = base_hz;
+    uint32_t div = base_hz / rate_hz - 1;
+    if (div > 255) div = 255;
+
+    mpu6050_write_reg(i2c_port, REG_USER_CTRL, 0x00); // Para a FIFO durante a configuração
+    if (!mpu6050_write_reg(i2c_port, REG_SMPLRT_DIV, (uint8_t)div) ||
+        !mpu6050_write_reg(i2c_port, REG_CONFIG, (uint8_t)dlpf) ||
+        !mpu6050_write_reg(i2c_port, REG_FIFO_EN, FIFO_EN_TEMP_GYRO_ACCEL))
+        return 0;
+
+    mpu6050_fifo_reset(i2c_port);
+    return base_hz / (div + 1);
+}
+
+void mpu6050_fifo_disable(i2c_inst_t *i2c_port) {
+    mpu6050_write_reg(i2c_port, REG_FIFO_EN, 0x00);
+    mpu6050_write_reg(i2c_port, REG_USER_CTRL, USER_CTRL_FIFO_RESET);
+}
+
+void mpu6050_fifo_reset(i2c_inst_t *i2c_port) {
+    uint8_t status;
+    mpu6050_write_reg(i2c_port, REG_USER_CTRL, USER_CTRL_FIFO_RESET);
+    mpu6050_read_regs(i2c_port, REG_INT_STATUS, &status, 1); // Limpa o aviso de transbordo
+    mpu6050_write_reg(i2c_port, REG_USER_CTRL, USER_CTRL_FIFO_EN);
+}
+
+int mpu6050_fifo_count(i2c_inst_t *i2c_port) {
+    uint8_t buffer[2];
+    if (!mpu6050_read_regs(i2c_port, REG_FIFO_COUNT, buffer, 2)) return MPU6050_FIFO_ERR_BUS;
+    return (buffer[0] << 8) | buffer[1];
+}
+
+int mpu6050_fifo_read(i2c_inst_t *i2c_port, mpu6050_raw_t *records, uint32_t max) {
+    // Transbordo: os registros mais antigos foram sobrescritos byte a byte e a
+    // FIFO perdeu o alinhamento, então só resta descartá-la
+    uint8_t status;
+    if (!mpu6050_read_regs(i2c_port, REG_INT_STATUS, &status, 1)) return MPU6050_FIFO_ERR_BUS;
+    if (status & INT_STATUS_FIFO_OFLOW) {
+        mpu6050_fifo_reset(i2c_port);
+        return MPU6050_FIFO_ERR_OVERFLOW;
+    }
+
+    int count = mpu6050_fifo_count(i2c_port);
+    if (count < 0) return count;
+    uint32_t n = (uint32_t)count / MPU6050_FIFO_RECORD_SIZE;
+    if (n > max) n = max;
+    if (n == 0) return 0;
+
+    // Rajada única direto na área de saída (a struct tem exatamente 14 bytes)
+    if (!mpu6050_read_regs(i2c_port, REG_FIFO_R_W, (uint8_t *)records, n * MPU6050_FIFO_RECORD_SIZE))
+        return MPU6050_FIFO_ERR_BUS;
+    mpu6050_decode(records, n);
+    return (int)n;
+}
+
+// Conclusão da leitura assíncrona: converte e repassa ao chamador
+static void mpu6050_burst_done(i2c_async_xfer_t *xfer, int status) {
+    mpu6050_async_t *op = xfer->context;
+    if (status == I2C_ASYNC_OK) mpu6050_decode(op->raw, 1);
+    if (op->done) op->done(op, status == I2C_ASYNC_OK);
+}
+
+bool mpu6050_read_burst_async(i2c_async_t *bus, mpu6050_async_t *op, mpu6050_raw_t *raw,
+                              mpu6050_done_t done, void *context) {
+    op->reg = REG_ACCEL_XOUT_H;
+    op->raw = raw;
+    op->done = done;
+    op->context = context;
+    return i2c_async_write_read(bus, &op->xfer, MPU6050_ADDR, &op->reg, 1,
+                                (uint8_t *)raw, sizeof(*raw), mpu6050_burst_done, op);
 }
@@ -2,13 +2,84 @@
 #define MPU6050_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "hardware/i2c.h"
+#include "../../i2c_async/i2c_async.h"
 
 // Endereço padrão do MPU6050
 #define MPU6050_ADDR 0x68
 
+// FIFO interna: 1024 bytes, cada registro tem 14 bytes (accel, temp, gyro)
+#define MPU6050_FIFO_SIZE 1024
+#define MPU6050_FIFO_RECORD_SIZE 14
+#define MPU6050_FIFO_MAX_RECORDS (MPU6050_FIFO_SIZE / MPU6050_FIFO_RECORD_SIZE)
+
+// Retornos de erro de mpu6050_fifo_read
+#define MPU6050_FIFO_ERR_BUS      -1 // Falha no I2C
+#define MPU6050_FIFO_ERR_OVERFLOW -2 // FIFO transbordou (foi esvaziada; amostras perdidas)
+
+// Frequência de corte do filtro passa-baixa digital (registrador CONFIG)
+typedef enum {
+    MPU6050_DLPF_260HZ = 0, // Sem filtro: o giroscópio amostra a 8 kHz
+    MPU6050_DLPF_184HZ,
+    MPU6050_DLPF_94HZ,
+    MPU6050_DLPF_44HZ,
+    MPU6050_DLPF_21HZ,
+    MPU6050_DLPF_10HZ,
+    MPU6050_DLPF_5HZ
+} mpu6050_dlpf_t;
+
+// Leitura crua na ordem dos registradores 0x3B-0x48 (mesma ordem da FIFO),
+// 14 bytes sem preenchimento para receber os dados do barramento diretamente
+typedef struct __attribute__((packed)) {
+    int16_t accel[3];      // Aceleração (X, Y, Z)
+    int16_t temp;          // Temperatura
+    int16_t gyro[3];       // Giroscópio (X, Y, Z)
+} mpu6050_raw_t;
+
 // Funções da biblioteca
 void mpu6050_init(i2c_inst_t *i2c_port);
-void mpu6050_read_raw(i2c_inst_t *i2c_port, int16_t accel[3], int16_t gyro[3], int16_t *temp);
+// Lê accel, gyro e temperatura. Em caso de falha no barramento zera as
+// saídas e retorna false
+bool mpu6050_read_raw(i2c_inst_t *i2c_port, int16_t accel[3], int16_t gyro[3], int16_t *temp);
+
+// Lê os 14 bytes de accel, temp e gyro numa única transação I2C (leituras do
+// mesmo instante). Retorna false em caso de falha no barramento
+bool mpu6050_read_burst(i2c_inst_t *i2c_port, mpu6050_raw_t *raw);
+
+// Modo FIFO: o próprio sensor amostra a rate_hz (1000 / (1 + SMPLRT_DIV), com o
+// filtro ligado) e guarda accel, temp e gyro na FIFO, que é esvaziada em rajadas.
+// Retorna a taxa efetivamente configurada (em Hz), ou 0 em caso de erro
+uint32_t mpu6050_fifo_enable(i2c_inst_t *i2c_port, uint32_t rate_hz, mpu6050_dlpf_t dlpf);
+
+// Desliga a FIFO (volta ao modo de leitura direta dos registradores)
+void mpu6050_fifo_disable(i2c_inst_t *i2c_port);
+
+// Descarta o conteúdo da FIFO
+void mpu6050_fifo_reset(i2c_inst_t *i2c_port);
+
+// Bytes na FIFO, ou MPU6050_FIFO_ERR_BUS
+int mpu6050_fifo_count(i2c_inst_t *i2c_port);
+
+// Lê até max registros completos em uma única rajada. Retorna quantos foram lidos,
+// ou um MPU6050_FIFO_ERR_*. Em caso de transbordo a FIFO é esvaziada
+int mpu6050_fifo_read(i2c_inst_t *i2c_port, mpu6050_raw_t *records, uint32_t max);
+
+// Leitura em rajada sem bloquear (ver lib/i2c_async). O callback é chamado na
+// interrupção do I2C, com raw já convertido
+typedef struct mpu6050_async mpu6050_async_t;
+typedef void (*mpu6050_done_t)(mpu6050_async_t *op, bool ok);
+struct mpu6050_async {
+    i2c_async_xfer_t xfer;
+    uint8_t reg;
+    mpu6050_raw_t *raw;
+    mpu6050_done_t done;
+    void *context;          // Livre para o chamador
+};
+
+// Enfileira a leitura dos 14 bytes. op e raw devem existir até o callback.
+// Retorna false se a fila do barramento estiver cheia
+bool mpu6050_read_burst_async(i2c_async_t *bus, mpu6050_async_t *op, mpu6050_raw_t *raw,
+                              mpu6050_done_t done, void *context);
 
 #endif
@@ -0,0 +1,226 @@
+#include "spectrum.h"
+#include <stdio.h>
+#include <string.h>
+#include "../livestats/livestats.h"
+
+#if SPECTRUM_LOG2_N != 8
+#error "spectrum_sin_q15 tem a tabela de um quarto de onda para N = 256"
+#endif
+
+// Maior valor de entrada da FFT: com a escala de 1/2 por estágio o módulo
+// nunca cresce, e a folga de um bit cobre os arredondamentos
+#define SPECTRUM_INPUT_MAX 16383
+
+// Faixas: bins de cada uma (o bin 0, da média, fica de fora)
+#define SPECTRUM_BAND_BINS (SPECTRUM_N / 2 / SPECTRUM_BANDS)
+
+// sin(2 * pi * k / 256) em Q15, k = 0..64
+static const int16_t spectrum_quarter_sin[SPECTRUM_N / 4 + 1] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+// sin(2 * pi * k / N) em Q15, para qualquer k (módulo N)
+static int32_t spectrum_sin_q15(uint32_t k) {
+    const uint32_t q = SPECTRUM_N / 4;
+    k &= SPECTRUM_N - 1;
+    if (k <= q) return spectrum_quarter_sin[k];
+    if (k <= 2 * q) return spectrum_quarter_sin[2 * q - k];
+    if (k <= 3 * q) return -spectrum_quarter_sin[k - 2 * q];
+    return -spectrum_quarter_sin[SPECTRUM_N - k];
+}
+
+static int32_t spectrum_cos_q15(uint32_t k) {
+    return spectrum_sin_q15(k + SPECTRUM_N / 4);
+}
+
+// Janela de Hann em Q15: (1 - cos(2 * pi * n / N)) / 2
+static int32_t spectrum_hann_q15(uint32_t n) {
+    return (32767 - spectrum_cos_q15(n) + 1) >> 1;
+}
+
+void spectrum_fft_q15(int16_t *re, int16_t *im) {
+    // Reordena as entradas pelo índice com os bits invertidos
+    for (uint32_t i = 1, j = 0; i < SPECTRUM_N; i++) {
+        uint32_t bit = SPECTRUM_N >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            int16_t t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    // Borboletas (decimação no tempo), dividindo por 2 a cada estágio
+    for (uint32_t len = 2; len <= SPECTRUM_N; len <<= 1) {
+        uint32_t half = len >> 1;
+        uint32_t step = SPECTRUM_N / len;
+        for (uint32_t k = 0; k < half; k++) {
+            int32_t wr = spectrum_cos_q15(k * step);
+            int32_t wi = -spectrum_sin_q15(k * step);
+            for (uint32_t i = k; i < SPECTRUM_N; i += len) {
+                uint32_t j = i + half;
+                int32_t tr = (wr * re[j] - wi * im[j] + (1 << 14)) >> 15;
+                int32_t ti = (wr * im[j] + wi * re[j] + (1 << 14)) >> 15;
+                int32_t ar = re[i], ai = im[i];
+                re[j] = (int16_t)((ar - tr) >> 1);
+                im[j] = (int16_t)((ai - ti) >> 1);
+                re[i] = (int16_t)((ar + tr) >> 1);
+                im[i] = (int16_t)((ai + ti) >> 1);
+            }
+        }
+    }
+}
+
+void spectrum_init(spectrum_t *sp, uint32_t rate_hz) {
+    memset(sp, 0, sizeof(*sp));
+    sp->rate_hz = rate_hz;
+}
+
+bool spectrum_add(spectrum_t *sp, const sample_t *sample) {
+    if (sp->fill == 0) sp->block_start_us = sample->timestamp_us;
+    for (int a = 0; a < 3; a++) sp->block[a][sp->fill] = sample->accel[a];
+    if (++sp->fill < SPECTRUM_N) return false;
+    sp->fill = 0;
+    sp->blocks++;
+    return true;
+}
+
+// LSB do acelerômetro (±2 g) multiplicados por 2^exp para micro-g:
+// 1e6 / 16384 = 15625 / 256
+static uint32_t spectrum_to_ug(uint64_t value, int exp) {
+    uint64_t ug = value * 15625u;
+    int shift = 8 + exp;
+    if (shift <= 0) return (uint32_t)(ug << -shift);
+    return (uint32_t)((ug + (1ull << (shift - 1))) >> shift);
+}
+
+void spectrum_analyze(spectrum_t *sp, const int16_t *x, spectrum_result_t *out) {
+    uint32_t power[SPECTRUM_N / 2 + 1];
+    int32_t sum = 0, peak = 0;
+
+    memset(out, 0, sizeof(*out));
+
+    // Remove a média e aplica a janela, procurando o maior valor
+    for (uint32_t n = 0; n < SPECTRUM_N; n++) sum += x[n];
+    int32_t mean = (sum >= 0 ? sum + SPECTRUM_N / 2 : sum - SPECTRUM_N / 2) / SPECTRUM_N;
+    for (uint32_t n = 0; n < SPECTRUM_N; n++) {
+        int32_t v = ((x[n] - mean) * spectrum_hann_q15(n)) >> 15;
+        if (v < 0) v = -v;
+        if (v > peak) peak = v;
+    }
+    if (peak == 0) return;
+
+    // Ponto flutuante por bloco: a entrada usa a faixa toda da FFT. Os
+    // resultados valem (valor na FFT) / 2^exp
+    int exp = 0;
+    while (peak > SPECTRUM_INPUT_MAX) {
+        peak >>= 1;
+        exp--;
+    }
+    while ((peak << 1) <= SPECTRUM_INPUT_MAX) {
+        peak <<= 1;
+        exp++;
+    }
+    for (uint32_t n = 0; n < SPECTRUM_N; n++) {
+        int32_t v = ((x[n] - mean) * spectrum_hann_q15(n)) >> 15;
+        sp->re[n] = (int16_t)(exp >= 0 ? v << exp : v >> -exp);
+        sp->im[n] = 0;
+    }
+
+    spectrum_fft_q15(sp->re, sp->im);
+    for (uint32_t k = 0; k <= SPECTRUM_N / 2; k++)
+        power[k] = (uint32_t)((int32_t)sp->re[k] * sp->re[k] + (int32_t)sp->im[k] * sp->im[k]);
+
+    // RMS das faixas (Parseval): dois lados do espectro e a perda de energia
+    // da janela de Hann (média de w² = 3/8) dão o fator 2 * 8/3 = 16/3
+    for (uint32_t b = 0; b < SPECTRUM_BANDS; b++) {
+        uint64_t energy = 0;
+        for (uint32_t k = b * SPECTRUM_BAND_BINS; k < (b + 1) * SPECTRUM_BAND_BINS; k++)
+            if (k > 0) energy += power[k];
+        out->band_rms_ug[b] = spectrum_to_ug(livestats_isqrt64(energy * 16 / 3), exp);
+    }
+
+    // Picos: máximos locais com maior potência, do maior para o menor
+    uint32_t peak_bin[SPECTRUM_PEAKS] = {0};
+    for (uint32_t k = 1; k < SPECTRUM_N / 2; k++) {
+        if (power[k] <= power[k - 1] || power[k] < power[k + 1]) continue;
+        for (int i = 0; i < SPECTRUM_PEAKS; i++) {
+            if (peak_bin[i] == 0 || power[k] > power[peak_bin[i]]) {
+                memmove(&peak_bin[i + 1], &peak_bin[i], (SPECTRUM_PEAKS - 1 - i) * sizeof(peak_bin[0]));
+                peak_bin[i] = k;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < SPECTRUM_PEAKS && peak_bin[i]; i++) {
+        uint32_t k = peak_bin[i];
+        int32_t m0 = (int32_t)livestats_isqrt64(power[k - 1]);
+        int32_t m1 = (int32_t)livestats_isqrt64(power[k]);
+        int32_t m2 = (int32_t)livestats_isqrt64(power[k + 1]);
+
+        // Deslocamento do pico entre bins para a janela de Hann (Q8):
+        // d = 2 * (m2 - m0) / (m0 + 2 * m1 + m2)
+        int32_t d_q8 = 512 * (m2 - m0) / (m0 + 2 * m1 + m2);
+        out->peaks[i].freq_chz = (uint32_t)(((int64_t)(k << 8) + d_q8) * sp->rate_hz * 100 / (SPECTRUM_N << 8));
+
+        // A senoide espalha a energia pelos bins vizinhos: soma os três
+        // (fator 16/3 como nas faixas) e a amplitude é o RMS vezes raiz de 2
+        uint64_t energy = (uint64_t)power[k - 1] + power[k] + power[k + 1];
+        out->peaks[i].amp_ug = spectrum_to_ug(livestats_isqrt64(energy * 32 / 3), exp);
+    }
+}
+
+// Valor em centésimos como "inteiro.cc"
+static int spectrum_centi(char *buffer, size_t size, uint32_t centi) {
+    return snprintf(buffer, size, ",%lu.%02lu", (unsigned long)(centi / 100), (unsigned long)(centi % 100));
+}
+
+int spectrum_format_header(const spectrum_t *sp, char *buffer, size_t size) {
+    uint32_t band_chz = sp->rate_hz * 100 * SPECTRUM_BAND_BINS / SPECTRUM_N;
+    int n = snprintf(buffer, size,
+                     "# fs=%lu Hz, N=%d, janela de Hann, %d faixas de %lu.%02lu Hz, amplitudes e RMS em mg\n"
+                     "bloco,t_s,eixo",
+                     (unsigned long)sp->rate_hz, SPECTRUM_N, SPECTRUM_BANDS,
+                     (unsigned long)(band_chz / 100), (unsigned long)(band_chz % 100));
+    for (int i = 1; i <= SPECTRUM_PEAKS; i++)
+        n += snprintf(buffer + n, size - n, ",f%d_hz,a%d_mg", i, i);
+    for (int b = 0; b < SPECTRUM_BANDS; b++)
+        n += snprintf(buffer + n, size - n, ",rms_b%d_mg", b);
+    n += snprintf(buffer + n, size - n, "\n");
+    return n;
+}
+
+int spectrum_format(spectrum_t *sp, uint64_t t0_us, char *buffer, size_t size) {
+    static const char axis_names[3] = {'x', 'y', 'z'};
+    uint64_t t_ms = (sp->block_start_us - t0_us) / 1000;
+    spectrum_result_t r;
+    int n = 0;
+
+    for (int a = 0; a < 3; a++) {
+        spectrum_analyze(sp, sp->block[a], &r);
+        n += snprintf(buffer + n, size - n, "%lu,%llu.%03llu,%c",
+                      (unsigned long)(sp->blocks - 1), (unsigned long long)(t_ms / 1000),
+                      (unsigned long long)(t_ms % 1000), axis_names[a]);
+        for (int i = 0; i < SPECTRUM_PEAKS; i++) {
+            n += spectrum_centi(buffer + n, size - n, r.peaks[i].freq_chz);
+            n += spectrum_centi(buffer + n, size - n, (r.peaks[i].amp_ug + 5) / 10);
+        }
+        for (int b = 0; b < SPECTRUM_BANDS; b++)
+            n += spectrum_centi(buffer + n, size - n, (r.band_rms_ug[b] + 5) / 10);
+        n += snprintf(buffer + n, size - n, "\n");
+    }
+    return n;
+}
@@ -0,0 +1,65 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sampler/sampler.h"
+
+// Espectro da aceleração por blocos, só com inteiros (Q15, sem FPU).
+// A cada SPECTRUM_N amostras, cada eixo tem a média removida, passa pela
+// janela de Hann e por uma FFT radix-2 em ponto fixo (escala 1/2 por estágio
+// e ponto flutuante por bloco na entrada). Do espectro saem os SPECTRUM_PEAKS
+// maiores picos (frequência interpolada e amplitude) e o RMS de
+// SPECTRUM_BANDS faixas iguais de 0 a fs/2: uma linha por eixo por bloco no
+// arquivo datalogN.fft, em vez das SPECTRUM_N linhas do CSV.
+
+#define SPECTRUM_LOG2_N 8
+#define SPECTRUM_N (1 << SPECTRUM_LOG2_N) // Amostras por bloco
+#define SPECTRUM_PEAKS 3
+#define SPECTRUM_BANDS 8                   // Divide N / 2 (faixas de mesma largura)
+
+// Tamanho suficiente para as linhas de um bloco (três eixos) ou o cabeçalho
+#define SPECTRUM_TEXT_MAX 512
+
+typedef struct {
+    uint32_t freq_chz; // Frequência em centésimos de Hz (0: sem pico)
+    uint32_t amp_ug;   // Amplitude da senoide em micro-g
+} spectrum_peak_t;
+
+typedef struct {
+    spectrum_peak_t peaks[SPECTRUM_PEAKS];  // Do maior para o menor
+    uint32_t band_rms_ug[SPECTRUM_BANDS];   // RMS de cada faixa em micro-g
+} spectrum_result_t;
+
+typedef struct {
+    int16_t block[3][SPECTRUM_N]; // Acelerações do bloco em formação
+    int16_t re[SPECTRUM_N];       // Área de trabalho da FFT
+    int16_t im[SPECTRUM_N];
+    uint32_t fill;                // Amostras no bloco em formação
+    uint32_t rate_hz;
+    uint32_t blocks;              // Blocos completos desde o init
+    uint64_t block_start_us;      // Carimbo da primeira amostra do bloco
+} spectrum_t;
+
+// FFT complexa no lugar, com saída escalada por 1/SPECTRUM_N (DFT / N)
+void spectrum_fft_q15(int16_t *re, int16_t *im);
+
+// Zera o acumulador para uma gravação na taxa rate_hz
+void spectrum_init(spectrum_t *sp, uint32_t rate_hz);
+
+// Acrescenta uma amostra. Retorna true quando o bloco fica completo
+// (chamar spectrum_format antes da próxima amostra)
+bool spectrum_add(spectrum_t *sp, const sample_t *sample);
+
+// Analisa um eixo do bloco completo (x em LSB do acelerômetro, ±2 g)
+void spectrum_analyze(spectrum_t *sp, const int16_t *x, spectrum_result_t *out);
+
+// Linha de cabeçalho do arquivo (parâmetros e nomes das colunas)
+int spectrum_format_header(const spectrum_t *sp, char *buffer, size_t size);
+
+// Analisa o bloco completo e monta uma linha CSV por eixo. t0_us: início da
+// gravação (a coluna de tempo é relativa a ele). Retorna o tamanho
+int spectrum_format(spectrum_t *sp, uint64_t t0_us, char *buffer, size_t size);
+
+#endif // SPECTRUM_H
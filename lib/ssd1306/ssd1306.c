@@ -1,5 +1,7 @@
 #include "ssd1306.h"
 #include "font.h"
+#include "../trace/trace.h"
+#include <string.h>
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -7,10 +9,90 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  // Uma nova inicialização (display.c inicializa duas vezes) reaproveita os
+  // buffers; só um tamanho diferente os aloca de novo
+  size_t bufsize = ssd->pages * ssd->width + 1;
+  if (ssd->ram_buffer == NULL || ssd->bufsize != bufsize) {
+    free(ssd->ram_buffer);
+    free(ssd->shadow);
+    free(ssd->tx_buffer);
+    ssd->bufsize = bufsize;
+    ssd->ram_buffer = calloc(bufsize, sizeof(uint8_t));
+    ssd->shadow = calloc(bufsize - 1, sizeof(uint8_t));
+    ssd->tx_buffer = calloc(bufsize, sizeof(uint8_t));
+  } else {
+    memset(ssd->ram_buffer, 0, bufsize);
+  }
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->bus = NULL;
+  ssd1306_invalidate(ssd);
+}
+
+// Marca colunas x0..x1 e páginas p0..p1 como escritas
+static inline void ssd1306_mark(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+  if (!ssd->dirty) {
+    ssd->dirty = true;
+    ssd->dirty_x0 = x0;
+    ssd->dirty_x1 = x1;
+    ssd->dirty_p0 = p0;
+    ssd->dirty_p1 = p1;
+    return;
+  }
+  if (x0 < ssd->dirty_x0) ssd->dirty_x0 = x0;
+  if (x1 > ssd->dirty_x1) ssd->dirty_x1 = x1;
+  if (p0 < ssd->dirty_p0) ssd->dirty_p0 = p0;
+  if (p1 > ssd->dirty_p1) ssd->dirty_p1 = p1;
+}
+
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  ssd->shadow_valid = false;
+  ssd1306_mark(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
+
+// Reduz a região escrita à janela que de fato difere da tela e copia essa
+// janela (coluna a coluna, como no endereçamento vertical) para tx_buffer.
+// Retorna quantos bytes de dados há para enviar (0: nada mudou)
+static size_t ssd1306_prepare(ssd1306_t *ssd, uint8_t win[4]) {
+  if (!ssd->dirty) return 0;
+  ssd->dirty = false;
+
+  const uint8_t *ram = ssd->ram_buffer + 1;
+  uint8_t x0 = ssd->dirty_x0, x1 = ssd->dirty_x1;
+  uint8_t p0 = ssd->dirty_p0, p1 = ssd->dirty_p1;
+
+  if (ssd->shadow_valid) {
+    uint8_t cx0 = 0xFF, cx1 = 0, cp0 = 0xFF, cp1 = 0;
+    for (uint8_t x = x0; x <= x1; ++x) {
+      const uint8_t *col = ram + x * ssd->pages;
+      const uint8_t *old = ssd->shadow + x * ssd->pages;
+      for (uint8_t p = p0; p <= p1; ++p) {
+        if (col[p] != old[p]) {
+          if (cx0 == 0xFF) cx0 = x;
+          cx1 = x;
+          if (p < cp0) cp0 = p;
+          if (p > cp1) cp1 = p;
+        }
+      }
+    }
+    if (cx0 == 0xFF) return 0;
+    x0 = cx0; x1 = cx1; p0 = cp0; p1 = cp1;
+  }
+
+  uint8_t *out = ssd->tx_buffer;
+  *out++ = 0x40;
+  for (uint8_t x = x0; x <= x1; ++x) {
+    const uint8_t *col = ram + x * ssd->pages;
+    uint8_t *old = ssd->shadow + x * ssd->pages;
+    for (uint8_t p = p0; p <= p1; ++p) {
+      *out++ = col[p];
+      old[p] = col[p];
+    }
+  }
+  ssd->shadow_valid = true;
+
+  win[0] = x0; win[1] = x1; win[2] = p0; win[3] = p1;
+  return out - ssd->tx_buffer - 1;
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
@@ -39,9 +121,11 @@ void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_CHARGE_PUMP);
   ssd1306_command(ssd, 0x14);
   ssd1306_command(ssd, SET_DISP | 0x01);
+  ssd1306_invalidate(ssd); // RAM do display desconhecida após a configuração
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  if (ssd->bus) i2c_async_wait(ssd->bus);
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -53,68 +137,142 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
 }
 
 void ssd1306_send_data(ssd1306_t *ssd) {
+  uint8_t win[4];
+  if (ssd->bus) i2c_async_wait(ssd->bus); // tx_buffer pode estar em uso pelo DMA
+  TRACE_BEGIN(TRACE_DISPLAY);
+  size_t len = ssd1306_prepare(ssd, win);
+  if (len == 0) return;
+
   ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
+  ssd1306_command(ssd, win[0]);
+  ssd1306_command(ssd, win[1]);
   ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
+  ssd1306_command(ssd, win[2]);
+  ssd1306_command(ssd, win[3]);
   i2c_write_blocking(
     ssd->i2c_port,
     ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
+    ssd->tx_buffer,
+    len + 1,
     false
   );
+  TRACE_END(TRACE_DISPLAY);
+}
+
+void ssd1306_set_async(ssd1306_t *ssd, i2c_async_t *bus) {
+  ssd->bus = bus;
+}
+
+bool ssd1306_busy(const ssd1306_t *ssd) {
+  return ssd->bus && (ssd->cmd_xfer.busy || ssd->data_xfer.busy);
+}
+
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  if (!ssd->bus) {
+    ssd1306_send_data(ssd);
+    return true;
+  }
+  if (ssd1306_busy(ssd)) return false;
+
+  // Só o tempo de CPU: o quadro sai depois pelo DMA
+  TRACE_BEGIN(TRACE_DISPLAY);
+  uint8_t win[4];
+  size_t len = ssd1306_prepare(ssd, win);
+  if (len == 0) return true;
+
+  // Byte de controle 0x00: os bytes seguintes são todos comandos
+  ssd->cmd_buffer[0] = 0x00;
+  ssd->cmd_buffer[1] = SET_COL_ADDR;
+  ssd->cmd_buffer[2] = win[0];
+  ssd->cmd_buffer[3] = win[1];
+  ssd->cmd_buffer[4] = SET_PAGE_ADDR;
+  ssd->cmd_buffer[5] = win[2];
+  ssd->cmd_buffer[6] = win[3];
+  // Fila cheia: a janela já saiu da sombra, então a tela inteira é reenviada depois
+  if (!i2c_async_write_read(ssd->bus, &ssd->cmd_xfer, ssd->address,
+                            ssd->cmd_buffer, sizeof(ssd->cmd_buffer), NULL, 0, NULL, NULL) ||
+      !i2c_async_write_read(ssd->bus, &ssd->data_xfer, ssd->address,
+                            ssd->tx_buffer, len + 1, NULL, 0, NULL, NULL)) {
+    ssd1306_invalidate(ssd);
+    return false;
+  }
+  TRACE_END(TRACE_DISPLAY);
+  return true;
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height) return;
   uint16_t index = (y >> 3) + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
+  ssd1306_mark(ssd, x, x, y >> 3, y >> 3);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Byte da página p na coluna x (endereçamento vertical: colunas contíguas)
+static inline uint8_t *ssd1306_byte(ssd1306_t *ssd, uint8_t x, uint8_t p) {
+  return ssd->ram_buffer + 1 + x * ssd->pages + p;
+}
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+// Liga/desliga os bits de mask no byte
+static inline void ssd1306_apply(uint8_t *byte, uint8_t mask, bool value) {
+  if (value)
+    *byte |= mask;
+  else
+    *byte &= ~mask;
 }
 
+// Trecho vertical y0..y1 da coluna x, um byte por página (já recortado e marcado)
+static void ssd1306_vspan(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t p0 = y0 >> 3, p1 = y1 >> 3;
+  uint8_t *col = ssd1306_byte(ssd, x, 0);
+  for (uint8_t p = p0; p <= p1; ++p) {
+    uint8_t mask = 0xFF;
+    if (p == p0) mask &= 0xFF << (y0 & 7);
+    if (p == p1) mask &= 0xFF >> (7 - (y1 & 7));
+    ssd1306_apply(&col[p], mask, value);
+  }
+}
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
-  }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
-  }
+  if (width == 0 || height == 0) return;
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    if (left >= ssd->width || top >= ssd->height) return;
+    if (right >= ssd->width) right = ssd->width - 1;
+    if (bottom >= ssd->height) bottom = ssd->height - 1;
+    ssd1306_mark(ssd, left, right, top >> 3, bottom >> 3);
+    for (uint8_t x = left; x <= right; ++x)
+      ssd1306_vspan(ssd, x, top, bottom, value);
+    return;
   }
+
+  ssd1306_hline(ssd, left, right, top, value);
+  ssd1306_hline(ssd, left, right, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom, value);
+  ssd1306_vline(ssd, right, top, bottom, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+    // Retas horizontais e verticais usam os trechos por byte
+    if (y0 == y1) {
+        ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+        return;
+    }
+    if (x0 == x1) {
+        ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+        return;
+    }
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -144,13 +302,22 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x0 > x1 || x0 >= ssd->width || y >= ssd->height) return;
+  if (x1 >= ssd->width) x1 = ssd->width - 1;
+
+  // Mesmo bit da mesma página em colunas vizinhas: passo de pages bytes
+  uint8_t mask = 1 << (y & 7);
+  uint8_t *byte = ssd1306_byte(ssd, x0, y >> 3);
+  ssd1306_mark(ssd, x0, x1, y >> 3, y >> 3);
+  for (uint8_t x = x0; x <= x1; ++x, byte += ssd->pages)
+    ssd1306_apply(byte, mask, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y0 > y1 || x >= ssd->width || y0 >= ssd->height) return;
+  if (y1 >= ssd->height) y1 = ssd->height - 1;
+  ssd1306_mark(ssd, x, x, y0 >> 3, y1 >> 3);
+  ssd1306_vspan(ssd, x, y0, y1, value);
 }
 
 // Função para desenhar um caractere
@@ -169,14 +336,29 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
     index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
+  if (x >= ssd->width || y >= ssd->height) return;
+
+  // Cada byte da fonte é uma coluna do glifo (bit j = linha y + j), igual ao
+  // formato das páginas do display: copia byte a byte
+  uint8_t cols = ssd->width - x < 8 ? ssd->width - x : 8;
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  bool lower = shift != 0 && page + 1 < ssd->pages; // Glifo cruza para a página de baixo
+  ssd1306_mark(ssd, x, x + cols - 1, page, lower ? page + 1 : page);
+
+  for (uint8_t i = 0; i < cols; ++i)
   {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
+    uint8_t line = font[index + i]; // Coluna i do caractere
+    uint8_t *col = ssd1306_byte(ssd, x + i, page);
+    if (shift == 0)
     {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
+      col[0] = line;
+      continue;
     }
+    // Desalinhado: parte de cima na página, o resto no início da página seguinte
+    col[0] = (col[0] & (0xFF >> (8 - shift))) | (line << shift);
+    if (lower)
+      col[1] = (col[1] & (0xFF << shift)) | (line >> (8 - shift));
   }
 }
 
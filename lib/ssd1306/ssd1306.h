@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "../i2c_async/i2c_async.h"
 
 #define WIDTH 128
 #define HEIGHT 64
@@ -35,12 +36,35 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  i2c_async_t *bus;          // Envio sem bloquear (NULL: só envio bloqueante)
+  i2c_async_xfer_t cmd_xfer; // Janela de endereçamento
+  i2c_async_xfer_t data_xfer; // Quadro
+  uint8_t cmd_buffer[7];
+  // Atualização parcial: só a janela (colunas x páginas) que mudou é enviada
+  uint8_t *shadow;           // Conteúdo atual da tela (sem o byte de controle)
+  uint8_t *tx_buffer;        // Byte de controle + bytes da janela enviada
+  bool shadow_valid;         // false: a tela é desconhecida, envia tudo
+  bool dirty;                // Houve escrita desde o último envio
+  uint8_t dirty_x0, dirty_x1; // Colunas escritas desde o último envio
+  uint8_t dirty_p0, dirty_p1; // Páginas escritas desde o último envio
 } ssd1306_t;
 
+// ssd deve começar zerado (variável global ou estática); chamadas seguintes
+// reaproveitam os buffers
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+// Envia ao display só a janela que mudou desde o último envio (nada, se não mudou)
 void ssd1306_send_data(ssd1306_t *ssd);
+// Força o próximo envio a ser do quadro inteiro
+void ssd1306_invalidate(ssd1306_t *ssd);
+
+// Envio do quadro por DMA (ver lib/i2c_async). A janela enviada é copiada para
+// tx_buffer, então o quadro pode ser redesenhado enquanto ssd1306_busy for true.
+// As funções bloqueantes esperam o envio terminar
+void ssd1306_set_async(ssd1306_t *ssd, i2c_async_t *bus);
+bool ssd1306_send_data_async(ssd1306_t *ssd); // false se o quadro anterior ainda estiver saindo
+bool ssd1306_busy(const ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -0,0 +1,76 @@
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t buckets[TRACE_BUCKETS];
+} trace_stats_t;
+
+static const char *const trace_names[TRACE_PROBE_COUNT] = {
+    [TRACE_SENSOR_READ] = "sensor_read",
+    [TRACE_SAMPLE_AGE] = "sample_age",
+    [TRACE_FORMAT] = "format",
+    [TRACE_LOG_WRITE] = "log_write",
+    [TRACE_F_WRITE] = "f_write",
+    [TRACE_RAW_WAIT] = "raw_wait",
+    [TRACE_SD_WAIT] = "sd_wait_ready",
+    [TRACE_DISPLAY] = "display_send",
+    [TRACE_UI] = "ui_task",
+    [TRACE_LOOP] = "main_loop",
+};
+
+static trace_stats_t trace_stats[TRACE_PROBE_COUNT];
+
+// Balde de us: número de bits significativos, limitado ao último
+static uint32_t trace_bucket(uint32_t us) {
+    uint32_t bucket = 0;
+    while (us && bucket < TRACE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void trace_record(trace_probe_t probe, uint32_t us) {
+    trace_stats_t *s = &trace_stats[probe];
+    s->count++;
+    s->total_us += us;
+    if (us > s->max_us) s->max_us = us;
+    s->buckets[trace_bucket(us)]++;
+}
+
+void trace_reset(void) {
+    memset(trace_stats, 0, sizeof(trace_stats));
+}
+
+void trace_dump(void) {
+    printf("Latencias (us): ponto, medidas, media, maximo | balde:contagem\n");
+    for (int p = 0; p < TRACE_PROBE_COUNT; p++) {
+        const trace_stats_t *s = &trace_stats[p];
+        if (s->count == 0) continue;
+
+        printf("%-13s %8lu %8lu %8lu |", trace_names[p], (unsigned long)s->count,
+               (unsigned long)(s->total_us / s->count), (unsigned long)s->max_us);
+        for (int b = 0; b < TRACE_BUCKETS; b++) {
+            if (s->buckets[b] == 0) continue;
+            // Limite inferior do balde: 0, 1, 2, 4, ...
+            printf(" %s%lu:%lu", b == TRACE_BUCKETS - 1 ? ">=" : "",
+                   b ? 1ul << (b - 1) : 0ul, (unsigned long)s->buckets[b]);
+        }
+        printf("\n");
+    }
+}
+
+void trace_poll(void) {
+    int c = getchar_timeout_us(0);
+    if (c == 't') trace_dump();
+    else if (c == 'r') trace_reset();
+}
+
+#endif // TRACE_ENABLED
@@ -0,0 +1,65 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+// Medição de latência dos trechos críticos (pontos de prova).
+// Cada ponto acumula contagem, soma, máximo e um histograma log2 dos tempos
+// em us: o balde 0 conta as medidas de 0 us e o balde k as de 2^(k-1) a
+// 2^k - 1 us; o último acumula tudo acima. O relatório sai pelo stdio (USB)
+// ao fim da gravação ou com a tecla 't' ('r' zera as medidas).
+//
+// Desligado por padrão: com TRACE_ENABLED 0 (cmake -DDATALOGGER_TRACE=ON liga)
+// as macros não geram código e trace.c fica vazio.
+//
+// Cada ponto deve ser medido sempre no mesmo núcleo: os contadores não são
+// atômicos, só têm um escritor.
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+// Baldes do histograma: o último começa em 2^(TRACE_BUCKETS - 2) us (~4 s)
+#define TRACE_BUCKETS 24
+
+typedef enum {
+    TRACE_SENSOR_READ,  // Leitura do MPU6050 no callback do sampler
+    TRACE_SAMPLE_AGE,   // Tempo da amostra na fila até ser gravada
+    TRACE_FORMAT,       // Formatação da linha CSV ou do quadro binário
+    TRACE_LOG_WRITE,    // sd_wbuf_write de uma amostra
+    TRACE_F_WRITE,      // f_write de um bloco do sd_wbuf
+    TRACE_RAW_WAIT,     // Espera da outra metade no modo direto do sd_wbuf
+    TRACE_SD_WAIT,      // Cartão ocupado (sd_wait_ready bloqueante)
+    TRACE_DISPLAY,      // Envio de um quadro ao SSD1306
+    TRACE_UI,           // ui_task
+    TRACE_LOOP,         // Uma volta do laço principal durante a gravação
+    TRACE_PROBE_COUNT
+} trace_probe_t;
+
+#if TRACE_ENABLED
+
+// Marca o início do trecho (declara uma variável local) e registra o fim
+#define TRACE_BEGIN(probe) uint32_t trace_t0_##probe = time_us_32()
+#define TRACE_END(probe) trace_record((probe), time_us_32() - trace_t0_##probe)
+// Registra uma duração já medida
+#define TRACE_VALUE(probe, us) trace_record((probe), (us))
+
+void trace_record(trace_probe_t probe, uint32_t us);
+void trace_reset(void);
+void trace_dump(void);
+// Atende os comandos do stdio sem bloquear ('t': relatório, 'r': zera)
+void trace_poll(void);
+
+#else
+
+#define TRACE_BEGIN(probe) do {} while (0)
+#define TRACE_END(probe) do {} while (0)
+#define TRACE_VALUE(probe, us) do {} while (0)
+#define trace_reset() do {} while (0)
+#define trace_dump() do {} while (0)
+#define trace_poll() do {} while (0)
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
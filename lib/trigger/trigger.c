@@ -0,0 +1,102 @@
+#include "trigger.h"
+#include <string.h>
+
+// Escalas do MPU6050 na configuração padrão (±2 g, ±250 °/s)
+#define TRIGGER_LSB_PER_G 16384
+#define TRIGGER_LSB_PER_DPS 131
+
+// Maior módulo possível da aceleração em LSB: raiz de 3 * 32768²
+#define TRIGGER_MAX_MAGNITUDE 56756
+
+void trigger_init(trigger_t *tr, const trigger_config_t *config) {
+    memset(tr, 0, sizeof(*tr));
+    tr->config = *config;
+    if (tr->config.pre_samples > TRIGGER_PRE_MAX) tr->config.pre_samples = TRIGGER_PRE_MAX;
+    if (tr->config.post_samples == 0) tr->config.post_samples = 1;
+
+    uint32_t t;
+    switch (tr->config.cond) {
+    case TRIGGER_ACCEL:
+        // Compara o quadrado do módulo, sem raiz: fora de [(1 g - T)², (1 g + T)²]
+        t = (uint32_t)((uint64_t)tr->config.threshold * TRIGGER_LSB_PER_G / 1000);
+        if (t > TRIGGER_MAX_MAGNITUDE - TRIGGER_LSB_PER_G) t = TRIGGER_MAX_MAGNITUDE - TRIGGER_LSB_PER_G;
+        tr->limit_hi = (TRIGGER_LSB_PER_G + t) * (TRIGGER_LSB_PER_G + t);
+        tr->limit_lo = t < TRIGGER_LSB_PER_G ? (TRIGGER_LSB_PER_G - t) * (TRIGGER_LSB_PER_G - t) : 0;
+        break;
+    case TRIGGER_GYRO:
+        t = tr->config.threshold * TRIGGER_LSB_PER_DPS;
+        tr->limit_hi = t < 32767 ? t : 32767;
+        break;
+    case TRIGGER_SLOPE:
+        t = (uint32_t)((uint64_t)tr->config.threshold * TRIGGER_LSB_PER_G / 1000);
+        tr->limit_hi = t < 65535 ? t : 65535;
+        break;
+    }
+}
+
+static int32_t trigger_abs(int32_t v) {
+    return v < 0 ? -v : v;
+}
+
+static bool trigger_check(trigger_t *tr, const sample_t *s) {
+    switch (tr->config.cond) {
+    case TRIGGER_ACCEL: {
+        uint32_t sq = 0;
+        for (int i = 0; i < 3; i++) sq += (uint32_t)((int32_t)s->accel[i] * s->accel[i]);
+        return sq > tr->limit_hi || sq < tr->limit_lo;
+    }
+    case TRIGGER_GYRO:
+        for (int i = 0; i < 3; i++)
+            if ((uint32_t)trigger_abs(s->gyro[i]) > tr->limit_hi) return true;
+        return false;
+    case TRIGGER_SLOPE:
+        if (!tr->has_prev) return false;
+        for (int i = 0; i < 3; i++)
+            if ((uint32_t)trigger_abs(s->accel[i] - tr->prev_accel[i]) > tr->limit_hi) return true;
+        return false;
+    }
+    return false;
+}
+
+trigger_action_t trigger_add(trigger_t *tr, const sample_t *sample) {
+    trigger_action_t action;
+
+    // O anel já foi gravado: recomeça vazio para o próximo evento
+    if (tr->ring_used) {
+        tr->filled = 0;
+        tr->ring_used = false;
+    }
+
+    if (tr->post_left > 0) {
+        action = --tr->post_left ? TRIGGER_POST : TRIGGER_DONE;
+    } else if (trigger_check(tr, sample)) {
+        tr->events++;
+        tr->post_left = tr->config.post_samples - 1;
+        tr->ring_used = true;
+        action = TRIGGER_FIRED;
+    } else {
+        action = TRIGGER_WAIT;
+        if (tr->config.pre_samples > 0) {
+            tr->ring[tr->head] = *sample;
+            tr->head = (tr->head + 1) % tr->config.pre_samples;
+            if (tr->filled < tr->config.pre_samples) tr->filled++;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) tr->prev_accel[i] = sample->accel[i];
+    tr->has_prev = true;
+    return action;
+}
+
+uint32_t trigger_pre_count(const trigger_t *tr) {
+    return tr->filled;
+}
+
+const sample_t *trigger_pre_get(const trigger_t *tr, uint32_t i) {
+    uint32_t size = tr->config.pre_samples;
+    return &tr->ring[(tr->head + size - tr->filled + i) % size];
+}
+
+bool trigger_in_event(const trigger_t *tr) {
+    return tr->post_left > 0;
+}
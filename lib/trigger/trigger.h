@@ -0,0 +1,69 @@
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "../sampler/sampler.h"
+
+// Gravação por evento. Armado, o gatilho guarda as últimas amostras num anel
+// em RAM (pré-disparo) e testa a condição a cada amostra. No disparo, quem
+// chama grava as amostras do anel e, em seguida, as pós-disparo, até o fim
+// do evento; depois o gatilho volta a se armar sozinho. O uso do cartão
+// acompanha os eventos, não o tempo ligado.
+
+// Maior quantidade de amostras pré-disparo (sample_t tem 24 bytes)
+#define TRIGGER_PRE_MAX 512
+
+// Condição de disparo (o limiar está na unidade indicada)
+typedef enum {
+    TRIGGER_ACCEL, // |módulo da aceleração - 1 g| acima do limiar (mg)
+    TRIGGER_GYRO,  // Algum eixo do giroscópio acima do limiar (°/s)
+    TRIGGER_SLOPE, // Variação de algum eixo da aceleração entre amostras acima do limiar (mg)
+} trigger_cond_t;
+
+typedef struct {
+    trigger_cond_t cond;
+    uint32_t threshold;
+    uint32_t pre_samples;  // Amostras antes do disparo (até TRIGGER_PRE_MAX)
+    uint32_t post_samples; // Amostras a partir do disparo (inclusive), ao menos 1
+} trigger_config_t;
+
+// Resultado de trigger_add para a amostra recebida
+typedef enum {
+    TRIGGER_WAIT,  // Armado: a amostra foi para o anel
+    TRIGGER_FIRED, // Disparou nesta amostra: gravar o anel e depois ela (se
+                   // trigger_in_event der false, o evento já acabou nela)
+    TRIGGER_POST,  // Evento em andamento: gravar a amostra
+    TRIGGER_DONE,  // Última amostra do evento: gravar e fechar o arquivo
+} trigger_action_t;
+
+typedef struct {
+    trigger_config_t config;
+    uint32_t limit_lo;      // Limiares já em LSB (ou LSB² para o módulo)
+    uint32_t limit_hi;
+    sample_t ring[TRIGGER_PRE_MAX];
+    uint32_t head;          // Próxima posição do anel
+    uint32_t filled;        // Amostras válidas no anel
+    uint32_t post_left;     // Amostras que faltam no evento (0: armado)
+    bool ring_used;         // Anel entregue no disparo: esvaziar na próxima amostra
+    int16_t prev_accel[3];  // Amostra anterior (TRIGGER_SLOPE)
+    bool has_prev;
+    uint32_t events;        // Eventos disparados desde o init
+} trigger_t;
+
+// Configura e arma o gatilho (limites fora da faixa são ajustados)
+void trigger_init(trigger_t *tr, const trigger_config_t *config);
+
+// Processa uma amostra, na ordem de aquisição. O(1)
+trigger_action_t trigger_add(trigger_t *tr, const sample_t *sample);
+
+// Amostras pré-disparo guardadas no anel (válido logo após TRIGGER_FIRED)
+uint32_t trigger_pre_count(const trigger_t *tr);
+
+// Amostra pré-disparo i, da mais antiga (0) à mais recente
+const sample_t *trigger_pre_get(const trigger_t *tr, uint32_t i);
+
+// Evento em andamento (entre TRIGGER_FIRED e TRIGGER_DONE)
+bool trigger_in_event(const trigger_t *tr);
+
+#endif // TRIGGER_H
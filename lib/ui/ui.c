@@ -0,0 +1,263 @@
+#include "ui.h"
+#include <stdio.h>
+#include <string.h>
+#include "../ssd1306/display.h"
+#include "../csvfmt/csvfmt.h"
+
+// Área do gráfico do envelope na tela de gravação
+#define UI_ENV_X 6
+#define UI_ENV_TOP 30
+#define UI_ENV_HEIGHT 22
+
+// Seleção do arquivo atual
+static void ui_render_choice(ui_t *ui) {
+    draw_centered_text(ui->ssd, "SELECIONE CSV:", 5);
+    draw_centered_text(ui->ssd, ui->scene.choice, 25);
+    draw_centered_text(ui->ssd, "A: Selecionar", 45);
+    draw_centered_text(ui->ssd, "B: Voltar", 55);
+}
+
+// Menu principal: opção atual com a ação do botão A
+static void ui_render_menu(ui_t *ui) {
+    ssd1306_t *ssd = ui->ssd;
+    const ui_scene_t *s = &ui->scene;
+
+    if (s->menu == MODO_SELECIONAR_ARQUIVO) {
+        ui_render_choice(ui);
+        return;
+    }
+
+    draw_centered_text(ssd, "<>", 0);
+    switch (s->menu) {
+        case MODO_MONTAR_DESMONTAR:
+            draw_centered_text(ssd, s->sd_mounted ? "DESMONTAR" : "MONTAR", 10);
+            draw_centered_text(ssd, "A: Confirmar", 40);
+            break;
+        case MODO_GRAVAR:
+            draw_centered_text(ssd, "GRAVAR DADOS", 10);
+            draw_centered_text(ssd, s->filename, 20);
+            draw_centered_text(ssd, "A: Iniciar", 40);
+            break;
+        case MODO_GATILHO:
+            draw_centered_text(ssd, "GRAVAR EVENTOS", 10);
+            draw_centered_text(ssd, s->sd_mounted ? "POR GATILHO" : "SD NAO MONTADO", 20);
+            draw_centered_text(ssd, "A: Armar", 40);
+            break;
+        case MODO_LER:
+            draw_centered_text(ssd, "LER ARQUIVO:", 10);
+            draw_centered_text(ssd, s->filename, 20);
+            draw_centered_text(ssd, "A: Abrir", 40);
+            break;
+        case MODO_ALTERAR_ARQUIVO:
+            draw_centered_text(ssd, "ALTERAR ARQUIVO", 10);
+            draw_centered_text(ssd, s->filename, 20);
+            draw_centered_text(ssd, "A: ALTERAR", 40);
+            break;
+        case MODO_BOOTSEL:
+            draw_centered_text(ssd, "HABILITAR", 10);
+            draw_centered_text(ssd, "MODO BOOTSEL", 20);
+            draw_centered_text(ssd, "A: Confirmar", 40);
+            break;
+        default:
+            break;
+    }
+}
+
+// Envelope mínimo/máximo como barras verticais, com a escala ajustada à
+// faixa das colunas visíveis. Embaixo, a faixa em g
+static void ui_render_envelope(ui_t *ui, const livestats_env_t *env) {
+    uint16_t lo = UINT16_MAX, hi = 0;
+
+    for (uint32_t i = 0; i < env->filled; i++) {
+        uint16_t cmin, cmax;
+        livestats_env_column(env, i, &cmin, &cmax);
+        if (cmin < lo) lo = cmin;
+        if (cmax > hi) hi = cmax;
+    }
+    if (env->filled == 0) return;
+
+    uint32_t span = hi > lo ? hi - lo : 1;
+    uint8_t bottom = UI_ENV_TOP + UI_ENV_HEIGHT - 1;
+    for (uint32_t i = 0; i < env->filled; i++) {
+        uint16_t cmin, cmax;
+        livestats_env_column(env, i, &cmin, &cmax);
+        uint8_t y0 = bottom - (uint8_t)((uint32_t)(cmax - lo) * (UI_ENV_HEIGHT - 1) / span);
+        uint8_t y1 = bottom - (uint8_t)((uint32_t)(cmin - lo) * (UI_ENV_HEIGHT - 1) / span);
+        ssd1306_vline(ui->ssd, UI_ENV_X + i, y0, y1, true);
+    }
+
+    // Mesma conversão do CSV: 100 * LSB / 16384
+    char range[UI_MESSAGE_LEN];
+    char *p = csvfmt_hundredths(range, (int32_t)lo * 25, 4096);
+    *p++ = '-';
+    p = csvfmt_hundredths(p, (int32_t)hi * 25, 4096);
+    p[0] = ' ';
+    p[1] = 'g';
+    p[2] = '\0';
+    draw_centered_text(ui->ssd, range, 54);
+}
+
+// Gravação: arquivo, contador de amostras e, se houver, o envelope da aceleração
+static void ui_render_capture(ui_t *ui) {
+    char status[30];
+
+    draw_centered_text(ui->ssd, "GRAVANDO...", 0);
+    ssd1306_draw_string(ui->ssd, ui->scene.filename, 5, 10);
+    snprintf(status, sizeof(status), "Amostras: %lu", (unsigned long)ui->scene.samples);
+    ssd1306_draw_string(ui->ssd, status, 5, 20);
+    if (ui->scene.env) ui_render_envelope(ui, ui->scene.env);
+}
+
+// Gatilho armado: estado, eventos gravados e o arquivo do último (ou atual)
+static void ui_render_trigger(ui_t *ui) {
+    const ui_scene_t *s = &ui->scene;
+    char status[30];
+
+    draw_centered_text(ui->ssd, s->trigger_recording ? "GRAVANDO EVENTO" : "AGUARDANDO", 0);
+    snprintf(status, sizeof(status), "Eventos: %lu", (unsigned long)s->trigger_events);
+    ssd1306_draw_string(ui->ssd, status, 5, 15);
+    if (s->trigger_recording) {
+        snprintf(status, sizeof(status), "Amostras: %lu", (unsigned long)s->samples);
+        ssd1306_draw_string(ui->ssd, status, 5, 25);
+    }
+    draw_centered_text(ui->ssd, s->filename, 40);
+    draw_centered_text(ui->ssd, "A: Desarmar", 50);
+}
+
+// Mensagem temporária: linhas centralizadas
+static void ui_render_message(ui_t *ui) {
+    for (int i = 0; i < UI_MESSAGE_LINES; i++)
+        draw_centered_text(ui->ssd, ui->scene.message_lines[i], 20 + 10 * i);
+}
+
+static void ui_send(ui_t *ui) {
+    if (ui->ssd->bus)
+        ssd1306_send_data_async(ui->ssd);
+    else
+        ssd1306_send_data(ui->ssd);
+}
+
+void ui_init(ui_t *ui, ssd1306_t *ssd) {
+    memset(ui, 0, sizeof(*ui));
+    ui->ssd = ssd;
+    ui->scene.screen = UI_SCREEN_MENU;
+    ui->scene.menu = MODO_MONTAR_DESMONTAR;
+    ui->revision = 1; // Primeiro quadro sempre desenhado
+}
+
+void ui_set_frame_interval(ui_t *ui, ui_screen_t screen, uint32_t interval_ms) {
+    if (screen < UI_SCREEN_COUNT) ui->frame_interval_us[screen] = interval_ms * 1000u;
+}
+
+void ui_set_screen(ui_t *ui, ui_screen_t screen) {
+    if (ui->scene.screen == screen) return;
+    ui->scene.screen = screen;
+    ui->last_frame_us = 0; // Troca de tela aparece já, sem esperar o orçamento
+    ui->revision++;
+}
+
+void ui_set_menu(ui_t *ui, menu_state_t menu) {
+    if (ui->scene.menu == menu) return;
+    ui->scene.menu = menu;
+    ui->revision++;
+}
+
+void ui_set_sd_mounted(ui_t *ui, bool mounted) {
+    if (ui->scene.sd_mounted == mounted) return;
+    ui->scene.sd_mounted = mounted;
+    ui->revision++;
+}
+
+void ui_set_filename(ui_t *ui, const char *filename) {
+    if (strncmp(ui->scene.filename, filename, UI_FILENAME_LEN - 1) == 0) return;
+    strncpy(ui->scene.filename, filename, UI_FILENAME_LEN - 1);
+    ui->scene.filename[UI_FILENAME_LEN - 1] = '\0';
+    ui->revision++;
+}
+
+void ui_set_samples(ui_t *ui, uint32_t samples) {
+    if (ui->scene.samples == samples) return;
+    ui->scene.samples = samples;
+    ui->revision++;
+}
+
+void ui_show_message(ui_t *ui, const char *line1, const char *line2, const char *line3, uint32_t hold_ms) {
+    const char *lines[UI_MESSAGE_LINES] = { line1, line2, line3 };
+
+    for (int i = 0; i < UI_MESSAGE_LINES; i++) {
+        strncpy(ui->scene.message_lines[i], lines[i] ? lines[i] : "", UI_MESSAGE_LEN - 1);
+        ui->scene.message_lines[i][UI_MESSAGE_LEN - 1] = '\0';
+    }
+    ui->scene.message = true;
+    ui->message_until_us = time_us_64() + (uint64_t)hold_ms * 1000u;
+    ui_invalidate(ui);
+}
+
+void ui_set_choice(ui_t *ui, const char *choice) {
+    if (strncmp(ui->scene.choice, choice, UI_FILENAME_LEN - 1) == 0) return;
+    strncpy(ui->scene.choice, choice, UI_FILENAME_LEN - 1);
+    ui->scene.choice[UI_FILENAME_LEN - 1] = '\0';
+    ui->revision++;
+}
+
+// Redesenha quando o envelope ganha uma coluna
+void ui_set_envelope(ui_t *ui, const livestats_env_t *env) {
+    uint32_t columns = env ? env->columns : 0;
+    if (ui->scene.env == env && ui->scene.env_columns == columns) return;
+    ui->scene.env = env;
+    ui->scene.env_columns = columns;
+    ui->revision++;
+}
+
+void ui_set_trigger(ui_t *ui, uint32_t events, bool recording) {
+    if (ui->scene.trigger_events == events && ui->scene.trigger_recording == recording) return;
+    ui->scene.trigger_events = events;
+    ui->scene.trigger_recording = recording;
+    ui->revision++;
+}
+
+void ui_invalidate(ui_t *ui) {
+    ui->last_frame_us = 0;
+    ui->revision++;
+}
+
+bool ui_task(ui_t *ui) {
+    // Quadro anterior ficou no buffer (fila do barramento cheia): reenvia
+    if (ui->ssd->dirty && !ssd1306_busy(ui->ssd)) ui_send(ui);
+
+    uint64_t now = time_us_64();
+    if (ui->scene.message && now >= ui->message_until_us) {
+        ui->scene.message = false; // Volta à tela de baixo
+        ui_invalidate(ui);
+    }
+
+    if (ui->rendered == ui->revision) return false;
+
+    uint32_t interval = ui->frame_interval_us[ui->scene.screen];
+    if (ui->last_frame_us != 0 && now - ui->last_frame_us < interval) return false;
+    if (ssd1306_busy(ui->ssd)) return false; // Quadro anterior ainda saindo pelo DMA
+
+    ui->last_frame_us = now;
+    ui->rendered = ui->revision;
+
+    ssd1306_fill(ui->ssd, false);
+    if (ui->scene.message) {
+        ui_render_message(ui);
+    } else {
+        switch (ui->scene.screen) {
+            case UI_SCREEN_MENU:
+                ui_render_menu(ui);
+                break;
+            case UI_SCREEN_CAPTURE:
+                ui_render_capture(ui);
+                break;
+            case UI_SCREEN_TRIGGER:
+                ui_render_trigger(ui);
+                break;
+            default:
+                break;
+        }
+    }
+    ui_send(ui); // Só a janela que mudou sai pelo barramento
+    return true;
+}
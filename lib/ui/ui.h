@@ -0,0 +1,96 @@
+#ifndef UI_H
+#define UI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "../ssd1306/ssd1306.h"
+#include "../livestats/livestats.h"
+
+// Interface do display com cena retida: o laço principal só atualiza o estado
+// (tela, opção do menu, arquivo, contador de amostras) e ui_task redesenha
+// quando algo mudou, respeitando o intervalo mínimo entre quadros da tela.
+// Nada aqui é chamado pela aquisição: o display nunca atrasa a amostragem.
+
+// Estados do menu principal
+typedef enum {
+    MODO_MONTAR_DESMONTAR,
+    MODO_GRAVAR,
+    MODO_GATILHO, // Gravação por evento (armar/desarmar o gatilho)
+    MODO_LER,
+    MODO_ALTERAR_ARQUIVO,
+    MODO_BOOTSEL,
+    MODO_SELECIONAR_ARQUIVO, // Escolha do arquivo atual (entrada pelo MODO_ALTERAR_ARQUIVO)
+    MENU_STATE_COUNT
+} menu_state_t;
+
+// Telas mantidas pela interface
+typedef enum {
+    UI_SCREEN_MENU,    // Menu principal
+    UI_SCREEN_CAPTURE, // Gravação em andamento
+    UI_SCREEN_TRIGGER, // Gatilho armado, esperando ou gravando um evento
+    UI_SCREEN_COUNT
+} ui_screen_t;
+
+#define UI_FILENAME_LEN 20
+#define UI_MESSAGE_LINES 3
+#define UI_MESSAGE_LEN 22
+
+// Estado mostrado na tela
+typedef struct {
+    ui_screen_t screen;
+    menu_state_t menu;
+    bool sd_mounted;
+    char filename[UI_FILENAME_LEN];
+    uint32_t samples;
+    char choice[UI_FILENAME_LEN]; // Arquivo destacado na seleção
+    // Envelope do módulo da aceleração na tela de gravação (NULL: sem gráfico).
+    // Não é copiado: a cena só guarda quantas colunas já foram desenhadas
+    const livestats_env_t *env;
+    uint32_t env_columns;
+    // Gravação por evento
+    uint32_t trigger_events;  // Eventos gravados desde que foi armado
+    bool trigger_recording;   // Evento em andamento
+    // Mensagem temporária por cima da tela (ex.: erro ou fim da gravação)
+    bool message;
+    char message_lines[UI_MESSAGE_LINES][UI_MESSAGE_LEN];
+} ui_scene_t;
+
+typedef struct {
+    ssd1306_t *ssd;
+    ui_scene_t scene;
+    uint32_t revision;        // Incrementado a cada mudança da cena
+    uint32_t rendered;        // Revisão do último quadro desenhado
+    uint32_t frame_interval_us[UI_SCREEN_COUNT]; // Orçamento de quadros por tela
+    uint64_t last_frame_us;
+    uint64_t message_until_us; // Fim da mensagem temporária
+} ui_t;
+
+void ui_init(ui_t *ui, ssd1306_t *ssd);
+
+// Intervalo mínimo entre quadros (em ms) de uma tela
+void ui_set_frame_interval(ui_t *ui, ui_screen_t screen, uint32_t interval_ms);
+
+// Atualizações da cena (baratas: só comparam e marcam a mudança)
+void ui_set_screen(ui_t *ui, ui_screen_t screen);
+void ui_set_menu(ui_t *ui, menu_state_t menu);
+void ui_set_sd_mounted(ui_t *ui, bool mounted);
+void ui_set_filename(ui_t *ui, const char *filename);
+void ui_set_samples(ui_t *ui, uint32_t samples);
+void ui_set_choice(ui_t *ui, const char *choice);
+void ui_set_envelope(ui_t *ui, const livestats_env_t *env);
+void ui_set_trigger(ui_t *ui, uint32_t events, bool recording);
+
+// Mostra até três linhas centralizadas por hold_ms e volta sozinha à tela
+// atual (linhas NULL ficam vazias). Substitui os sleep_ms das mensagens
+void ui_show_message(ui_t *ui, const char *line1, const char *line2, const char *line3, uint32_t hold_ms);
+
+// Força o redesenho (ex.: depois de uma mensagem desenhada por fora da cena)
+void ui_invalidate(ui_t *ui);
+
+// Redesenha e envia a cena se ela mudou e o orçamento da tela permite.
+// Não bloqueia: com o quadro anterior ainda saindo, tenta na próxima chamada.
+// Retorna true se um quadro foi desenhado
+bool ui_task(ui_t *ui);
+
+#endif // UI_H
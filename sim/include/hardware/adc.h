@@ -0,0 +1,14 @@
+#ifndef SIM_HARDWARE_ADC_H
+#define SIM_HARDWARE_ADC_H
+
+#include "pico/types.h"
+
+// ADC simulado: cada entrada devolve o valor definido pelo roteiro (meio da
+// escala por padrão, como o joystick em repouso)
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#endif // SIM_HARDWARE_ADC_H
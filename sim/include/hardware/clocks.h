@@ -0,0 +1,15 @@
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+#include "pico/types.h"
+
+enum clock_index {
+    clk_gpout0 = 0,
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_peri = 6,
+};
+
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif // SIM_HARDWARE_CLOCKS_H
@@ -0,0 +1,11 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+#include "pico/types.h"
+
+// Só os tipos usados pelos cabeçalhos do driver do SD
+typedef struct {
+    uint32_t ctrl;
+} dma_channel_config;
+
+#endif // SIM_HARDWARE_DMA_H
@@ -0,0 +1,29 @@
+#ifndef SIM_HARDWARE_I2C_H
+#define SIM_HARDWARE_I2C_H
+
+#include "pico/types.h"
+
+// I2C simulado: as transações são entregues aos dispositivos falsos pelo
+// endereço (MPU6050 em 0x68, SSD1306 em 0x3C) e o tempo virtual avança
+// conforme o número de bytes e a frequência do barramento
+
+typedef struct i2c_inst {
+    uint index;
+    uint baudrate;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c->index;
+}
+
+#endif // SIM_HARDWARE_I2C_H
@@ -0,0 +1,8 @@
+#ifndef SIM_HARDWARE_IRQ_H
+#define SIM_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+#endif // SIM_HARDWARE_IRQ_H
@@ -0,0 +1,9 @@
+#ifndef SIM_HARDWARE_PIO_H
+#define SIM_HARDWARE_PIO_H
+
+#include "pico/types.h"
+
+// A matriz de LEDs não é simulada: só os tipos do cabeçalho
+typedef struct pio_hw *PIO;
+
+#endif // SIM_HARDWARE_PIO_H
@@ -0,0 +1,23 @@
+#ifndef SIM_HARDWARE_PWM_H
+#define SIM_HARDWARE_PWM_H
+
+#include "pico/types.h"
+
+// PWM simulado: só guarda o estado, para contar os tons do buzzer
+
+typedef struct {
+    uint32_t csr;
+    uint32_t div;
+    uint32_t top;
+} pwm_config;
+
+uint pwm_gpio_to_slice_num(uint gpio);
+pwm_config pwm_get_default_config(void);
+void pwm_config_set_clkdiv(pwm_config *c, float div);
+void pwm_init(uint slice_num, pwm_config *c, bool start);
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_enabled(uint slice_num, bool enabled);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+
+#endif // SIM_HARDWARE_PWM_H
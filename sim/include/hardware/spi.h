@@ -0,0 +1,18 @@
+#ifndef SIM_HARDWARE_SPI_H
+#define SIM_HARDWARE_SPI_H
+
+#include "pico/types.h"
+
+// Só os tipos: o cartão SD é simulado acima do barramento (sim/sim_sd.c)
+
+typedef struct spi_inst {
+    uint index;
+} spi_inst_t;
+
+extern spi_inst_t spi0_inst;
+extern spi_inst_t spi1_inst;
+
+#define spi0 (&spi0_inst)
+#define spi1 (&spi1_inst)
+
+#endif // SIM_HARDWARE_SPI_H
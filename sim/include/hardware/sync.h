@@ -0,0 +1,17 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico/types.h"
+
+// "Interrupções" do simulador são os alarmes do relógio virtual: com elas
+// desabilitadas, nenhum callback roda antes do restore_interrupts
+
+void __dmb(void);
+void __sev(void);
+void __wfe(void);
+void __wfi(void);
+
+uint32_t save_and_disable_interrupts(void);
+void restore_interrupts(uint32_t status);
+
+#endif // SIM_HARDWARE_SYNC_H
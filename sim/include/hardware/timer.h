@@ -0,0 +1,12 @@
+#ifndef SIM_HARDWARE_TIMER_H
+#define SIM_HARDWARE_TIMER_H
+
+#include "pico/types.h"
+
+// Cada leitura do relógio avança o tempo virtual em 1 us
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void busy_wait_us(uint64_t delay_us);
+void busy_wait_us_32(uint32_t delay_us);
+
+#endif // SIM_HARDWARE_TIMER_H
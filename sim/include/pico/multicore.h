@@ -0,0 +1,12 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico/types.h"
+
+// O núcleo 1 não é simulado: compilar com SAMPLER_USE_CORE1=0
+void multicore_launch_core1(void (*entry)(void));
+void multicore_reset_core1(void);
+void multicore_fifo_push_blocking(uint32_t data);
+uint32_t multicore_fifo_pop_blocking(void);
+
+#endif // SIM_PICO_MULTICORE_H
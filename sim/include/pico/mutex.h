@@ -0,0 +1,11 @@
+#ifndef SIM_PICO_MUTEX_H
+#define SIM_PICO_MUTEX_H
+
+#include "pico/types.h"
+
+// Simulador com uma única linha de execução: só os tipos são necessários
+typedef struct {
+    int8_t owner;
+} mutex_t;
+
+#endif // SIM_PICO_MUTEX_H
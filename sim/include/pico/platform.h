@@ -0,0 +1,11 @@
+#ifndef SIM_PICO_PLATFORM_H
+#define SIM_PICO_PLATFORM_H
+
+#include "pico/types.h"
+
+uint get_core_num(void);
+
+// Laços de espera avançam o relógio virtual (e atendem os alarmes vencidos)
+void tight_loop_contents(void);
+
+#endif // SIM_PICO_PLATFORM_H
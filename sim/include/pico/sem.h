@@ -0,0 +1,11 @@
+#ifndef SIM_PICO_SEM_H
+#define SIM_PICO_SEM_H
+
+#include "pico/types.h"
+
+typedef struct {
+    int16_t permits;
+    int16_t max_permits;
+} semaphore_t;
+
+#endif // SIM_PICO_SEM_H
@@ -0,0 +1,12 @@
+#ifndef SIM_PICO_STDIO_H
+#define SIM_PICO_STDIO_H
+
+#include "pico/types.h"
+
+// No simulador, inicializa também os dispositivos falsos (sim/sim_gpio.c)
+bool stdio_init_all(void);
+
+// Teclas vindas do roteiro (comando "key"); PICO_ERROR_TIMEOUT se não houver
+int getchar_timeout_us(uint32_t timeout_us);
+
+#endif // SIM_PICO_STDIO_H
@@ -0,0 +1,11 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+#include "pico/types.h"
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include "hardware/timer.h"
+#include "pico/stdio.h"
+
+#endif // SIM_PICO_STDLIB_H
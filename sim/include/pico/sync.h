@@ -0,0 +1,8 @@
+#ifndef SIM_PICO_SYNC_H
+#define SIM_PICO_SYNC_H
+
+#include "hardware/sync.h"
+#include "pico/mutex.h"
+#include "pico/sem.h"
+
+#endif // SIM_PICO_SYNC_H
@@ -0,0 +1,24 @@
+#ifndef SIM_PICO_TYPES_H
+#define SIM_PICO_TYPES_H
+
+// Tipos básicos do SDK do Pico para o simulador no host
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t; // us desde o "boot" (relógio virtual)
+
+typedef volatile uint32_t io_rw_32;
+typedef volatile const uint32_t io_ro_32;
+
+#define __not_in_flash_func(f) f
+#define __time_critical_func(f) f
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+#define PICO_OK 0
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -2
+
+#endif // SIM_PICO_TYPES_H
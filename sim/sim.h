@@ -0,0 +1,48 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "pico/types.h"
+#include "hardware/i2c.h"
+
+// Simulador do datalogger no host.
+// O firmware roda sem alterações sobre o SDK falso de sim/include: o relógio
+// é virtual (avança a cada leitura e nos sleeps), as "interrupções" são os
+// alarmes desse relógio e os periféricos externos (MPU6050, SSD1306 e cartão
+// SD) são modelos em software. Os botões e o joystick seguem um roteiro.
+
+// Relógio virtual (sim_time.c)
+uint64_t sim_now_us(void);           // Instante atual, sem avançar o relógio
+void sim_advance_us(uint64_t us);    // Avança o relógio atendendo os alarmes vencidos
+bool sim_in_irq(void);               // true dentro de um callback de alarme
+void sim_finish(int code);           // Mostra as estatísticas e encerra
+
+// Entradas e roteiro (sim_gpio.c)
+void sim_init(void);
+void sim_gpio_set_input(uint gpio, bool value); // Muda o nível e gera a interrupção de borda
+void sim_adc_set(uint input, uint16_t value);
+
+// Barramento I2C (sim_i2c.c): entrega a transação ao dispositivo do endereço.
+// Retorna o número de bytes transferidos ou PICO_ERROR_GENERIC (NACK)
+int sim_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx, size_t tx_len,
+                     uint8_t *rx, size_t rx_len);
+uint64_t sim_i2c_duration_us(i2c_inst_t *i2c, size_t bytes); // Tempo no barramento
+
+// Dispositivos
+void sim_mpu6050_write(const uint8_t *src, size_t len);
+void sim_mpu6050_read(uint8_t *dst, size_t len);
+void sim_mpu6050_shock(uint64_t at_us, uint32_t duration_us, int32_t mg); // Pulso somado ao Z
+void sim_ssd1306_write(const uint8_t *src, size_t len);
+void sim_ssd1306_dump(void);
+void sim_sd_open(void);
+void sim_sd_close(void);
+
+// Estatísticas mostradas por sim_finish
+void sim_i2c_print_stats(void);
+void sim_ssd1306_print_stats(void);
+void sim_sd_print_stats(void);
+void sim_gpio_print_stats(void);
+
+#endif // SIM_H
@@ -0,0 +1,381 @@
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/bootrom.h"
+#include "pico/multicore.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/pwm.h"
+
+#define SIM_NUM_GPIOS 30
+#define SIM_NUM_ADC 5
+#define SIM_ADC_CENTER 2047
+#define SIM_ADC_MAX 4095
+
+// Pinos dos botões da placa (lib/button/button.h)
+#define SIM_BUTTON_A 5
+#define SIM_BUTTON_B 6
+#define SIM_BUTTON_SW 22
+
+// Entrada do ADC do eixo X do joystick
+#define SIM_JOYSTICK_X 1
+
+// Tempo que o roteiro mantém um botão pressionado ou o joystick deslocado
+#define SIM_PRESS_MS 50
+#define SIM_SHOCK_MS 50 // Duração padrão do pulso do comando shock
+
+// Maior roteiro aceito
+#define SIM_MAX_STEPS 256
+
+// Teclas do roteiro ainda não lidas por getchar_timeout_us
+#define SIM_KEY_QUEUE 16
+
+// Roteiro padrão: monta o SD, escolhe CSV, grava 10 s e encerra
+static const char sim_default_script[] =
+    "3000 a\n"
+    "8000 right\n"
+    "8500 a\n"
+    "18500 a\n"
+    "21000 quit\n";
+
+typedef enum {
+    SIM_CMD_PRESS,    // Pressiona e solta um pino (botão)
+    SIM_CMD_RELEASE,
+    SIM_CMD_ADC,      // Fixa o valor de uma entrada do ADC
+    SIM_CMD_KEY,      // Tecla recebida pelo stdio
+    SIM_CMD_QUIT,
+} sim_cmd_t;
+
+typedef struct {
+    sim_cmd_t cmd;
+    uint arg;
+    uint16_t value;
+} sim_step_t;
+
+static sim_step_t sim_steps[SIM_MAX_STEPS];
+static uint sim_step_count;
+
+static bool sim_gpio_level[SIM_NUM_GPIOS];
+static bool sim_gpio_out[SIM_NUM_GPIOS];
+static uint32_t sim_gpio_irq_mask[SIM_NUM_GPIOS];
+static gpio_irq_callback_t sim_gpio_callback;
+static uint16_t sim_adc_value[SIM_NUM_ADC];
+static uint sim_adc_selected;
+static uint32_t sim_presses;
+static uint32_t sim_tones;
+static bool sim_tone_on;
+static uint32_t sim_led_changes;
+static char sim_keys[SIM_KEY_QUEUE];
+static uint sim_key_head, sim_key_count;
+
+/*================== Roteiro ==================*/
+
+static int64_t sim_step_callback(alarm_id_t id, void *user_data) {
+    sim_step_t *step = user_data;
+    (void)id;
+
+    switch (step->cmd) {
+    case SIM_CMD_PRESS:
+        sim_presses++;
+        sim_gpio_set_input(step->arg, false);
+        break;
+    case SIM_CMD_RELEASE:
+        sim_gpio_set_input(step->arg, true);
+        break;
+    case SIM_CMD_ADC:
+        sim_adc_set(step->arg, step->value);
+        break;
+    case SIM_CMD_KEY:
+        if (sim_key_count < SIM_KEY_QUEUE)
+            sim_keys[(sim_key_head + sim_key_count++) % SIM_KEY_QUEUE] = (char)step->value;
+        break;
+    case SIM_CMD_QUIT:
+        fprintf(stderr, "[sim] fim do roteiro\n");
+        sim_finish(0);
+        break;
+    }
+    return 0;
+}
+
+static sim_step_t *sim_add_step(sim_cmd_t cmd, uint arg, uint16_t value, uint64_t at_ms) {
+    if (sim_step_count == SIM_MAX_STEPS) {
+        fprintf(stderr, "[sim] roteiro muito longo\n");
+        exit(1);
+    }
+    sim_step_t *step = &sim_steps[sim_step_count++];
+    step->cmd = cmd;
+    step->arg = arg;
+    step->value = value;
+
+    uint64_t at_us = at_ms * 1000;
+    uint64_t now = sim_now_us();
+    add_alarm_in_us(at_us > now ? at_us - now : 0, sim_step_callback, step, true);
+    return step;
+}
+
+// Uma linha do roteiro: "<ms> <comando> [argumentos]"
+static void sim_parse_line(const char *line, int number) {
+    unsigned long long ms;
+    char cmd[16];
+    unsigned a1 = 0, a2 = 0;
+    char key = 0;
+
+    while (*line == ' ' || *line == '\t') line++;
+    if (*line == '#' || *line == '\n' || *line == '\0') return;
+
+    int n = sscanf(line, "%llu %15s %u %u", &ms, cmd, &a1, &a2);
+    if (n == 2 && strcmp(cmd, "key") == 0) sscanf(line, "%*u %*s %c", &key);
+    if (n < 2) {
+        fprintf(stderr, "[sim] roteiro, linha %d: formato invalido\n", number);
+        exit(1);
+    }
+
+    uint pin = 0;
+    if (strcmp(cmd, "a") == 0) pin = SIM_BUTTON_A;
+    else if (strcmp(cmd, "b") == 0) pin = SIM_BUTTON_B;
+    else if (strcmp(cmd, "sw") == 0) pin = SIM_BUTTON_SW;
+    else if (strcmp(cmd, "gpio") == 0 && n >= 3 && a1 < SIM_NUM_GPIOS) pin = a1;
+
+    if (pin) {
+        sim_add_step(SIM_CMD_PRESS, pin, 0, ms);
+        sim_add_step(SIM_CMD_RELEASE, pin, 0, ms + SIM_PRESS_MS);
+    } else if (strcmp(cmd, "left") == 0 || strcmp(cmd, "right") == 0) {
+        sim_add_step(SIM_CMD_ADC, SIM_JOYSTICK_X, cmd[0] == 'l' ? 0 : SIM_ADC_MAX, ms);
+        sim_add_step(SIM_CMD_ADC, SIM_JOYSTICK_X, SIM_ADC_CENTER, ms + SIM_PRESS_MS);
+    } else if (strcmp(cmd, "adc") == 0 && n == 4 && a1 < SIM_NUM_ADC) {
+        sim_add_step(SIM_CMD_ADC, a1, (uint16_t)(a2 > SIM_ADC_MAX ? SIM_ADC_MAX : a2), ms);
+    } else if (strcmp(cmd, "key") == 0 && key) {
+        sim_add_step(SIM_CMD_KEY, 0, (uint8_t)key, ms);
+    } else if (strcmp(cmd, "shock") == 0 && n >= 3) {
+        int mg = 0;
+        sscanf(line, "%*u %*s %d", &mg);
+        sim_mpu6050_shock(ms * 1000, (n == 4 ? a2 : SIM_SHOCK_MS) * 1000, mg);
+    } else if (strcmp(cmd, "quit") == 0) {
+        sim_add_step(SIM_CMD_QUIT, 0, 0, ms);
+    } else {
+        fprintf(stderr, "[sim] roteiro, linha %d: comando desconhecido '%s'\n", number, cmd);
+        exit(1);
+    }
+}
+
+static void sim_load_script(void) {
+    const char *path = getenv("SIM_SCRIPT");
+    char line[128];
+    int number = 0;
+
+    if (!path) {
+        const char *p = sim_default_script;
+        while (*p) {
+            size_t len = strcspn(p, "\n");
+            snprintf(line, sizeof(line), "%.*s", (int)len, p);
+            sim_parse_line(line, ++number);
+            p += len + (p[len] == '\n');
+        }
+        return;
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "[sim] nao foi possivel abrir o roteiro %s\n", path);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), f)) sim_parse_line(line, ++number);
+    fclose(f);
+}
+
+void sim_init(void) {
+    for (uint i = 0; i < SIM_NUM_GPIOS; i++) sim_gpio_level[i] = true; // Pull-ups da placa
+    for (uint i = 0; i < SIM_NUM_ADC; i++) sim_adc_value[i] = SIM_ADC_CENTER;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    sim_sd_open();
+    sim_load_script();
+}
+
+void sim_gpio_print_stats(void) {
+    fprintf(stderr, "[sim] botoes: %u, tons do buzzer: %u, mudancas dos LEDs: %u\n",
+            sim_presses, sim_tones, sim_led_changes);
+}
+
+/*================== hardware/gpio.h ==================*/
+
+void sim_gpio_set_input(uint gpio, bool value) {
+    if (gpio >= SIM_NUM_GPIOS || sim_gpio_level[gpio] == value) return;
+    sim_gpio_level[gpio] = value;
+
+    uint32_t event = value ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    if ((sim_gpio_irq_mask[gpio] & event) && sim_gpio_callback)
+        sim_gpio_callback(gpio, event);
+}
+
+void gpio_init(uint gpio) {
+    sim_gpio_out[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    sim_gpio_out[gpio] = out;
+}
+
+void gpio_put(uint gpio, bool value) {
+    if (sim_gpio_level[gpio] != value) sim_led_changes++;
+    sim_gpio_level[gpio] = value;
+}
+
+bool gpio_get(uint gpio) {
+    return sim_gpio_level[gpio];
+}
+
+void gpio_pull_up(uint gpio) {
+    if (!sim_gpio_out[gpio]) sim_gpio_level[gpio] = true;
+}
+
+void gpio_pull_down(uint gpio) {
+    if (!sim_gpio_out[gpio]) sim_gpio_level[gpio] = false;
+}
+
+void gpio_disable_pulls(uint gpio) {
+    (void)gpio;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_set_drive_strength(uint gpio, enum gpio_drive_strength drive) {
+    (void)gpio;
+    (void)drive;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled) {
+    if (enabled) sim_gpio_irq_mask[gpio] |= events;
+    else sim_gpio_irq_mask[gpio] &= ~events;
+}
+
+void gpio_set_irq_callback(gpio_irq_callback_t callback) {
+    sim_gpio_callback = callback;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback) {
+    gpio_set_irq_enabled(gpio, events, enabled);
+    if (enabled) sim_gpio_callback = callback;
+}
+
+/*================== hardware/adc.h ==================*/
+
+void sim_adc_set(uint input, uint16_t value) {
+    if (input < SIM_NUM_ADC) sim_adc_value[input] = value;
+}
+
+void adc_init(void) {
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    sim_adc_selected = input < SIM_NUM_ADC ? input : 0;
+}
+
+uint16_t adc_read(void) {
+    sim_advance_us(2); // Uma conversão leva 96 ciclos de 48 MHz
+    return sim_adc_value[sim_adc_selected];
+}
+
+/*================== hardware/pwm.h e hardware/clocks.h ==================*/
+
+uint pwm_gpio_to_slice_num(uint gpio) {
+    return (gpio >> 1) & 7;
+}
+
+pwm_config pwm_get_default_config(void) {
+    pwm_config c = {0, 1 << 4, 0xffff};
+    return c;
+}
+
+void pwm_config_set_clkdiv(pwm_config *c, float div) {
+    c->div = (uint32_t)(div * 16);
+}
+
+void pwm_init(uint slice_num, pwm_config *c, bool start) {
+    (void)slice_num;
+    (void)c;
+    (void)start;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) {
+    (void)slice_num;
+    (void)divider;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+    (void)slice_num;
+    (void)enabled;
+}
+
+// Cada passagem de nível 0 para outro valor conta como um tom
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+    (void)gpio;
+    if (level && !sim_tone_on) sim_tones++;
+    sim_tone_on = level != 0;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    return clk_index == clk_ref ? 12000000 : 125000000;
+}
+
+/*================== stdio, bootrom e multicore ==================*/
+
+bool stdio_init_all(void) {
+    sim_init();
+    return true;
+}
+
+// Espera no máximo timeout_us pelo relógio virtual
+int getchar_timeout_us(uint32_t timeout_us) {
+    if (sim_key_count == 0 && timeout_us) sim_advance_us(timeout_us);
+    if (sim_key_count == 0) return PICO_ERROR_TIMEOUT;
+
+    char c = sim_keys[sim_key_head];
+    sim_key_head = (sim_key_head + 1) % SIM_KEY_QUEUE;
+    sim_key_count--;
+    return (unsigned char)c;
+}
+
+void reset_usb_boot(uint32_t usb_activity_gpio_pin_mask, uint32_t disable_interface_mask) {
+    (void)usb_activity_gpio_pin_mask;
+    (void)disable_interface_mask;
+    fprintf(stderr, "[sim] reset_usb_boot: modo BOOTSEL\n");
+    sim_finish(0);
+}
+
+static void sim_no_core1(void) {
+    fprintf(stderr, "[sim] o nucleo 1 nao e simulado (compile com SAMPLER_USE_CORE1=0)\n");
+    exit(1);
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    (void)entry;
+    sim_no_core1();
+}
+
+void multicore_reset_core1(void) {
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+    (void)data;
+    sim_no_core1();
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    sim_no_core1();
+    return 0;
+}
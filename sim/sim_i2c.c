@@ -0,0 +1,150 @@
+#include "sim.h"
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/sync.h"
+#include "lib/i2c_async/i2c_async.h"
+
+// Endereços dos dispositivos simulados
+#define SIM_MPU6050_ADDR 0x68
+#define SIM_SSD1306_ADDR 0x3C
+
+// Bits por byte no barramento (8 de dado + ACK) e overhead de START/endereço
+#define SIM_I2C_BITS_PER_BYTE 9
+#define SIM_I2C_OVERHEAD_BYTES 1
+
+i2c_inst_t i2c0_inst = {0, 100000};
+i2c_inst_t i2c1_inst = {1, 100000};
+spi_inst_t spi0_inst = {0};
+spi_inst_t spi1_inst = {1};
+
+static uint64_t sim_i2c_bytes[2];
+static uint32_t sim_i2c_xfers[2];
+static uint32_t sim_i2c_nacks[2];
+
+uint64_t sim_i2c_duration_us(i2c_inst_t *i2c, size_t bytes) {
+    uint64_t bits = (uint64_t)(bytes + SIM_I2C_OVERHEAD_BYTES) * SIM_I2C_BITS_PER_BYTE;
+    return (bits * 1000000 + i2c->baudrate - 1) / i2c->baudrate;
+}
+
+int sim_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx, size_t tx_len,
+                     uint8_t *rx, size_t rx_len) {
+    sim_i2c_xfers[i2c->index]++;
+    sim_i2c_bytes[i2c->index] += tx_len + rx_len;
+
+    switch (addr) {
+    case SIM_MPU6050_ADDR:
+        if (tx_len) sim_mpu6050_write(tx, tx_len);
+        if (rx_len) sim_mpu6050_read(rx, rx_len);
+        break;
+    case SIM_SSD1306_ADDR:
+        if (tx_len) sim_ssd1306_write(tx, tx_len);
+        if (rx_len) return PICO_ERROR_GENERIC;
+        break;
+    default:
+        sim_i2c_nacks[i2c->index]++;
+        return PICO_ERROR_GENERIC;
+    }
+    return (int)(tx_len + rx_len);
+}
+
+void sim_i2c_print_stats(void) {
+    for (int i = 0; i < 2; i++)
+        fprintf(stderr, "[sim] i2c%d: %u transacoes, %llu bytes, %u NACKs\n", i,
+                sim_i2c_xfers[i], (unsigned long long)sim_i2c_bytes[i], sim_i2c_nacks[i]);
+}
+
+/*================== hardware/i2c.h ==================*/
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+// A CPU fica presa durante a transação; as interrupções continuam sendo atendidas
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    sim_advance_us(sim_i2c_duration_us(i2c, len));
+    return sim_i2c_transfer(i2c, addr, src, len, NULL, 0);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    sim_advance_us(sim_i2c_duration_us(i2c, len));
+    return sim_i2c_transfer(i2c, addr, NULL, 0, dst, len);
+}
+
+/*================== lib/i2c_async ==================*/
+// Mesma fila e mesma API do motor com DMA; o fim de cada transação é um
+// alarme no instante em que o barramento terminaria de transferi-la
+
+static int64_t sim_i2c_async_done(alarm_id_t id, void *user_data);
+
+static void sim_i2c_async_start(i2c_async_t *bus) {
+    i2c_async_xfer_t *x = bus->queue[bus->head];
+    uint64_t duration = sim_i2c_duration_us(bus->i2c, (size_t)x->tx_len + x->rx_len);
+
+    // Os dados são lidos na partida, como o DMA leria os buffers
+    if (sim_i2c_transfer(bus->i2c, x->addr, x->tx, x->tx_len, x->rx, x->rx_len) < 0)
+        x->status = I2C_ASYNC_ERR_ABORT;
+    add_alarm_in_us(duration, sim_i2c_async_done, bus, true);
+}
+
+static int64_t sim_i2c_async_done(alarm_id_t id, void *user_data) {
+    i2c_async_t *bus = user_data;
+    i2c_async_xfer_t *x = bus->queue[bus->head];
+    int status = x->status;
+    (void)id;
+
+    bus->head = (bus->head + 1) % I2C_ASYNC_QUEUE_LEN;
+    bus->count--;
+    if (bus->count > 0) sim_i2c_async_start(bus);
+
+    x->busy = false;
+    if (x->done) x->done(x, status);
+    return 0;
+}
+
+void i2c_async_init(i2c_async_t *bus, i2c_inst_t *i2c) {
+    bus->i2c = i2c;
+    bus->head = 0;
+    bus->count = 0;
+}
+
+bool i2c_async_submit(i2c_async_t *bus, i2c_async_xfer_t *xfer) {
+    uint32_t len = (uint32_t)xfer->tx_len + xfer->rx_len;
+    if (len == 0 || len > I2C_ASYNC_MAX_LEN) return false;
+
+    uint32_t save = save_and_disable_interrupts();
+    if (bus->count == I2C_ASYNC_QUEUE_LEN) {
+        restore_interrupts(save);
+        return false;
+    }
+    xfer->status = I2C_ASYNC_OK;
+    xfer->busy = true;
+    bus->queue[(bus->head + bus->count) % I2C_ASYNC_QUEUE_LEN] = xfer;
+    if (bus->count++ == 0) sim_i2c_async_start(bus);
+    restore_interrupts(save);
+    return true;
+}
+
+bool i2c_async_write_read(i2c_async_t *bus, i2c_async_xfer_t *xfer, uint8_t addr,
+                          const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len,
+                          i2c_async_done_t done, void *context) {
+    xfer->addr = addr;
+    xfer->tx = tx;
+    xfer->tx_len = tx_len;
+    xfer->rx = rx;
+    xfer->rx_len = rx_len;
+    xfer->done = done;
+    xfer->context = context;
+    return i2c_async_submit(bus, xfer);
+}
+
+bool i2c_async_busy(const i2c_async_t *bus) {
+    return bus->count > 0;
+}
+
+void i2c_async_wait(const i2c_async_t *bus) {
+    while (bus->count > 0) tight_loop_contents();
+}
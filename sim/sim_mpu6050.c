@@ -0,0 +1,211 @@
+#include "sim.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Modelo do MPU6050: banco de registradores com auto-incremento, dados
+// sintéticos (senoides) e a FIFO de 1024 bytes alimentada na taxa configurada
+
+#define REG_SMPLRT_DIV   0x19
+#define REG_CONFIG       0x1A
+#define REG_FIFO_EN      0x23
+#define REG_INT_STATUS   0x3A
+#define REG_ACCEL_XOUT_H 0x3B
+#define REG_USER_CTRL    0x6A
+#define REG_PWR_MGMT_1   0x6B
+#define REG_FIFO_COUNT_H 0x72
+#define REG_FIFO_COUNT_L 0x73
+#define REG_FIFO_R_W     0x74
+#define REG_WHO_AM_I     0x75
+
+#define USER_CTRL_FIFO_EN     0x40
+#define USER_CTRL_FIFO_RESET  0x04
+#define INT_STATUS_FIFO_OFLOW 0x10
+#define PWR_MGMT_1_RESET      0x80
+#define PWR_MGMT_1_SLEEP      0x40
+
+#define SIM_MPU6050_FIFO_SIZE 1024
+#define SIM_MPU6050_RECORD    14 // accel (6), temp (2) e gyro (6)
+
+// Escalas padrão: ±2 g e ±250 °/s
+#define SIM_ACCEL_LSB_PER_G   16384.0
+#define SIM_GYRO_LSB_PER_DPS  131.0
+#define SIM_PI 3.14159265358979323846
+#define SIM_MAX_SHOCKS 16
+
+// Pulsos de aceleração (comando shock do roteiro), somados ao eixo Z
+typedef struct {
+    uint64_t start_us;
+    uint64_t end_us;
+    int32_t mg;
+} sim_shock_t;
+
+static uint8_t sim_regs[128];
+static uint8_t sim_reg_ptr;
+static uint8_t sim_fifo[SIM_MPU6050_FIFO_SIZE];
+static uint32_t sim_fifo_head;   // Próximo byte a sair
+static uint32_t sim_fifo_count;
+static uint64_t sim_fifo_next_us; // Instante do próximo registro da FIFO
+static bool sim_fifo_running;
+static sim_shock_t sim_shocks[SIM_MAX_SHOCKS];
+static uint32_t sim_shock_count;
+
+static void sim_mpu6050_reset(void) {
+    memset(sim_regs, 0, sizeof(sim_regs));
+    sim_regs[REG_PWR_MGMT_1] = PWR_MGMT_1_SLEEP;
+    sim_regs[REG_WHO_AM_I] = 0x68;
+    sim_fifo_head = 0;
+    sim_fifo_count = 0;
+    sim_fifo_running = false;
+}
+
+// Período de amostragem: 8 kHz sem filtro (DLPF 0 ou 7), senão 1 kHz, dividido por 1 + SMPLRT_DIV
+static uint64_t sim_mpu6050_period_us(void) {
+    uint8_t dlpf = sim_regs[REG_CONFIG] & 0x07;
+    uint32_t base_hz = (dlpf == 0 || dlpf == 7) ? 8000 : 1000;
+    return (uint64_t)(1 + sim_regs[REG_SMPLRT_DIV]) * 1000000 / base_hz;
+}
+
+static int16_t sim_clamp(double v) {
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)lrint(v);
+}
+
+// Amostra sintética no instante t: gravidade em Z com uma oscilação lenta em
+// X e Y, rotação periódica e temperatura de 25 °C com deriva pequena
+static void sim_mpu6050_sample(uint64_t t_us, uint8_t out[SIM_MPU6050_RECORD]) {
+    double t = t_us / 1e6;
+    int16_t v[7];
+
+    v[0] = sim_clamp(0.10 * SIM_ACCEL_LSB_PER_G * sin(2 * SIM_PI * 1.0 * t));
+    v[1] = sim_clamp(0.10 * SIM_ACCEL_LSB_PER_G * cos(2 * SIM_PI * 1.0 * t));
+    double shock_g = 0;
+    for (uint32_t i = 0; i < sim_shock_count; i++)
+        if (t_us >= sim_shocks[i].start_us && t_us < sim_shocks[i].end_us) shock_g += sim_shocks[i].mg / 1000.0;
+    v[2] = sim_clamp((1.00 + shock_g) * SIM_ACCEL_LSB_PER_G + 0.02 * SIM_ACCEL_LSB_PER_G * sin(2 * SIM_PI * 7.0 * t));
+    v[3] = sim_clamp((25.0 + 0.5 * sin(2 * SIM_PI * 0.01 * t) - 36.53) * 340.0);
+    v[4] = sim_clamp(10.0 * SIM_GYRO_LSB_PER_DPS * sin(2 * SIM_PI * 0.5 * t));
+    v[5] = sim_clamp(5.0 * SIM_GYRO_LSB_PER_DPS * cos(2 * SIM_PI * 0.5 * t));
+    v[6] = sim_clamp(2.0 * SIM_GYRO_LSB_PER_DPS * sin(2 * SIM_PI * 3.0 * t));
+
+    // Big-endian, como nos registradores do sensor
+    for (int i = 0; i < 7; i++) {
+        out[2 * i] = (uint8_t)((uint16_t)v[i] >> 8);
+        out[2 * i + 1] = (uint8_t)v[i];
+    }
+}
+
+// Coloca na FIFO os registros que o sensor teria gerado até agora.
+// Cheia, a FIFO descarta os dados mais antigos e sinaliza o transbordo
+static void sim_mpu6050_fifo_update(void) {
+    if (!sim_fifo_running) return;
+    uint64_t now = sim_now_us();
+    uint64_t period = sim_mpu6050_period_us();
+
+    while (sim_fifo_next_us <= now) {
+        uint8_t record[SIM_MPU6050_RECORD];
+        sim_mpu6050_sample(sim_fifo_next_us, record);
+        for (int i = 0; i < SIM_MPU6050_RECORD; i++) {
+            if (sim_fifo_count == SIM_MPU6050_FIFO_SIZE) {
+                sim_fifo_head = (sim_fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+                sim_fifo_count--;
+                sim_regs[REG_INT_STATUS] |= INT_STATUS_FIFO_OFLOW;
+            }
+            sim_fifo[(sim_fifo_head + sim_fifo_count++) % SIM_MPU6050_FIFO_SIZE] = record[i];
+        }
+        sim_fifo_next_us += period;
+    }
+}
+
+static void sim_mpu6050_write_reg(uint8_t reg, uint8_t value) {
+    switch (reg) {
+    case REG_PWR_MGMT_1:
+        if (value & PWR_MGMT_1_RESET) {
+            sim_mpu6050_reset();
+            return;
+        }
+        break;
+    case REG_USER_CTRL:
+        sim_mpu6050_fifo_update();
+        if (value & USER_CTRL_FIFO_RESET) {
+            sim_fifo_head = 0;
+            sim_fifo_count = 0;
+            value &= ~USER_CTRL_FIFO_RESET; // Bit se limpa sozinho
+        }
+        if ((value & USER_CTRL_FIFO_EN) && !sim_fifo_running)
+            sim_fifo_next_us = sim_now_us() + sim_mpu6050_period_us();
+        sim_fifo_running = (value & USER_CTRL_FIFO_EN) && sim_regs[REG_FIFO_EN] != 0;
+        break;
+    case REG_FIFO_EN:
+        sim_mpu6050_fifo_update();
+        if (!sim_fifo_running) sim_fifo_next_us = sim_now_us() + sim_mpu6050_period_us();
+        sim_fifo_running = (sim_regs[REG_USER_CTRL] & USER_CTRL_FIFO_EN) && value != 0;
+        break;
+    default:
+        break;
+    }
+    sim_regs[reg & 0x7F] = value;
+}
+
+static uint8_t sim_mpu6050_read_reg(uint8_t reg) {
+    uint8_t value;
+
+    switch (reg) {
+    case REG_FIFO_COUNT_H:
+        sim_mpu6050_fifo_update();
+        return (uint8_t)(sim_fifo_count >> 8);
+    case REG_FIFO_COUNT_L:
+        return (uint8_t)sim_fifo_count;
+    case REG_FIFO_R_W:
+        if (sim_fifo_count == 0) return 0;
+        value = sim_fifo[sim_fifo_head];
+        sim_fifo_head = (sim_fifo_head + 1) % SIM_MPU6050_FIFO_SIZE;
+        sim_fifo_count--;
+        return value;
+    case REG_INT_STATUS:
+        sim_mpu6050_fifo_update();
+        value = sim_regs[REG_INT_STATUS];
+        sim_regs[REG_INT_STATUS] = 0; // Limpa na leitura
+        return value;
+    default:
+        return sim_regs[reg & 0x7F];
+    }
+}
+
+// Primeiro byte: registrador; os seguintes são escritos a partir dele
+void sim_mpu6050_write(const uint8_t *src, size_t len) {
+    static bool initialized;
+    if (!initialized) {
+        sim_mpu6050_reset();
+        initialized = true;
+    }
+
+    sim_reg_ptr = src[0] & 0x7F;
+    for (size_t i = 1; i < len; i++) sim_mpu6050_write_reg(sim_reg_ptr++, src[i]);
+}
+
+void sim_mpu6050_read(uint8_t *dst, size_t len) {
+    // Os registradores de dados são copiados de uma vez, como no sensor
+    if (sim_reg_ptr >= REG_ACCEL_XOUT_H && sim_reg_ptr < REG_ACCEL_XOUT_H + SIM_MPU6050_RECORD)
+        sim_mpu6050_sample(sim_now_us(), &sim_regs[REG_ACCEL_XOUT_H]);
+
+    for (size_t i = 0; i < len; i++) {
+        dst[i] = sim_mpu6050_read_reg(sim_reg_ptr);
+        // A leitura da FIFO não avança o endereço, permitindo rajadas
+        if (sim_reg_ptr != REG_FIFO_R_W) sim_reg_ptr = (sim_reg_ptr + 1) & 0x7F;
+    }
+}
+
+// Agenda um pulso de mg no eixo Z entre at_us e at_us + duration_us
+void sim_mpu6050_shock(uint64_t at_us, uint32_t duration_us, int32_t mg) {
+    if (sim_shock_count == SIM_MAX_SHOCKS) {
+        fprintf(stderr, "[sim] pulsos demais no roteiro\n");
+        exit(1);
+    }
+    sim_shocks[sim_shock_count].start_us = at_us;
+    sim_shocks[sim_shock_count].end_us = at_us + duration_us;
+    sim_shocks[sim_shock_count].mg = mg;
+    sim_shock_count++;
+}
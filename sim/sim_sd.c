@@ -0,0 +1,388 @@
+#include "sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "pico/stdlib.h"
+#include "ff.h"
+#include "diskio.h"
+#include "hw_config.h"
+#include "my_debug.h"
+#include "rtc.h"
+#include "sd_card.h"
+
+// Cartão SD simulado sobre um arquivo de imagem (SIM_SD_IMAGE, padrão
+// sim_sd.img). Uma imagem nova, de SIM_SD_MB megabytes (padrão 64), é
+// formatada pelo próprio FatFs na primeira execução e pode ser aberta depois
+// no host (ex.: mtools ou mount -o loop) para conferir os arquivos gravados.
+// Com SIM_SD_MMAP=1 a imagem é mapeada em memória em vez de lida por pread.
+// Substitui sd_card.c/sd_spi.c/spi.c: mesma API de blocos, incluindo a fila
+// assíncrona e o modo de streaming.
+//
+// Latência: cada comando custa o overhead do comando, a transferência dos
+// blocos no SPI (na frequência do spi_t) e, nas escritas, o tempo em que o
+// cartão fica ocupado gravando. As operações síncronas prendem a CPU por esse
+// tempo; as assíncronas só terminam no sd_write_async_poll depois dele.
+// Picos periódicos simulam o apagamento/coleta de lixo interna do cartão
+
+#define SIM_SD_SECTOR 512
+#define SIM_SD_DEFAULT_MB 64
+
+// Bytes no SPI por bloco além dos dados: token de início, CRC e resposta
+#define SIM_SD_BLOCK_OVERHEAD 4
+
+// Parâmetros do modelo de latência (variáveis de ambiente SIM_SD_*)
+typedef struct {
+    uint32_t cmd_us;          // SIM_SD_CMD_US: comando, resposta R1 e espera do token
+    uint32_t read_us;         // SIM_SD_READ_US: acesso antes do primeiro bloco lido
+    uint32_t busy_us;         // SIM_SD_BUSY_US: ocupado após cada comando de escrita
+    uint32_t block_busy_us;   // SIM_SD_BLOCK_BUSY_US: ocupado a mais por bloco escrito
+    uint32_t spi_hz;          // SIM_SD_SPI_HZ: 0 usa o baud_rate do spi_t
+    uint32_t spike_every;     // SIM_SD_SPIKE_EVERY: a cada N escritas (0: sem picos)
+    uint32_t spike_us;        // SIM_SD_SPIKE_US: ocupado a mais no pico
+} sim_sd_timing_t;
+
+static sim_sd_timing_t sim_sd_timing = {
+    .cmd_us = 50,
+    .read_us = 300,
+    .busy_us = 800,
+    .block_busy_us = 20,
+    .spi_hz = 0,
+    .spike_every = 0,
+    .spike_us = 100000,
+};
+
+static int sim_sd_fd = -1;
+static uint8_t *sim_sd_map;         // Imagem mapeada (SIM_SD_MMAP=1)
+static uint64_t sim_sd_sectors;
+static bool sim_sd_fresh;           // Imagem criada nesta execução
+static bool sim_sd_untimed;         // Formatação inicial: fora do modelo de latência
+
+static uint64_t sim_sd_read_ops, sim_sd_read_sectors;
+static uint64_t sim_sd_write_ops, sim_sd_write_sectors;
+static uint64_t sim_sd_async_ops, sim_sd_stream_ops, sim_sd_spikes;
+static uint64_t sim_sd_busy_total_us;   // Tempo total modelado do cartão
+static uint32_t sim_sd_max_read_us, sim_sd_max_write_us;
+
+static uint32_t sim_sd_env(const char *name, uint32_t fallback) {
+    const char *value = getenv(name);
+    return value ? (uint32_t)strtoul(value, NULL, 0) : fallback;
+}
+
+void sim_sd_open(void) {
+    const char *path = getenv("SIM_SD_IMAGE");
+    const char *mb = getenv("SIM_SD_MB");
+    if (!path) path = "sim_sd.img";
+
+    sim_sd_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (sim_sd_fd < 0) {
+        fprintf(stderr, "[sim] nao foi possivel abrir a imagem %s\n", path);
+        exit(1);
+    }
+
+    struct stat st;
+    fstat(sim_sd_fd, &st);
+    if (st.st_size == 0) {
+        uint64_t size = (uint64_t)(mb ? atoi(mb) : SIM_SD_DEFAULT_MB) << 20;
+        if (ftruncate(sim_sd_fd, (off_t)size) != 0) {
+            fprintf(stderr, "[sim] nao foi possivel criar a imagem %s\n", path);
+            exit(1);
+        }
+        st.st_size = (off_t)size;
+        sim_sd_fresh = true;
+    }
+    sim_sd_sectors = (uint64_t)st.st_size / SIM_SD_SECTOR;
+
+    if (sim_sd_env("SIM_SD_MMAP", 0)) {
+        void *map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, sim_sd_fd, 0);
+        if (map == MAP_FAILED) fprintf(stderr, "[sim] mmap falhou, usando pread/pwrite\n");
+        else sim_sd_map = map;
+    }
+
+    sim_sd_timing_t *t = &sim_sd_timing;
+    t->cmd_us = sim_sd_env("SIM_SD_CMD_US", t->cmd_us);
+    t->read_us = sim_sd_env("SIM_SD_READ_US", t->read_us);
+    t->busy_us = sim_sd_env("SIM_SD_BUSY_US", t->busy_us);
+    t->block_busy_us = sim_sd_env("SIM_SD_BLOCK_BUSY_US", t->block_busy_us);
+    t->spi_hz = sim_sd_env("SIM_SD_SPI_HZ", t->spi_hz);
+    t->spike_every = sim_sd_env("SIM_SD_SPIKE_EVERY", t->spike_every);
+    t->spike_us = sim_sd_env("SIM_SD_SPIKE_US", t->spike_us);
+
+    fprintf(stderr, "[sim] cartao SD: %s, %llu setores%s; comando %u us, leitura %u us, "
+            "ocupado %u us + %u us/bloco, picos de %u us a cada %u escritas\n",
+            path, (unsigned long long)sim_sd_sectors, sim_sd_map ? " (mmap)" : "",
+            t->cmd_us, t->read_us, t->busy_us, t->block_busy_us, t->spike_us, t->spike_every);
+
+    // Imagem nova: formata como um cartão vindo de fábrica
+    if (sim_sd_fresh) {
+        sim_sd_untimed = true;
+        FRESULT fr = f_mkfs(sd_get_by_num(0)->pcName, NULL, NULL, FF_MAX_SS * 4);
+        if (fr != FR_OK) fprintf(stderr, "[sim] f_mkfs falhou (%d)\n", fr);
+        sim_sd_untimed = false;
+    }
+}
+
+void sim_sd_close(void) {
+    if (sim_sd_map) {
+        msync(sim_sd_map, sim_sd_sectors * SIM_SD_SECTOR, MS_SYNC);
+        munmap(sim_sd_map, sim_sd_sectors * SIM_SD_SECTOR);
+        sim_sd_map = NULL;
+    }
+    if (sim_sd_fd >= 0) close(sim_sd_fd);
+    sim_sd_fd = -1;
+}
+
+void sim_sd_print_stats(void) {
+    fprintf(stderr, "[sim] sd: %llu leituras (%llu setores), %llu escritas (%llu setores), "
+            "%llu assincronas, %llu em streaming\n",
+            (unsigned long long)sim_sd_read_ops, (unsigned long long)sim_sd_read_sectors,
+            (unsigned long long)sim_sd_write_ops, (unsigned long long)sim_sd_write_sectors,
+            (unsigned long long)sim_sd_async_ops, (unsigned long long)sim_sd_stream_ops);
+    fprintf(stderr, "[sim] sd: cartao ocupado %.3f s, pior leitura %u us, pior escrita %u us, %llu picos\n",
+            sim_sd_busy_total_us / 1e6, sim_sd_max_read_us, sim_sd_max_write_us,
+            (unsigned long long)sim_sd_spikes);
+}
+
+/*================== Modelo de latência ==================*/
+
+static uint32_t sim_sd_transfer_us(sd_card_t *sd, uint32_t count) {
+    uint32_t hz = sim_sd_timing.spi_hz ? sim_sd_timing.spi_hz : sd->spi->baud_rate;
+    uint64_t bits = (uint64_t)count * (SIM_SD_SECTOR + SIM_SD_BLOCK_OVERHEAD) * 8;
+    return hz ? (uint32_t)((bits * 1000000 + hz - 1) / hz) : 0;
+}
+
+static uint32_t sim_sd_read_latency(sd_card_t *sd, uint32_t count) {
+    sim_sd_timing_t *t = &sim_sd_timing;
+    if (sim_sd_untimed) return 0;
+    uint32_t us = t->cmd_us + t->read_us + sim_sd_transfer_us(sd, count);
+    if (us > sim_sd_max_read_us) sim_sd_max_read_us = us;
+    sim_sd_busy_total_us += us;
+    return us;
+}
+
+// Dentro de um CMD25 aberto não há comando nem 'Stop Tran': só dados e programação
+static uint32_t sim_sd_write_latency(sd_card_t *sd, uint32_t count, bool streamed) {
+    sim_sd_timing_t *t = &sim_sd_timing;
+    if (sim_sd_untimed) return 0;
+    uint32_t us = sim_sd_transfer_us(sd, count) + count * t->block_busy_us;
+    if (!streamed) us += t->cmd_us + t->busy_us;
+
+    static uint32_t writes;
+    if (t->spike_every && ++writes % t->spike_every == 0) {
+        us += t->spike_us;
+        sim_sd_spikes++;
+    }
+    if (us > sim_sd_max_write_us) sim_sd_max_write_us = us;
+    sim_sd_busy_total_us += us;
+    return us;
+}
+
+/*================== Acesso aos setores ==================*/
+
+static int sim_sd_io(bool write, uint8_t *buffer, uint64_t sector, uint32_t count) {
+    if (sim_sd_fd < 0) return SD_BLOCK_DEVICE_ERROR_NO_DEVICE;
+    if (sector + count > sim_sd_sectors) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+
+    size_t len = (size_t)count * SIM_SD_SECTOR;
+    off_t offset = (off_t)(sector * SIM_SD_SECTOR);
+    if (sim_sd_map) {
+        if (write) memcpy(sim_sd_map + offset, buffer, len);
+        else memcpy(buffer, sim_sd_map + offset, len);
+    } else {
+        ssize_t n = write ? pwrite(sim_sd_fd, buffer, len, offset) : pread(sim_sd_fd, buffer, len, offset);
+        if (n != (ssize_t)len) return write ? SD_BLOCK_DEVICE_ERROR_WRITE : SD_BLOCK_DEVICE_ERROR_NO_RESPONSE;
+    }
+
+    if (write) {
+        sim_sd_write_ops++;
+        sim_sd_write_sectors += count;
+    } else {
+        sim_sd_read_ops++;
+        sim_sd_read_sectors += count;
+    }
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+// Fecha o CMD25 aberto: 'Stop Tran' e a programação final
+static void sim_sd_stream_close(sd_card_t *sd) {
+    if (!sd->stream.open) return;
+    sd->stream.open = false;
+    sim_sd_busy_total_us += sim_sd_timing.busy_us;
+    sim_advance_us(sim_sd_timing.busy_us);
+}
+
+// Gravações em streaming: sequenciais dentro da região armada.
+// Retorna true se a escrita continua um CMD25 já aberto
+static bool sim_sd_stream_account(sd_card_t *sd, uint64_t sector, uint32_t count) {
+    sd_stream_t *s = &sd->stream;
+    bool inside = s->armed && sector >= s->start && sector + count <= s->end;
+
+    if (s->open && (!inside || sector != s->next)) sim_sd_stream_close(sd);
+    if (!inside) return false;
+
+    bool continued = s->open;
+    s->open = true;
+    s->next = sector + count;
+    sim_sd_stream_ops++;
+    return continued;
+}
+
+static int sim_sd_read_blocks(sd_card_t *sd, uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_write_async_wait(sd);
+    sim_sd_stream_close(sd);
+    sim_advance_us(sim_sd_read_latency(sd, count));
+    return sim_sd_io(false, buffer, sector, count);
+}
+
+static int sim_sd_write_blocks(sd_card_t *sd, const uint8_t *buffer, uint64_t sector, uint32_t count) {
+    sd_write_async_wait(sd);
+    bool streamed = sim_sd_stream_account(sd, sector, count);
+    sim_advance_us(sim_sd_write_latency(sd, count, streamed));
+    return sim_sd_io(true, (uint8_t *)buffer, sector, count);
+}
+
+static int sim_sd_init_card(sd_card_t *sd) {
+    if (sim_sd_fd < 0) {
+        sd->m_Status |= STA_NOINIT | STA_NODISK;
+        return sd->m_Status;
+    }
+    sd->sectors = sim_sd_sectors;
+    sd->m_Status &= ~(STA_NOINIT | STA_NODISK);
+    return sd->m_Status;
+}
+
+/*================== sd_card.h ==================*/
+
+bool sd_init_driver() {
+    static bool initialized;
+    if (initialized) return true;
+
+    for (size_t i = 0; i < sd_get_num(); i++) {
+        sd_card_t *sd = sd_get_by_num(i);
+        sd->m_Status = STA_NOINIT;
+        sd->init = sim_sd_init_card;
+        sd->read_blocks = sim_sd_read_blocks;
+        sd->write_blocks = sim_sd_write_blocks;
+    }
+    initialized = true;
+    return true;
+}
+
+bool sd_card_detect(sd_card_t *sd) {
+    if (sim_sd_fd < 0) {
+        sd->m_Status |= STA_NODISK;
+        return false;
+    }
+    sd->m_Status &= ~STA_NODISK;
+    return true;
+}
+
+uint64_t sd_sectors(sd_card_t *sd) {
+    (void)sd;
+    return sim_sd_sectors;
+}
+
+// Inicia a requisição da cabeça da fila: o DMA e a programação correm em paralelo com a CPU
+static void sim_sd_async_start(sd_card_t *sd) {
+    sd_async_t *a = &sd->async;
+    sd_async_request_t *r = &a->queue[a->head];
+    bool streamed = sim_sd_stream_account(sd, r->sector, r->count);
+    a->deadline = sim_now_us() + sim_sd_write_latency(sd, r->count, streamed);
+}
+
+int sd_write_blocks_async(sd_card_t *sd, const uint8_t *buffer, uint64_t sector, uint32_t count,
+                          sd_write_done_t done, void *context) {
+    sd_async_t *a = &sd->async;
+    if (count == 0 || sector + count > sim_sd_sectors) return SD_BLOCK_DEVICE_ERROR_PARAMETER;
+    if (a->count == SD_ASYNC_QUEUE_LEN) return SD_BLOCK_DEVICE_ERROR_WOULD_BLOCK;
+
+    sd_async_request_t *r = &a->queue[(a->head + a->count) % SD_ASYNC_QUEUE_LEN];
+    r->buffer = buffer;
+    r->sector = sector;
+    r->count = count;
+    r->done = done;
+    r->context = context;
+    if (a->count++ == 0) sim_sd_async_start(sd);
+    sim_sd_async_ops++;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+// A requisição ativa termina quando o prazo do modelo passa
+bool sd_write_async_poll(sd_card_t *sd) {
+    sd_async_t *a = &sd->async;
+    if (a->count == 0) return true;
+    if (time_us_64() < a->deadline) return false;
+
+    sd_async_request_t r = a->queue[a->head];
+    int status = sim_sd_io(true, (uint8_t *)r.buffer, r.sector, r.count);
+
+    a->head = (a->head + 1) % SD_ASYNC_QUEUE_LEN;
+    a->count--;
+    a->last_status = status;
+    if (a->count > 0) sim_sd_async_start(sd);
+    if (r.done) r.done(sd, r.buffer, status, r.context);
+    return a->count == 0;
+}
+
+// Espera sem girar: o relógio salta até o fim da requisição ativa
+int sd_write_async_wait(sd_card_t *sd) {
+    sd_async_t *a = &sd->async;
+    while (!sd_write_async_poll(sd)) {
+        uint64_t now = sim_now_us();
+        if (a->deadline > now) sim_advance_us(a->deadline - now);
+    }
+    return a->last_status;
+}
+
+uint32_t sd_write_async_pending(sd_card_t *sd) {
+    return sd->async.count;
+}
+
+int sd_stream_begin(sd_card_t *sd, uint64_t sector, uint32_t count) {
+    sd_stream_t *s = &sd->stream;
+    s->armed = true;
+    s->open = false;
+    s->bounded = count != 0;
+    s->start = sector;
+    s->end = count ? sector + count : sim_sd_sectors;
+    s->next = sector;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_stream_sync(sd_card_t *sd) {
+    sd_write_async_wait(sd);
+    sim_sd_stream_close(sd);
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+int sd_stream_end(sd_card_t *sd) {
+    sd_stream_sync(sd);
+    sd->stream.armed = false;
+    return SD_BLOCK_DEVICE_ERROR_NONE;
+}
+
+/*================== Relógio do FatFs e depuração ==================*/
+
+// Sem RTC: todos os arquivos com a data fixa de 01/01/2025 00:00
+DWORD get_fattime(void) {
+    return ((DWORD)(2025 - 1980) << 25) | ((DWORD)1 << 21) | ((DWORD)1 << 16);
+}
+
+void time_init() {
+}
+
+void my_printf(const char *pcFormat, ...) {
+    va_list args;
+    va_start(args, pcFormat);
+    vprintf(pcFormat, args);
+    va_end(args);
+}
+
+void my_assert_func(const char *file, int line, const char *func, const char *pred) {
+    fprintf(stderr, "[sim] assercao falhou: %s (%s:%d, %s)\n", pred, file, line, func);
+    abort();
+}
@@ -0,0 +1,173 @@
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Modelo do controlador SSD1306 128x64: interpreta os bytes de controle
+// (0x80, 0x00, 0x40, 0xC0), os comandos de janela e de modo de endereçamento
+// e grava a GDDRAM. A imagem vai para um PBM (SIM_OLED) a cada escrita de
+// dados e, no fim, para o terminal
+
+#define SIM_OLED_WIDTH 128
+#define SIM_OLED_PAGES 8
+
+static uint8_t sim_gddram[SIM_OLED_PAGES][SIM_OLED_WIDTH];
+static uint8_t sim_col_start, sim_col_end = SIM_OLED_WIDTH - 1;
+static uint8_t sim_page_start, sim_page_end = SIM_OLED_PAGES - 1;
+static uint8_t sim_col, sim_page;
+static uint8_t sim_mode = 2;        // Endereçamento por página após o reset
+static bool sim_display_on;
+static bool sim_inverted;
+
+// Comando com argumentos em andamento
+static uint8_t sim_cmd;
+static uint8_t sim_args[2];
+static uint8_t sim_args_needed, sim_args_got;
+
+static uint32_t sim_data_writes;
+static uint64_t sim_data_bytes;
+
+static uint8_t sim_command_args(uint8_t cmd) {
+    switch (cmd) {
+    case 0x21: case 0x22:
+        return 2;
+    case 0x20: case 0x81: case 0xA8: case 0xD3: case 0xDA: case 0xD5: case 0xD9: case 0xDB: case 0x8D:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void sim_execute(uint8_t cmd, const uint8_t *args) {
+    switch (cmd) {
+    case 0x20:
+        sim_mode = args[0] & 0x03;
+        break;
+    case 0x21:
+        sim_col_start = args[0] & 0x7F;
+        sim_col_end = args[1] & 0x7F;
+        sim_col = sim_col_start;
+        break;
+    case 0x22:
+        sim_page_start = args[0] & 0x07;
+        sim_page_end = args[1] & 0x07;
+        sim_page = sim_page_start;
+        break;
+    case 0xA6: case 0xA7:
+        sim_inverted = cmd & 1;
+        break;
+    case 0xAE: case 0xAF:
+        sim_display_on = cmd & 1;
+        break;
+    default:
+        if (cmd >= 0xB0 && cmd <= 0xB7) sim_page = cmd & 0x07;           // Página (modo página)
+        else if (cmd <= 0x0F) sim_col = (sim_col & 0xF0) | cmd;          // Coluna, nibble baixo
+        else if (cmd >= 0x10 && cmd <= 0x1F) sim_col = (sim_col & 0x0F) | ((cmd & 0x0F) << 4);
+        break;
+    }
+}
+
+static void sim_command_byte(uint8_t b) {
+    if (sim_args_needed > sim_args_got) {
+        sim_args[sim_args_got++] = b;
+        if (sim_args_got == sim_args_needed) {
+            sim_execute(sim_cmd, sim_args);
+            sim_args_needed = 0;
+        }
+        return;
+    }
+    sim_cmd = b;
+    sim_args_needed = sim_command_args(b);
+    sim_args_got = 0;
+    if (sim_args_needed == 0) sim_execute(b, NULL);
+}
+
+// Grava um byte na posição atual e avança conforme o modo de endereçamento
+static void sim_data_byte(uint8_t b) {
+    sim_gddram[sim_page & 7][sim_col & 0x7F] = b;
+    sim_data_bytes++;
+
+    if (sim_mode == 0) {          // Horizontal
+        if (sim_col++ >= sim_col_end) {
+            sim_col = sim_col_start;
+            sim_page = sim_page >= sim_page_end ? sim_page_start : sim_page + 1;
+        }
+    } else if (sim_mode == 1) {   // Vertical
+        if (sim_page++ >= sim_page_end) {
+            sim_page = sim_page_start;
+            sim_col = sim_col >= sim_col_end ? sim_col_start : sim_col + 1;
+        }
+    } else {                      // Página
+        sim_col = (sim_col + 1) & 0x7F;
+    }
+}
+
+void sim_ssd1306_write(const uint8_t *src, size_t len) {
+    size_t i = 0;
+    bool data = false;
+
+    while (i < len) {
+        uint8_t control = src[i++];
+        if (i >= len) break;
+        data = control & 0x40;
+        if (control & 0x80) {
+            // Co = 1: só o próximo byte, depois vem outro byte de controle
+            if (data) sim_data_byte(src[i++]);
+            else sim_command_byte(src[i++]);
+            continue;
+        }
+        // Co = 0: todo o resto da transação é do mesmo tipo
+        while (i < len) {
+            if (data) sim_data_byte(src[i++]);
+            else sim_command_byte(src[i++]);
+        }
+    }
+    if (data) {
+        sim_data_writes++;
+        if (getenv("SIM_OLED")) sim_ssd1306_dump();
+    }
+}
+
+static bool sim_pixel(int x, int y) {
+    bool on = (sim_gddram[y >> 3][x] >> (y & 7)) & 1;
+    return sim_display_on && (on != sim_inverted);
+}
+
+// PBM binário (P4); pixel aceso = preto no arquivo
+void sim_ssd1306_dump(void) {
+    const char *path = getenv("SIM_OLED");
+    if (!path) return;
+
+    FILE *f = fopen(path, "wb");
+    if (!f) return;
+    fprintf(f, "P4\n%d %d\n", SIM_OLED_WIDTH, SIM_OLED_PAGES * 8);
+    for (int y = 0; y < SIM_OLED_PAGES * 8; y++) {
+        for (int x = 0; x < SIM_OLED_WIDTH; x += 8) {
+            uint8_t b = 0;
+            for (int k = 0; k < 8; k++) b |= sim_pixel(x + k, y) << (7 - k);
+            fputc(b, f);
+        }
+    }
+    fclose(f);
+}
+
+// Duas linhas de pixels por linha de texto
+void sim_ssd1306_print_stats(void) {
+    static const char glyph[4] = {' ', '\'', '.', ':'};
+
+    fprintf(stderr, "[sim] display: %u escritas de dados, %llu bytes\n",
+            sim_data_writes, (unsigned long long)sim_data_bytes);
+    fprintf(stderr, "+%.*s+\n", SIM_OLED_WIDTH,
+            "--------------------------------------------------------------------------------"
+            "------------------------------------------------");
+    for (int y = 0; y < SIM_OLED_PAGES * 8; y += 2) {
+        char line[SIM_OLED_WIDTH + 1];
+        for (int x = 0; x < SIM_OLED_WIDTH; x++)
+            line[x] = glyph[sim_pixel(x, y) | (sim_pixel(x, y + 1) << 1)];
+        line[SIM_OLED_WIDTH] = '\0';
+        fprintf(stderr, "|%s|\n", line);
+    }
+    fprintf(stderr, "+%.*s+\n", SIM_OLED_WIDTH,
+            "--------------------------------------------------------------------------------"
+            "------------------------------------------------");
+}
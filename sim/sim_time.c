@@ -0,0 +1,302 @@
+#include "sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Alarmes simultâneos (timers do firmware, tons, padrões de LED e roteiro)
+#define SIM_MAX_TIMERS 32
+
+// Custo de cada leitura do relógio: sem isso, laços de espera que só
+// consultam o tempo nunca terminariam
+#define SIM_CLOCK_STEP_US 1
+
+// Sem alarmes pendentes, um __wfe dorme até este limite
+#define SIM_IDLE_STEP_US 1000
+
+typedef struct {
+    bool active;
+    bool firing;                // Callback em execução: o slot não pode ser reusado
+    alarm_id_t id;
+    uint64_t due_us;            // Instante de disparo
+    alarm_callback_t alarm;     // Alarme simples...
+    repeating_timer_t *timer;   // ...ou temporizador repetitivo
+    void *user_data;
+} sim_timer_t;
+
+static sim_timer_t sim_timers[SIM_MAX_TIMERS];
+static alarm_id_t sim_next_id = 1;
+static uint64_t sim_time_us;
+static uint32_t sim_irq_disabled;   // Aninhamento de save_and_disable_interrupts
+static bool sim_irq_active;         // Dentro de um callback
+static bool sim_event;              // Registrador de eventos do __sev/__wfe
+static uint64_t sim_irq_count;
+static struct timespec sim_wall_start;
+static struct alarm_pool { int unused; } sim_default_pool;
+
+static sim_timer_t *sim_find(alarm_id_t id) {
+    for (int i = 0; i < SIM_MAX_TIMERS; i++)
+        if (sim_timers[i].active && sim_timers[i].id == id) return &sim_timers[i];
+    return NULL;
+}
+
+static sim_timer_t *sim_alloc(uint64_t due_us) {
+    if (sim_wall_start.tv_sec == 0) clock_gettime(CLOCK_MONOTONIC, &sim_wall_start);
+    for (int i = 0; i < SIM_MAX_TIMERS; i++) {
+        sim_timer_t *t = &sim_timers[i];
+        if (t->active || t->firing) continue;
+        t->active = true;
+        t->id = sim_next_id++;
+        t->due_us = due_us;
+        t->alarm = NULL;
+        t->timer = NULL;
+        t->user_data = NULL;
+        return t;
+    }
+    fprintf(stderr, "[sim] sem alarmes livres\n");
+    return NULL;
+}
+
+// Alarme ativo mais próximo com vencimento até limit
+static sim_timer_t *sim_next_due(uint64_t limit) {
+    sim_timer_t *next = NULL;
+    for (int i = 0; i < SIM_MAX_TIMERS; i++) {
+        sim_timer_t *t = &sim_timers[i];
+        if (t->active && t->due_us <= limit && (!next || t->due_us < next->due_us)) next = t;
+    }
+    return next;
+}
+
+// Executa o callback como se fosse a interrupção do alarme e reagenda
+static void sim_fire(sim_timer_t *t) {
+    sim_irq_active = true;
+    t->firing = true;
+    sim_irq_count++;
+
+    if (t->timer) {
+        repeating_timer_t *rt = t->timer;
+        bool keep = rt->callback(rt);
+        if (keep && t->active) {
+            // Atraso negativo: período contado do disparo anterior
+            t->due_us = rt->delay_us < 0 ? t->due_us - rt->delay_us : sim_time_us + rt->delay_us;
+        } else {
+            t->active = false;
+        }
+    } else {
+        int64_t r = t->alarm(t->id, t->user_data);
+        if (!t->active) {
+            // Cancelado dentro do próprio callback
+        } else if (r < 0) {
+            t->due_us -= r;
+        } else if (r > 0) {
+            t->due_us = sim_time_us + r;
+        } else {
+            t->active = false;
+        }
+    }
+
+    t->firing = false;
+    sim_irq_active = false;
+    sim_event = true; // A saída da interrupção acorda o __wfe
+}
+
+// Atende os alarmes vencidos, se as interrupções permitirem
+static void sim_service(void) {
+    if (sim_irq_active || sim_irq_disabled) return;
+    sim_timer_t *t;
+    while ((t = sim_next_due(sim_time_us)) != NULL) sim_fire(t);
+}
+
+uint64_t sim_now_us(void) {
+    return sim_time_us;
+}
+
+bool sim_in_irq(void) {
+    return sim_irq_active;
+}
+
+void sim_advance_us(uint64_t us) {
+    uint64_t target = sim_time_us + us;
+
+    // Dispara os alarmes no instante de cada um, em ordem
+    if (!sim_irq_active && !sim_irq_disabled) {
+        sim_timer_t *t;
+        while ((t = sim_next_due(target)) != NULL) {
+            if (t->due_us > sim_time_us) sim_time_us = t->due_us;
+            sim_fire(t);
+        }
+    }
+    if (target > sim_time_us) sim_time_us = target;
+}
+
+void sim_finish(int code) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double wall = (now.tv_sec - sim_wall_start.tv_sec) + (now.tv_nsec - sim_wall_start.tv_nsec) / 1e9;
+    double virt = sim_time_us / 1e6;
+
+    fflush(stdout);
+    fprintf(stderr, "[sim] tempo virtual %.3f s, tempo real %.3f s (%.0fx), %llu interrupcoes\n",
+            virt, wall, wall > 0 ? virt / wall : 0.0, (unsigned long long)sim_irq_count);
+    sim_gpio_print_stats();
+    sim_i2c_print_stats();
+    sim_ssd1306_print_stats();
+    sim_sd_print_stats();
+    sim_ssd1306_dump();
+    sim_sd_close();
+    exit(code);
+}
+
+/*================== pico/time.h ==================*/
+
+absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+absolute_time_t make_timeout_time_us(uint64_t us) {
+    return time_us_64() + us;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms) {
+    return time_us_64() + (uint64_t)ms * 1000;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) {
+    return (int64_t)(to - from);
+}
+
+void sleep_us(uint64_t us) {
+    sim_advance_us(us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sim_advance_us((uint64_t)ms * 1000);
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)fire_if_past;
+    sim_timer_t *t = sim_alloc(sim_time_us + us);
+    if (!t) return -1;
+    t->alarm = callback;
+    t->user_data = user_data;
+    return t->id;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id) {
+    sim_timer_t *t = sim_find(alarm_id);
+    if (!t) return false;
+    t->active = false;
+    return true;
+}
+
+bool add_repeating_timer_us(int64_t delay_us, repeating_timer_callback_t callback, void *user_data,
+                            repeating_timer_t *out) {
+    uint64_t period = delay_us < 0 ? (uint64_t)-delay_us : (uint64_t)delay_us;
+    sim_timer_t *t = sim_alloc(sim_time_us + period);
+    if (!t) return false;
+    out->delay_us = delay_us;
+    out->pool = &sim_default_pool;
+    out->alarm_id = t->id;
+    out->callback = callback;
+    out->user_data = user_data;
+    t->timer = out;
+    return true;
+}
+
+bool add_repeating_timer_ms(int32_t delay_ms, repeating_timer_callback_t callback, void *user_data,
+                            repeating_timer_t *out) {
+    return add_repeating_timer_us((int64_t)delay_ms * 1000, callback, user_data, out);
+}
+
+bool cancel_repeating_timer(repeating_timer_t *timer) {
+    return cancel_alarm(timer->alarm_id);
+}
+
+alarm_pool_t *alarm_pool_create_with_unused_hardware_alarm(uint max_timers) {
+    (void)max_timers;
+    return &sim_default_pool;
+}
+
+bool alarm_pool_add_repeating_timer_us(alarm_pool_t *pool, int64_t delay_us, repeating_timer_callback_t callback,
+                                       void *user_data, repeating_timer_t *out) {
+    (void)pool;
+    return add_repeating_timer_us(delay_us, callback, user_data, out);
+}
+
+/*================== hardware/timer.h ==================*/
+
+uint64_t time_us_64(void) {
+    sim_time_us += SIM_CLOCK_STEP_US;
+    sim_service();
+    return sim_time_us;
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+void busy_wait_us(uint64_t delay_us) {
+    sim_advance_us(delay_us);
+}
+
+void busy_wait_us_32(uint32_t delay_us) {
+    sim_advance_us(delay_us);
+}
+
+/*================== pico/platform.h ==================*/
+
+uint get_core_num(void) {
+    return 0;
+}
+
+void tight_loop_contents(void) {
+    time_us_64();
+}
+
+/*================== hardware/sync.h ==================*/
+
+void __dmb(void) {
+}
+
+void __sev(void) {
+    sim_event = true;
+}
+
+// Dorme até o próximo alarme (ou um __sev já pendente)
+void __wfe(void) {
+    if (!sim_event) {
+        sim_timer_t *next = sim_next_due(UINT64_MAX);
+        uint64_t step = SIM_IDLE_STEP_US;
+        if (next && !sim_irq_disabled) step = next->due_us > sim_time_us ? next->due_us - sim_time_us : 0;
+        sim_advance_us(step);
+    }
+    sim_event = false;
+}
+
+void __wfi(void) {
+    __wfe();
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    sim_irq_disabled++;
+    return 0;
+}
+
+void restore_interrupts(uint32_t status) {
+    (void)status;
+    if (sim_irq_disabled > 0) sim_irq_disabled--;
+    sim_service();
+}
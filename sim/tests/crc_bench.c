@@ -0,0 +1,65 @@
+#include "test.h"
+#include "lib/sd/FatFs_SPI/sd_driver/crc.h"
+
+// CRC16 de blocos de 512 bytes (um setor do SD): slice-by-8 do driver contra
+// a tabela byte a byte usada antes e contra o cálculo bit a bit
+
+#define BENCH_BLOCKS 200000u
+#define BLOCK 512
+
+static unsigned short table[256];
+static unsigned char block[BLOCK];
+
+static void init_table(void) {
+    for (int b = 0; b < 256; b++) {
+        unsigned short crc = (unsigned short)(b << 8);
+        for (int i = 0; i < 8; i++)
+            crc = (crc & 0x8000) ? (unsigned short)((crc << 1) ^ 0x1021) : (unsigned short)(crc << 1);
+        table[b] = crc;
+    }
+}
+
+static unsigned short crc16_bytewise(const char *data, int length) {
+    unsigned short crc = 0;
+    for (int i = 0; i < length; i++)
+        crc = (unsigned short)((crc << 8) ^ table[((crc >> 8) ^ data[i]) & 0x00FF]);
+    return crc;
+}
+
+static unsigned short crc16_bitwise(const char *data, int length) {
+    unsigned short crc = 0;
+    for (int i = 0; i < length; i++) {
+        crc ^= (unsigned short)((unsigned char)data[i] << 8);
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (unsigned short)((crc << 1) ^ 0x1021) : (unsigned short)(crc << 1);
+    }
+    return crc;
+}
+
+static double bench(unsigned short (*fn)(const char *, int), uint32_t blocks, unsigned short *sink) {
+    unsigned short acc = 0;
+    double t0 = test_now_s();
+    for (uint32_t i = 0; i < blocks; i++) {
+        block[i % BLOCK] ^= (unsigned char)acc; // Cada bloco depende do anterior
+        acc = fn((const char *)block, BLOCK);
+    }
+    *sink = acc;
+    return (test_now_s() - t0) / ((double)blocks * BLOCK) * 1e9;
+}
+
+int main(void) {
+    unsigned short a, b, c;
+
+    init_table();
+    for (int i = 0; i < BLOCK; i++) block[i] = (unsigned char)(i * 31 + 7);
+    double ns_slice = bench(crc16, BENCH_BLOCKS, &a);
+    for (int i = 0; i < BLOCK; i++) block[i] = (unsigned char)(i * 31 + 7);
+    double ns_byte = bench(crc16_bytewise, BENCH_BLOCKS, &b);
+    for (int i = 0; i < BLOCK; i++) block[i] = (unsigned char)(i * 31 + 7);
+    double ns_bit = bench(crc16_bitwise, BENCH_BLOCKS / 8, &c);
+
+    printf("slice-by-8:  %6.3f ns/byte (%7.1f MB/s)\n", ns_slice, 1e3 / ns_slice);
+    printf("byte a byte: %6.3f ns/byte (%7.1f MB/s, %.1fx)\n", ns_byte, 1e3 / ns_byte, ns_byte / ns_slice);
+    printf("bit a bit:   %6.3f ns/byte (%7.1f MB/s, %.1fx)\n", ns_bit, 1e3 / ns_bit, ns_bit / ns_slice);
+    return a != b;
+}
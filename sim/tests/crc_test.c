@@ -0,0 +1,101 @@
+#include <string.h>
+#include "test.h"
+#include "lib/sd/FatFs_SPI/sd_driver/crc.h"
+
+// CRC16-CCITT (slice-by-8) e CRC7 do driver do SD contra as definições bit a
+// bit: vetores conhecidos, todos os tamanhos e alinhamentos até pouco mais
+// de um bloco e update_crc16 em pedaços
+
+#define MAX_LEN 1100
+
+// Polinômio 0x1021, valor inicial 0, MSB primeiro (sem reflexão nem XOR final)
+static unsigned short ref_crc16(unsigned short crc, const unsigned char *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (unsigned short)(data[i] << 8);
+        for (int b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (unsigned short)((crc << 1) ^ 0x1021) : (unsigned short)(crc << 1);
+    }
+    return crc;
+}
+
+// Polinômio x^7 + x^3 + 1, resultado de 7 bits (o bit 0 do byte enviado é o de fim)
+static unsigned char ref_crc7(const unsigned char *data, size_t length) {
+    unsigned char crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        for (int b = 7; b >= 0; b--) {
+            unsigned char in = ((data[i] >> b) & 1) ^ ((crc >> 6) & 1);
+            crc = (unsigned char)((crc << 1) & 0x7F);
+            if (in) crc ^= 0x09;
+        }
+    }
+    return crc;
+}
+
+static unsigned char data[MAX_LEN + 8];
+
+static void fill_random(void) {
+    uint32_t seed = 1;
+    for (size_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        data[i] = (unsigned char)(seed >> 24);
+    }
+}
+
+static void test_vectors(void) {
+    CHECK(crc16("123456789", 9) == 0x31C3);
+    CHECK(crc16("", 0) == 0);
+    CHECK(crc16("abc", -1) == 0);
+
+    // Comandos do SD: CMD0 termina em 0x95 e CMD8 (0x1AA) em 0x87
+    static const char cmd0[] = {0x40, 0x00, 0x00, 0x00, 0x00};
+    static const char cmd8[] = {0x48, 0x00, 0x00, 0x01, (char)0xAA};
+    CHECK(((crc7(cmd0, 5) << 1) | 1) == 0x95);
+    CHECK(((crc7(cmd8, 5) << 1) | 1) == 0x87);
+
+    // Bloco de 512 bytes 0xFF: CRC16 0x7FA1 (exemplo da especificação do SD)
+    static char ones[512];
+    memset(ones, 0xFF, sizeof(ones));
+    CHECK(crc16(ones, 512) == 0x7FA1);
+}
+
+// Todo tamanho de 0 a MAX_LEN em cada um dos 8 alinhamentos
+static void test_lengths(void) {
+    uint32_t mismatches = 0;
+    for (int offset = 0; offset < 8; offset++) {
+        for (int len = 0; len <= MAX_LEN; len++) {
+            const unsigned char *p = data + offset;
+            if (crc16((const char *)p, len) != ref_crc16(0, p, len)) mismatches++;
+            if (len <= 64 && (unsigned char)crc7((const char *)p, len) != ref_crc7(p, len)) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+// update_crc16 acumulado em pedaços de tamanhos variados, a partir de um
+// valor inicial qualquer
+static void test_update(void) {
+    uint32_t seed = 7, mismatches = 0;
+    for (int round = 0; round < 2000; round++) {
+        seed = seed * 1664525u + 1013904223u;
+        unsigned short start = (unsigned short)(seed >> 16);
+        unsigned short crc = start;
+        size_t pos = 0, len = 1 + (seed >> 8) % MAX_LEN;
+        while (pos < len) {
+            seed = seed * 1664525u + 1013904223u;
+            size_t chunk = (seed >> 24) % 40;
+            if (chunk > len - pos) chunk = len - pos;
+            update_crc16(&crc, (const char *)data + pos, chunk);
+            pos += chunk;
+        }
+        if (crc != ref_crc16(start, data, len)) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void) {
+    fill_random();
+    test_vectors();
+    test_lengths();
+    test_update();
+    return test_result("crc_test");
+}
@@ -0,0 +1,51 @@
+#include <string.h>
+#include "test.h"
+#include "lib/csvfmt/csvfmt.h"
+
+// Tempo por linha CSV: csvfmt_sample contra o snprintf com sete "%.2f"
+// usado antes na gravação
+
+#define BENCH_LINES 2000000u
+#define BENCH_SAMPLES 1024
+
+static sample_t samples[BENCH_SAMPLES];
+
+static void fill_samples(void) {
+    uint32_t seed = 1;
+    for (int i = 0; i < BENCH_SAMPLES; i++) {
+        int16_t *fields = &samples[i].accel[0];
+        for (int k = 0; k < 7; k++) {
+            seed = seed * 1664525u + 1013904223u;
+            fields[k] = (int16_t)(seed >> 16);
+        }
+    }
+}
+
+static int snprintf_line(char *buffer, uint32_t index, const sample_t *s) {
+    return snprintf(buffer, 100, "%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", (unsigned long)index,
+                    s->accel[0] / 16384.0f, s->accel[1] / 16384.0f, s->accel[2] / 16384.0f,
+                    s->gyro[0] / 131.0f, s->gyro[1] / 131.0f, s->gyro[2] / 131.0f,
+                    (s->temp / 340.0f) + 36.53f);
+}
+
+static double bench(int (*fn)(char *, uint32_t, const sample_t *), uint32_t *bytes) {
+    char buffer[100];
+    uint32_t total = 0;
+
+    double t0 = test_now_s();
+    for (uint32_t i = 0; i < BENCH_LINES; i++)
+        total += fn(buffer, i, &samples[i % BENCH_SAMPLES]);
+    *bytes = total;
+    return (test_now_s() - t0) / BENCH_LINES * 1e9;
+}
+
+int main(void) {
+    uint32_t bytes_csvfmt, bytes_snprintf;
+
+    fill_samples();
+    double ns_csvfmt = bench(csvfmt_sample, &bytes_csvfmt);
+    double ns_snprintf = bench(snprintf_line, &bytes_snprintf);
+    printf("csvfmt_sample: %7.1f ns por linha\n", ns_csvfmt);
+    printf("snprintf:      %7.1f ns por linha (%.1fx)\n", ns_snprintf, ns_snprintf / ns_csvfmt);
+    return bytes_csvfmt != bytes_snprintf;
+}
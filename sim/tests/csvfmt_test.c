@@ -0,0 +1,90 @@
+#include <string.h>
+#include <stdlib.h>
+#include "test.h"
+#include "lib/csvfmt/csvfmt.h"
+
+// Equivalência com o snprintf que o csvfmt substituiu: todos os valores de
+// int16 de cada campo, com as mesmas conversões em float da gravação antiga,
+// e linhas completas com índices e amostras pseudoaleatórias
+
+#define LINES_RANDOM 200000
+
+static void test_u32(void) {
+    static const uint32_t values[] = {0, 1, 9, 10, 99, 100, 12345, 999999999, 1000000000, 4294967295u};
+    char got[16], ref[16];
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        *csvfmt_u32(got, values[i]) = '\0';
+        snprintf(ref, sizeof(ref), "%lu", (unsigned long)values[i]);
+        CHECK(strcmp(got, ref) == 0);
+    }
+}
+
+// Campo formatado por fn comparado com "%.2f" de ref para todo int16
+static uint32_t compare_field(char *(*fn)(char *, int16_t), float (*ref)(int16_t), const char *name) {
+    char got[16], want[16];
+    uint32_t mismatches = 0;
+
+    for (int32_t raw = -32768; raw <= 32767; raw++) {
+        *fn(got, (int16_t)raw) = '\0';
+        snprintf(want, sizeof(want), "%.2f", ref((int16_t)raw));
+        if (strcmp(got, want) != 0) {
+            if (mismatches++ < 5) fprintf(stderr, "%s(%d): '%s', snprintf '%s'\n", name, raw, got, want);
+        }
+    }
+    return mismatches;
+}
+
+static float ref_accel(int16_t raw) { return raw / 16384.0f; }
+static float ref_gyro(int16_t raw) { return raw / 131.0f; }
+static float ref_temp(int16_t raw) { return (raw / 340.0f) + 36.53f; }
+
+static void test_fields(void) {
+    CHECK(compare_field(csvfmt_accel, ref_accel, "accel") == 0);
+    CHECK(compare_field(csvfmt_gyro, ref_gyro, "gyro") == 0);
+    CHECK(compare_field(csvfmt_temp, ref_temp, "temp") == 0);
+}
+
+static int ref_line(char *buffer, uint32_t index, const sample_t *s) {
+    return snprintf(buffer, 100, "%lu,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n", (unsigned long)index,
+                    ref_accel(s->accel[0]), ref_accel(s->accel[1]), ref_accel(s->accel[2]),
+                    ref_gyro(s->gyro[0]), ref_gyro(s->gyro[1]), ref_gyro(s->gyro[2]),
+                    ref_temp(s->temp));
+}
+
+static void random_sample(sample_t *s, uint32_t *seed) {
+    int16_t *fields[7] = {&s->accel[0], &s->accel[1], &s->accel[2], &s->gyro[0], &s->gyro[1], &s->gyro[2], &s->temp};
+    for (int i = 0; i < 7; i++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        *fields[i] = (int16_t)(*seed >> 16);
+    }
+}
+
+static void test_lines(void) {
+    char got[CSVFMT_LINE_MAX], want[100];
+    uint32_t seed = 1;
+    sample_t s;
+
+    // Linha mais longa: índice máximo e todos os campos no extremo negativo
+    s.accel[0] = s.accel[1] = s.accel[2] = -32768;
+    s.gyro[0] = s.gyro[1] = s.gyro[2] = -32768;
+    s.temp = -32768;
+    int len = csvfmt_sample(got, 4294967295u, &s);
+    CHECK(len == ref_line(want, 4294967295u, &s));
+    CHECK(len < CSVFMT_LINE_MAX && strcmp(got, want) == 0);
+
+    for (uint32_t i = 0; i < LINES_RANDOM; i++) {
+        random_sample(&s, &seed);
+        uint32_t index = i * 2654435761u;
+        len = csvfmt_sample(got, index, &s);
+        CHECK(len == ref_line(want, index, &s));
+        CHECK(strcmp(got, want) == 0);
+    }
+}
+
+int main(void) {
+    test_u32();
+    test_fields();
+    test_lines();
+    return test_result("csvfmt_test");
+}
@@ -0,0 +1,58 @@
+#ifndef FAKEHW_HARDWARE_DMA_H
+#define FAKEHW_HARDWARE_DMA_H
+
+#include "pico/types.h"
+
+// Canais de DMA do i2c_async_test: a configuração só é registrada, e o teste
+// lê dela os endereços e a contagem para fazer a transferência
+
+#define FAKE_DMA_CHANNELS 4
+
+enum dma_channel_transfer_size {
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+typedef struct {
+    enum dma_channel_transfer_size size;
+    bool read_increment;
+    bool write_increment;
+    uint dreq;
+} dma_channel_config;
+
+typedef struct {
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    bool active;     // Disparado e ainda não concluído pelo teste
+    uint32_t aborts;
+} fake_dma_channel_t;
+
+extern fake_dma_channel_t fake_dma[FAKE_DMA_CHANNELS];
+
+int dma_claim_unused_channel(bool required);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {
+    c->size = size;
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr) {
+    c->read_increment = incr;
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr) {
+    c->write_increment = incr;
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq) {
+    c->dreq = dreq;
+}
+
+#endif // FAKEHW_HARDWARE_DMA_H
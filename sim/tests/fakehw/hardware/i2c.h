@@ -0,0 +1,63 @@
+#ifndef FAKEHW_HARDWARE_I2C_H
+#define FAKEHW_HARDWARE_I2C_H
+
+#include "pico/types.h"
+
+// Registradores do controlador I2C para compilar lib/i2c_async no host
+// (i2c_async_test): os campos usados pelo motor, como memória comum, e os
+// bits com os valores do RP2040. O teste faz o papel do controlador
+
+#ifndef _u
+#define _u(x) x##u
+#endif
+
+#define I2C_IC_DATA_CMD_CMD_BITS         _u(0x00000100)
+#define I2C_IC_DATA_CMD_STOP_BITS        _u(0x00000200)
+#define I2C_IC_DATA_CMD_RESTART_BITS     _u(0x00000400)
+#define I2C_IC_INTR_STAT_R_TX_ABRT_BITS  _u(0x00000040)
+#define I2C_IC_INTR_STAT_R_STOP_DET_BITS _u(0x00000200)
+#define I2C_IC_INTR_MASK_M_TX_ABRT_BITS  _u(0x00000040)
+#define I2C_IC_INTR_MASK_M_STOP_DET_BITS _u(0x00000200)
+#define I2C_IC_DMA_CR_RDMAE_BITS         _u(0x00000001)
+#define I2C_IC_DMA_CR_TDMAE_BITS         _u(0x00000002)
+
+typedef struct {
+    io_rw_32 enable;
+    io_rw_32 tar;
+    io_rw_32 data_cmd;
+    io_rw_32 intr_stat;
+    io_rw_32 intr_mask;
+    io_rw_32 clr_tx_abrt;
+    io_rw_32 clr_stop_det;
+    io_rw_32 dma_cr;
+    io_rw_32 dma_tdlr;
+    io_rw_32 dma_rdlr;
+} i2c_hw_t;
+
+typedef struct i2c_inst {
+    uint index;
+    i2c_hw_t hw;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+static inline uint i2c_hw_index(i2c_inst_t *i2c) {
+    return i2c->index;
+}
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+    return &i2c->hw;
+}
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx) {
+    return i2c->index * 2 + (is_tx ? 0 : 1);
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+#endif // FAKEHW_HARDWARE_I2C_H
@@ -0,0 +1,16 @@
+#ifndef FAKEHW_HARDWARE_IRQ_H
+#define FAKEHW_HARDWARE_IRQ_H
+
+#include "pico/types.h"
+
+// Interrupções do i2c_async_test: o teste chama o tratador registrado
+
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif // FAKEHW_HARDWARE_IRQ_H
@@ -0,0 +1,487 @@
+#include <string.h>
+#include <math.h>
+#include "test.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "lib/i2c_async/i2c_async.h"
+#include "lib/sensors/mpu6050/mpu6050.h"
+#include "lib/sensors/bmp280/bmp280.h"
+#include "lib/sensors/ahto20/aht20.h"
+
+// Motor de I2C assíncrono contra um controlador falso (tests/fakehw): as
+// palavras de DATA_CMD que o DMA entregaria são executadas sobre dispositivos
+// de registradores, e as interrupções STOP_DET/TX_ABRT são geradas como no
+// RP2040. Cobre o formato das palavras, a fila, NACK, transações bloqueantes
+// com a fila vazia (sem interrupção) e as leituras assíncronas dos sensores
+
+/*================== HARDWARE FALSO ==================*/
+
+i2c_inst_t i2c0_inst = { .index = 0 };
+i2c_inst_t i2c1_inst = { .index = 1 };
+fake_dma_channel_t fake_dma[FAKE_DMA_CHANNELS];
+
+static uint dma_claimed;
+static irq_handler_t irq_handlers[32];
+static bool irq_enabled[32];
+static bool interrupts_off;
+static uint32_t irq_calls; // Vezes que o tratador foi chamado
+
+// Dispositivo com ponteiro de registrador (o primeiro byte escrito) e
+// incremento automático; sem ponteiro, lê a partir de regs[0]
+typedef struct {
+    uint8_t addr;
+    bool pointer;
+    bool nack;
+    uint8_t ptr;
+    uint8_t regs[256];
+    uint8_t written[16]; // Bytes da última escrita
+    uint32_t written_len;
+} device_t;
+
+static device_t devices[3];
+
+// Palavras de DATA_CMD da última transação executada
+static uint16_t last_cmd[I2C_ASYNC_MAX_LEN];
+static uint32_t last_cmd_len;
+
+// Próximo NACK: só TX_ABRT, e o STOP_DET vem numa interrupção separada
+static bool split_abort;
+
+static device_t *find_device(uint8_t addr) {
+    for (size_t i = 0; i < count_of(devices); i++)
+        if (devices[i].addr == addr && !devices[i].nack) return &devices[i];
+    return NULL;
+}
+
+static void device_write(device_t *d, const uint8_t *src, size_t len) {
+    d->written_len = len < sizeof(d->written) ? len : sizeof(d->written);
+    memcpy(d->written, src, d->written_len);
+    if (d->pointer && len > 0) {
+        d->ptr = src[0];
+        for (size_t i = 1; i < len; i++) d->regs[d->ptr++] = src[i];
+    } else {
+        d->ptr = 0;
+    }
+}
+
+// Sem ponteiro, toda transação lê a partir do início (status do AHT20)
+static void device_start(device_t *d) {
+    if (!d->pointer) d->ptr = 0;
+}
+
+static uint8_t device_read(device_t *d) {
+    return d->regs[d->ptr++];
+}
+
+static void raise_irq(i2c_inst_t *i2c, uint32_t stat) {
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    uint irq = i2c->index ? I2C1_IRQ : I2C0_IRQ;
+    if (!(hw->intr_mask & stat) || !irq_enabled[irq] || !irq_handlers[irq]) return;
+    hw->intr_stat = stat & hw->intr_mask;
+    irq_calls++;
+    irq_handlers[irq]();
+    hw->intr_stat = 0; // Limpo pelas leituras de clr_* no tratador
+}
+
+// Executa a transação cujo DMA de TX está disparado, como o controlador
+// faria, e gera as interrupções do fim. Com interrupções desabilitadas nada
+// acontece, como no núcleo que chamou save_and_disable_interrupts
+static bool controller_step(void) {
+    if (interrupts_off) return false;
+    for (uint ch = 0; ch < FAKE_DMA_CHANNELS; ch++) {
+        fake_dma_channel_t *tx = &fake_dma[ch];
+        if (!tx->active || tx->config.size != DMA_SIZE_16) continue;
+
+        i2c_inst_t *i2c = tx->config.dreq / 2 ? i2c1 : i2c0;
+        i2c_hw_t *hw = i2c_get_hw(i2c);
+        fake_dma_channel_t *rx = NULL;
+        for (uint k = 0; k < FAKE_DMA_CHANNELS; k++)
+            if (fake_dma[k].active && fake_dma[k].config.dreq == tx->config.dreq + 1) rx = &fake_dma[k];
+
+        const uint16_t *cmd = (const uint16_t *)tx->read_addr;
+        last_cmd_len = tx->count;
+        memcpy(last_cmd, cmd, tx->count * sizeof(uint16_t));
+
+        device_t *d = hw->enable ? find_device((uint8_t)hw->tar) : NULL;
+        if (!d) {
+            // NACK no endereço: o controlador aborta e os canais ficam parados
+            if (split_abort) {
+                split_abort = false;
+                raise_irq(i2c, I2C_IC_INTR_STAT_R_TX_ABRT_BITS);
+                raise_irq(i2c, I2C_IC_INTR_STAT_R_STOP_DET_BITS);
+            } else {
+                raise_irq(i2c, I2C_IC_INTR_STAT_R_TX_ABRT_BITS | I2C_IC_INTR_STAT_R_STOP_DET_BITS);
+            }
+            return true;
+        }
+
+        device_start(d);
+        uint8_t wbuf[I2C_ASYNC_MAX_LEN];
+        uint32_t wlen = 0, rcount = 0;
+        uint8_t *rdst = rx ? (uint8_t *)rx->write_addr : NULL;
+        for (uint32_t i = 0; i < tx->count; i++) {
+            if (cmd[i] & I2C_IC_DATA_CMD_CMD_BITS) {
+                if (wlen) {
+                    device_write(d, wbuf, wlen);
+                    wlen = 0;
+                }
+                if (rdst && rcount < rx->count) rdst[rcount++] = device_read(d);
+            } else {
+                wbuf[wlen++] = (uint8_t)cmd[i];
+            }
+        }
+        if (wlen) device_write(d, wbuf, wlen);
+
+        tx->active = false;
+        if (rx) rx->active = false;
+        raise_irq(i2c, I2C_IC_INTR_STAT_R_STOP_DET_BITS);
+        return true;
+    }
+    return false;
+}
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    return dma_claimed < FAKE_DMA_CHANNELS ? (int)dma_claimed++ : -1;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) {
+    (void)channel;
+    return (dma_channel_config){ .size = DMA_SIZE_32, .read_increment = true };
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    fake_dma_channel_t *c = &fake_dma[channel];
+    c->config = *config;
+    c->write_addr = write_addr;
+    c->read_addr = read_addr;
+    c->count = transfer_count;
+    c->active = trigger;
+}
+
+void dma_channel_abort(uint channel) {
+    fake_dma[channel].active = false;
+    fake_dma[channel].aborts++;
+}
+
+bool dma_channel_is_busy(uint channel) {
+    return fake_dma[channel].active;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    irq_handlers[num] = handler;
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    irq_enabled[num] = enabled;
+}
+
+uint32_t save_and_disable_interrupts(void) {
+    uint32_t save = interrupts_off;
+    interrupts_off = true;
+    return save;
+}
+
+void restore_interrupts(uint32_t status) {
+    interrupts_off = status;
+}
+
+// Espera ativa: o controlador avança enquanto a CPU aguarda
+void tight_loop_contents(void) {
+    controller_step();
+}
+
+void sleep_ms(uint32_t ms) {
+    (void)ms;
+}
+
+// As bloqueantes usam o mesmo controlador: o STOP_DET do fim chega ao
+// tratador do i2c_async se a interrupção estiver habilitada. No RP2040 o SDK
+// espera por esse bit sem timeout, então o tratador não pode consumi-lo
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    device_t *d = find_device(addr);
+    if (!d) return PICO_ERROR_GENERIC;
+    device_write(d, src, len);
+    if (!nostop) raise_irq(i2c, I2C_IC_INTR_STAT_R_STOP_DET_BITS);
+    return (int)len;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    device_t *d = find_device(addr);
+    if (!d) return PICO_ERROR_GENERIC;
+    device_start(d);
+    for (size_t i = 0; i < len; i++) dst[i] = device_read(d);
+    if (!nostop) raise_irq(i2c, I2C_IC_INTR_STAT_R_STOP_DET_BITS);
+    return (int)len;
+}
+
+/*================== TESTES ==================*/
+
+#define ADDR_MPU6050 0x68
+#define ADDR_BMP280  0x76
+#define ADDR_AHT20   0x38
+
+static i2c_async_t bus;
+
+// Registro dos callbacks, na ordem em que chegam
+static i2c_async_xfer_t *done_order[32];
+static int done_status[32];
+static uint32_t done_count;
+
+static void record_done(i2c_async_xfer_t *xfer, int status) {
+    done_order[done_count] = xfer;
+    done_status[done_count] = status;
+    done_count++;
+}
+
+static void reset_devices(void) {
+    memset(devices, 0, sizeof(devices));
+    devices[0] = (device_t){ .addr = ADDR_MPU6050, .pointer = true };
+    devices[1] = (device_t){ .addr = ADDR_BMP280, .pointer = true };
+    devices[2] = (device_t){ .addr = ADDR_AHT20, .pointer = false };
+    for (int i = 0; i < 256; i++) {
+        devices[0].regs[i] = (uint8_t)i;
+        devices[1].regs[i] = (uint8_t)(0xFF - i);
+    }
+    done_count = 0;
+}
+
+static void test_init(void) {
+    i2c_async_init(&bus, i2c0);
+    i2c_hw_t *hw = i2c_get_hw(i2c0);
+    CHECK(bus.tx_dma != bus.rx_dma);
+    CHECK(hw->dma_cr == (I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS));
+    CHECK(hw->intr_mask == 0); // Nada em andamento
+    CHECK(irq_enabled[I2C0_IRQ] && irq_handlers[I2C0_IRQ]);
+    CHECK(!i2c_async_busy(&bus));
+}
+
+// Escrita + leitura: RESTART na primeira leitura, STOP só na última palavra
+static void test_cmd_words(void) {
+    i2c_async_xfer_t x;
+    uint8_t reg = 0x3B, rx[4] = {0};
+
+    reset_devices();
+    CHECK(i2c_async_write_read(&bus, &x, ADDR_MPU6050, &reg, 1, rx, 4, record_done, NULL));
+    CHECK(x.busy && i2c_async_busy(&bus));
+    i2c_async_wait(&bus);
+    CHECK(!x.busy && x.status == I2C_ASYNC_OK);
+    CHECK(done_count == 1 && done_order[0] == &x && done_status[0] == I2C_ASYNC_OK);
+    CHECK(i2c_get_hw(i2c0)->tar == ADDR_MPU6050);
+
+    CHECK(last_cmd_len == 5);
+    CHECK(last_cmd[0] == 0x3B);
+    CHECK(last_cmd[1] == (I2C_IC_DATA_CMD_CMD_BITS | I2C_IC_DATA_CMD_RESTART_BITS));
+    CHECK(last_cmd[2] == I2C_IC_DATA_CMD_CMD_BITS);
+    CHECK(last_cmd[3] == I2C_IC_DATA_CMD_CMD_BITS);
+    CHECK(last_cmd[4] == (I2C_IC_DATA_CMD_CMD_BITS | I2C_IC_DATA_CMD_STOP_BITS));
+    CHECK(rx[0] == 0x3B && rx[3] == 0x3E);
+
+    // Só escrita: STOP no último byte, nenhum RESTART
+    uint8_t tx[3] = {0x10, 0xA5, 0x5A};
+    CHECK(i2c_async_write_read(&bus, &x, ADDR_MPU6050, tx, 3, NULL, 0, NULL, NULL));
+    i2c_async_wait(&bus);
+    CHECK(last_cmd_len == 3);
+    CHECK(last_cmd[0] == 0x10 && last_cmd[1] == 0xA5);
+    CHECK(last_cmd[2] == (0x5A | I2C_IC_DATA_CMD_STOP_BITS));
+    CHECK(devices[0].regs[0x10] == 0xA5 && devices[0].regs[0x11] == 0x5A);
+
+    // Só leitura: sem RESTART na primeira palavra
+    CHECK(i2c_async_write_read(&bus, &x, ADDR_AHT20, NULL, 0, rx, 2, NULL, NULL));
+    i2c_async_wait(&bus);
+    CHECK(last_cmd_len == 2);
+    CHECK(last_cmd[0] == I2C_IC_DATA_CMD_CMD_BITS);
+    CHECK(last_cmd[1] == (I2C_IC_DATA_CMD_CMD_BITS | I2C_IC_DATA_CMD_STOP_BITS));
+}
+
+// Fila: ordem de execução e dos callbacks, fila cheia e tamanhos inválidos
+static void test_queue(void) {
+    i2c_async_xfer_t x[I2C_ASYNC_QUEUE_LEN + 1];
+    uint8_t reg[I2C_ASYNC_QUEUE_LEN], rx[I2C_ASYNC_QUEUE_LEN][2];
+
+    reset_devices();
+    uint32_t save = save_and_disable_interrupts(); // Nada termina enquanto enfileira
+    for (int i = 0; i < I2C_ASYNC_QUEUE_LEN; i++) {
+        reg[i] = (uint8_t)(0x20 + i);
+        CHECK(i2c_async_write_read(&bus, &x[i], ADDR_MPU6050, &reg[i], 1, rx[i], 2, record_done, NULL));
+    }
+    CHECK(!i2c_async_write_read(&bus, &x[I2C_ASYNC_QUEUE_LEN], ADDR_MPU6050, reg, 1, rx[0], 2, record_done, NULL));
+    CHECK(bus.count == I2C_ASYNC_QUEUE_LEN);
+    CHECK(i2c_get_hw(i2c0)->intr_mask == (I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS));
+    restore_interrupts(save);
+
+    i2c_async_wait(&bus);
+    CHECK(done_count == I2C_ASYNC_QUEUE_LEN);
+    for (int i = 0; i < I2C_ASYNC_QUEUE_LEN; i++) {
+        CHECK(done_order[i] == &x[i] && done_status[i] == I2C_ASYNC_OK);
+        CHECK(rx[i][0] == 0x20 + i && rx[i][1] == 0x21 + i);
+    }
+
+    // Vazia ou maior que o buffer de DATA_CMD
+    static uint8_t big[I2C_ASYNC_MAX_LEN + 1];
+    CHECK(!i2c_async_write_read(&bus, &x[0], ADDR_MPU6050, NULL, 0, NULL, 0, NULL, NULL));
+    CHECK(!i2c_async_write_read(&bus, &x[0], ADDR_MPU6050, big, I2C_ASYNC_MAX_LEN, big, 1, NULL, NULL));
+    CHECK(i2c_async_write_read(&bus, &x[0], ADDR_MPU6050, big, I2C_ASYNC_MAX_LEN, NULL, 0, NULL, NULL));
+    i2c_async_wait(&bus);
+    CHECK(last_cmd_len == I2C_ASYNC_MAX_LEN);
+    CHECK(!i2c_async_busy(&bus));
+}
+
+// NACK: os dois canais de DMA são abortados, o erro chega ao callback e a
+// próxima transação da fila segue normalmente
+static void test_abort(void) {
+    i2c_async_xfer_t bad, good;
+    uint8_t reg = 0x40, rx_bad[4], rx_good[2];
+
+    reset_devices();
+    devices[0].nack = true;
+    uint32_t tx_aborts = fake_dma[bus.tx_dma].aborts, rx_aborts = fake_dma[bus.rx_dma].aborts;
+    uint32_t save = save_and_disable_interrupts();
+    CHECK(i2c_async_write_read(&bus, &bad, ADDR_MPU6050, &reg, 1, rx_bad, 4, record_done, NULL));
+    CHECK(i2c_async_write_read(&bus, &good, ADDR_BMP280, &reg, 1, rx_good, 2, record_done, NULL));
+    restore_interrupts(save);
+    i2c_async_wait(&bus);
+
+    CHECK(fake_dma[bus.tx_dma].aborts == tx_aborts + 1);
+    CHECK(fake_dma[bus.rx_dma].aborts == rx_aborts + 1);
+    CHECK(done_count == 2);
+    CHECK(done_order[0] == &bad && done_status[0] == I2C_ASYNC_ERR_ABORT && bad.status == I2C_ASYNC_ERR_ABORT);
+    CHECK(done_order[1] == &good && done_status[1] == I2C_ASYNC_OK);
+    CHECK(rx_good[0] == 0xFF - 0x40 && rx_good[1] == 0xFF - 0x41);
+
+    // TX_ABRT e STOP_DET em interrupções separadas: o erro da primeira
+    // prevalece e a transação só termina na segunda
+    reset_devices();
+    devices[0].nack = true;
+    split_abort = true;
+    CHECK(i2c_async_write_read(&bus, &bad, ADDR_MPU6050, &reg, 1, rx_bad, 4, record_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(done_count == 1 && done_status[0] == I2C_ASYNC_ERR_ABORT);
+    CHECK(!bad.busy && !i2c_async_busy(&bus));
+    devices[0].nack = false;
+    CHECK(i2c_async_write_read(&bus, &good, ADDR_MPU6050, &reg, 1, rx_good, 2, record_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(done_count == 2 && done_status[1] == I2C_ASYNC_OK && good.status == I2C_ASYNC_OK);
+}
+
+// Escritas bloqueantes (ex.: comandos do SSD1306) com a fila vazia: as
+// interrupções ficam mascaradas e o STOP_DET delas fica para o SDK; nenhum
+// callback, e a contagem não pode dar a volta
+static void test_blocking_stop_det(void) {
+    i2c_async_xfer_t x;
+    uint8_t cmd[2] = {0x00, 0xAF}, reg = 0x3B, rx[2];
+
+    reset_devices();
+    CHECK(i2c_async_write_read(&bus, &x, ADDR_MPU6050, &reg, 1, rx, 2, record_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(done_count == 1);
+    CHECK(i2c_get_hw(i2c0)->intr_mask == 0);
+
+    uint32_t calls = irq_calls;
+    for (int i = 0; i < 3; i++) CHECK(i2c_write_blocking(i2c0, ADDR_BMP280, cmd, 2, false) == 2);
+    CHECK(irq_calls == calls);
+    CHECK(bus.count == 0 && !i2c_async_busy(&bus));
+    CHECK(done_count == 1);
+
+    CHECK(i2c_async_write_read(&bus, &x, ADDR_MPU6050, &reg, 1, rx, 2, record_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(done_count == 2 && done_order[1] == &x && bus.count == 0);
+}
+
+/*================== SENSORES ==================*/
+
+static bool sensor_ok;
+static uint32_t sensor_calls;
+
+static void mpu6050_done(mpu6050_async_t *op, bool ok) {
+    (void)op;
+    sensor_ok = ok;
+    sensor_calls++;
+}
+
+static void bmp280_done(bmp280_async_t *op, bool ok) {
+    (void)op;
+    sensor_ok = ok;
+    sensor_calls++;
+}
+
+static void aht20_done(aht20_async_t *op, bool ok) {
+    (void)op;
+    sensor_ok = ok;
+    sensor_calls++;
+}
+
+static void test_sensors(void) {
+    reset_devices();
+    sensor_calls = 0;
+
+    // MPU6050: 14 bytes big-endian a partir de 0x3B, na ordem accel, temp, gyro
+    static const int16_t values[7] = {1000, -2000, 16384, -3460, 131, -262, 32767};
+    for (int i = 0; i < 7; i++) {
+        devices[0].regs[0x3B + 2 * i] = (uint8_t)((uint16_t)values[i] >> 8);
+        devices[0].regs[0x3B + 2 * i + 1] = (uint8_t)values[i];
+    }
+    mpu6050_async_t mop;
+    mpu6050_raw_t raw;
+    CHECK(mpu6050_read_burst_async(&bus, &mop, &raw, mpu6050_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 1 && sensor_ok);
+    CHECK(raw.accel[0] == 1000 && raw.accel[1] == -2000 && raw.accel[2] == 16384);
+    CHECK(raw.temp == -3460);
+    CHECK(raw.gyro[0] == 131 && raw.gyro[1] == -262 && raw.gyro[2] == 32767);
+
+    // BMP280: pressão e temperatura de 20 bits a partir de 0xF7
+    static const uint8_t bmp[6] = {0x65, 0x5A, 0xC0, 0x7E, 0xED, 0x00};
+    memcpy(&devices[1].regs[0xF7], bmp, sizeof(bmp));
+    bmp280_async_t bop;
+    int32_t temp = 0, pressure = 0;
+    CHECK(bmp280_read_raw_async(&bus, &bop, &temp, &pressure, bmp280_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 2 && sensor_ok);
+    CHECK(pressure == 0x655AC && temp == 0x7EED0);
+    CHECK(devices[1].written[0] == 0xF7);
+
+    // AHT20: comando de medição e leitura de status + 5 bytes
+    aht20_async_t aop;
+    AHT20_Data data = {0};
+    CHECK(aht20_trigger_async(&bus, &aop, aht20_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 3 && sensor_ok);
+    CHECK(devices[2].written_len == 3 && devices[2].written[0] == AHT20_CMD_TRIGGER);
+    CHECK(devices[2].written[1] == 0x33 && devices[2].written[2] == 0x00);
+
+    // 50 % de umidade, 25 °C: raw = 2^19 e 0x60000
+    static const uint8_t aht[6] = {0x1C, 0x80, 0x00, 0x06, 0x00, 0x00};
+    memcpy(devices[2].regs, aht, sizeof(aht));
+    CHECK(aht20_read_async(&bus, &aop, &data, aht20_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 4 && sensor_ok);
+    CHECK(fabsf(data.humidity - 50.0f) < 0.01f);
+    CHECK(fabsf(data.temperature - 25.0f) < 0.01f);
+
+    // Sensor ainda ocupado: ok = false e os dados anteriores ficam
+    devices[2].regs[0] |= 0x80;
+    data.temperature = -1.0f;
+    CHECK(aht20_read_async(&bus, &aop, &data, aht20_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 5 && !sensor_ok && data.temperature == -1.0f);
+
+    // NACK chega como ok = false
+    devices[1].nack = true;
+    CHECK(bmp280_read_raw_async(&bus, &bop, &temp, &pressure, bmp280_done, NULL));
+    i2c_async_wait(&bus);
+    CHECK(sensor_calls == 6 && !sensor_ok);
+}
+
+int main(void) {
+    test_init();
+    test_cmd_words();
+    test_queue();
+    test_abort();
+    test_blocking_stop_det();
+    test_sensors();
+    return test_result("i2c_async_test");
+}
@@ -0,0 +1,176 @@
+#include <math.h>
+#include <stdlib.h>
+#include "test.h"
+#include "test_sim.h"
+#include "hardware/sync.h"
+#include "lib/sensors/mpu6050/mpu6050.h"
+#include "lib/sampler/sampler.h"
+
+// Modo FIFO do MPU6050 contra o mapa de registradores do modelo do
+// simulador: configuração do divisor, do filtro e da FIFO, ordem dos campos
+// dos registros, transbordo, os instantes que o sampler atribui às amostras
+// quando a FIFO acumula mais que uma rajada e a contagem de erros de I2C
+
+#define REG_SMPLRT_DIV 0x19
+#define REG_CONFIG     0x1A
+#define REG_FIFO_EN    0x23
+#define REG_USER_CTRL  0x6A
+#define REG_PWR_MGMT_1 0x6B
+#define REG_WHO_AM_I   0x75
+
+// Valores do modelo em repouso (sim_mpu6050.c): 1 g em Z, 25 °C
+#define ACCEL_1G 16384
+#define TEMP_25C ((int)((25.0 - 36.53) * 340.0))
+
+static void test_registers(void) {
+    mpu6050_init(i2c0);
+    CHECK(test_mpu6050_get_reg(REG_WHO_AM_I) == 0x68);
+    CHECK(test_mpu6050_get_reg(REG_PWR_MGMT_1) == 0x00); // Acordado
+
+    // Divisor: 1000 / (1 + SMPLRT_DIV) com o filtro ligado
+    CHECK(mpu6050_fifo_enable(i2c0, 100, MPU6050_DLPF_184HZ) == 100);
+    CHECK(test_mpu6050_get_reg(REG_SMPLRT_DIV) == 9);
+    CHECK(test_mpu6050_get_reg(REG_CONFIG) == MPU6050_DLPF_184HZ);
+    CHECK(test_mpu6050_get_reg(REG_FIFO_EN) == 0xF8);
+    CHECK(test_mpu6050_get_reg(REG_USER_CTRL) == 0x40);
+
+    CHECK(mpu6050_fifo_enable(i2c0, 300, MPU6050_DLPF_44HZ) == 333);
+    CHECK(test_mpu6050_get_reg(REG_SMPLRT_DIV) == 2);
+    CHECK(test_mpu6050_get_reg(REG_CONFIG) == MPU6050_DLPF_44HZ);
+    CHECK(mpu6050_fifo_enable(i2c0, 5000, MPU6050_DLPF_184HZ) == 1000);
+    CHECK(test_mpu6050_get_reg(REG_SMPLRT_DIV) == 0);
+
+    // Sem filtro a base é 8 kHz
+    CHECK(mpu6050_fifo_enable(i2c0, 2000, MPU6050_DLPF_260HZ) == 2000);
+    CHECK(test_mpu6050_get_reg(REG_SMPLRT_DIV) == 3);
+    CHECK(mpu6050_fifo_enable(i2c0, 1, MPU6050_DLPF_184HZ) == 1000 / 256);
+    CHECK(test_mpu6050_get_reg(REG_SMPLRT_DIV) == 255);
+
+    mpu6050_fifo_disable(i2c0);
+    CHECK(test_mpu6050_get_reg(REG_FIFO_EN) == 0x00);
+    CHECK((test_mpu6050_get_reg(REG_USER_CTRL) & 0x44) == 0); // FIFO desligada, reset já limpo
+    CHECK(mpu6050_fifo_count(i2c0) == 0);
+}
+
+// Registro na ordem accel, temp, gyro, já convertido do big-endian
+static int raw_plausible(const mpu6050_raw_t *r) {
+    return abs(r->accel[2] - ACCEL_1G) < ACCEL_1G / 10 && abs(r->accel[0]) < ACCEL_1G / 8 &&
+           abs(r->temp - TEMP_25C) < 400 && abs(r->gyro[0]) < 20 * 131;
+}
+
+static void test_fifo_read(void) {
+    mpu6050_raw_t records[MPU6050_FIFO_MAX_RECORDS];
+
+    mpu6050_raw_t burst;
+    CHECK(mpu6050_read_burst(i2c0, &burst));
+    CHECK(raw_plausible(&burst));
+
+    CHECK(mpu6050_fifo_enable(i2c0, 1000, MPU6050_DLPF_184HZ) == 1000);
+    sleep_us(10 * 1000 + 500);
+    CHECK(mpu6050_fifo_count(i2c0) == 10 * MPU6050_FIFO_RECORD_SIZE);
+
+    // Leitura parcial: o resto (e o que chegou durante a rajada) fica na FIFO
+    CHECK(mpu6050_fifo_read(i2c0, records, 4) == 4);
+    for (int i = 0; i < 4; i++) CHECK(raw_plausible(&records[i]));
+    int n = mpu6050_fifo_read(i2c0, records, MPU6050_FIFO_MAX_RECORDS);
+    CHECK(n >= 6 && n <= 8);
+    for (int i = 0; i < n; i++) CHECK(raw_plausible(&records[i]));
+
+    // Falha no barramento
+    test_i2c_fail_next(1);
+    CHECK(mpu6050_fifo_read(i2c0, records, 4) == MPU6050_FIFO_ERR_BUS);
+    test_i2c_fail_next(1);
+    CHECK(!mpu6050_read_burst(i2c0, &burst));
+
+    // read_raw com falha não entrega lixo
+    int16_t accel[3] = {1, 1, 1}, gyro[3] = {1, 1, 1}, temp = 1;
+    test_i2c_fail_next(1);
+    CHECK(!mpu6050_read_raw(i2c0, accel, gyro, &temp));
+    CHECK(accel[0] == 0 && accel[2] == 0 && gyro[1] == 0 && temp == 0);
+    CHECK(mpu6050_read_raw(i2c0, accel, gyro, &temp));
+    CHECK(abs(accel[2] - ACCEL_1G) < ACCEL_1G / 10);
+
+    // Mais de 73 registros: transbordo, e a FIFO recomeça vazia
+    sleep_ms(200);
+    CHECK(mpu6050_fifo_read(i2c0, records, MPU6050_FIFO_MAX_RECORDS) == MPU6050_FIFO_ERR_OVERFLOW);
+    CHECK(mpu6050_fifo_count(i2c0) < 2 * MPU6050_FIFO_RECORD_SIZE);
+    sleep_ms(5);
+    n = mpu6050_fifo_read(i2c0, records, MPU6050_FIFO_MAX_RECORDS);
+    CHECK(n >= 5 && n <= 7);
+    mpu6050_fifo_disable(i2c0);
+}
+
+// Aceleração em X do modelo no instante t: 0,1 g a 1 Hz
+static double model_accel_x(uint64_t t_us) {
+    return 0.10 * ACCEL_1G * sin(2 * 3.14159265358979323846 * t_us / 1e6);
+}
+
+// Com interrupções bloqueadas por mais que uma rajada, a FIFO acumula
+// registros que o callback tem de esvaziar em várias leituras
+static void test_sampler_timestamps(void) {
+    sample_t samples[SAMPLER_QUEUE_LEN];
+    uint64_t last_us = 0;
+    uint32_t total = 0, backwards = 0, off = 0;
+
+    sampler_init(i2c0, 1000);
+    sampler_set_mode(SAMPLER_MODE_FIFO);
+    CHECK(sampler_start());
+    uint64_t end_us = time_us_64() + 2000000;
+
+    while (time_us_64() < end_us) {
+        if (total % 500 < 10) {
+            uint32_t save = save_and_disable_interrupts();
+            sim_advance_us(60000); // 60 registros parados na FIFO
+            restore_interrupts(save);
+        }
+        sleep_us(1000);
+
+        uint32_t n;
+        while ((n = sampler_pop_n(samples, SAMPLER_QUEUE_LEN)) > 0) {
+            for (uint32_t i = 0; i < n; i++) {
+                if (total > 0 && samples[i].timestamp_us <= last_us) backwards++;
+                // O instante atribuído é o da leitura no sensor, a menos de um
+                // período mais o tempo da rajada
+                if (fabs(samples[i].accel[0] - model_accel_x(samples[i].timestamp_us)) > 40) off++;
+                last_us = samples[i].timestamp_us;
+                total++;
+            }
+        }
+    }
+    sampler_stop();
+
+    CHECK(backwards == 0);
+    CHECK(off == 0);
+    CHECK(total > 1900 && total <= 2100);
+    CHECK(sampler_dropped() == 0);
+    CHECK(sampler_fifo_overflows() == 0);
+    printf("sampler: %u amostras, %u fora de ordem, %u fora do instante\n", total, backwards, off);
+}
+
+// Modo timer: leituras que falham no barramento não contam como fila cheia
+static void test_sampler_bus_errors(void) {
+    sample_t sample;
+    uint32_t total = 0;
+
+    sampler_init(i2c0, 100);
+    sampler_set_mode(SAMPLER_MODE_TIMER);
+    CHECK(sampler_start());
+    sleep_ms(100);
+    test_i2c_fail_next(3); // Três leituras seguidas falham
+    sleep_ms(100);
+    sampler_stop();
+    while (sampler_pop(&sample)) total++;
+
+    CHECK(sampler_bus_errors() == 3);
+    CHECK(sampler_dropped() == 0);
+    CHECK(total == 20 - 3);
+    printf("sampler (timer): %u amostras, %u erros de I2C\n", total, sampler_bus_errors());
+}
+
+int main(void) {
+    test_registers();
+    test_fifo_read();
+    test_sampler_timestamps();
+    test_sampler_bus_errors();
+    return test_result("mpu6050_fifo_test");
+}
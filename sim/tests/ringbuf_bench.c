@@ -0,0 +1,123 @@
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "test.h"
+#include "lib/ringbuf/ringbuf.h"
+
+// Vazão da fila SPSC com registros do tamanho do sample_t (24 bytes):
+// numa thread (push/pop alternados) e com produtor e consumidor em threads
+// separadas, registro a registro, em lotes e sem cópia
+
+#define BENCH_RECORDS 20000000u
+#define BENCH_CAPACITY 256
+#define BENCH_BATCH 32
+
+typedef struct {
+    uint8_t bytes[24];
+} record_t;
+
+typedef struct {
+    ringbuf_t rb;
+    record_t storage[BENCH_CAPACITY];
+    int mode; // 0: um a um, 1: lotes, 2: sem cópia
+    uint32_t sink;
+} bench_t;
+
+static void *bench_producer(void *arg) {
+    bench_t *b = arg;
+    record_t batch[BENCH_BATCH] = {0};
+    uint32_t sent = 0;
+
+    while (sent < BENCH_RECORDS) {
+        if (ringbuf_free(&b->rb) == 0) {
+            sched_yield(); // Sem espaço: cede a CPU ao consumidor
+            continue;
+        }
+        if (b->mode == 0) {
+            batch[0].bytes[0] = (uint8_t)sent;
+            sent += ringbuf_push(&b->rb, &batch[0]);
+        } else if (b->mode == 1) {
+            sent += ringbuf_push_n(&b->rb, batch, BENCH_BATCH);
+        } else {
+            void *span;
+            uint32_t n = ringbuf_write_reserve(&b->rb, &span);
+            if (n > BENCH_BATCH) n = BENCH_BATCH;
+            for (uint32_t i = 0; i < n; i++) ((record_t *)span)[i].bytes[0] = (uint8_t)(sent + i);
+            ringbuf_write_commit(&b->rb, n);
+            sent += n;
+        }
+    }
+    return NULL;
+}
+
+static void *bench_consumer(void *arg) {
+    bench_t *b = arg;
+    record_t batch[BENCH_BATCH];
+    uint32_t got = 0, sink = 0;
+
+    // O produtor pode passar um pouco de BENCH_RECORDS no último lote
+    while (got < BENCH_RECORDS) {
+        if (ringbuf_count(&b->rb) == 0) {
+            sched_yield();
+            continue;
+        }
+        if (b->mode == 0) {
+            if (ringbuf_pop(&b->rb, &batch[0])) {
+                sink += batch[0].bytes[0];
+                got++;
+            }
+        } else if (b->mode == 1) {
+            uint32_t n = ringbuf_pop_n(&b->rb, batch, BENCH_BATCH);
+            if (n) sink += batch[n - 1].bytes[0];
+            got += n;
+        } else {
+            const void *span;
+            uint32_t n = ringbuf_read_peek(&b->rb, &span);
+            for (uint32_t i = 0; i < n; i++) sink += ((const record_t *)span)[i].bytes[0];
+            ringbuf_read_release(&b->rb, n);
+            got += n;
+        }
+    }
+    b->sink = sink;
+    return NULL;
+}
+
+static void bench_threads(int mode, const char *name) {
+    static bench_t b;
+    pthread_t producer, consumer;
+
+    ringbuf_init(&b.rb, b.storage, sizeof(record_t), BENCH_CAPACITY);
+    b.mode = mode;
+    double t0 = test_now_s();
+    pthread_create(&consumer, NULL, bench_consumer, &b);
+    pthread_create(&producer, NULL, bench_producer, &b);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    double dt = test_now_s() - t0;
+    printf("2 threads, %-10s %7.1f Mregistros/s\n", name, BENCH_RECORDS / dt / 1e6);
+}
+
+static void bench_single(void) {
+    static bench_t b;
+    record_t r = {0};
+
+    ringbuf_init(&b.rb, b.storage, sizeof(record_t), BENCH_CAPACITY);
+    double t0 = test_now_s();
+    for (uint32_t i = 0; i < BENCH_RECORDS; i++) {
+        r.bytes[0] = (uint8_t)i;
+        ringbuf_push(&b.rb, &r);
+        ringbuf_pop(&b.rb, &r);
+        b.sink += r.bytes[0];
+    }
+    double dt = test_now_s() - t0;
+    printf("1 thread,  %-10s %7.1f Mregistros/s (%.1f ns por push+pop)\n", "um a um",
+           BENCH_RECORDS / dt / 1e6, dt / BENCH_RECORDS * 1e9);
+}
+
+int main(void) {
+    bench_single();
+    bench_threads(0, "um a um");
+    bench_threads(1, "lotes");
+    bench_threads(2, "sem copia");
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include "test.h"
+#include "lib/ringbuf/ringbuf.h"
+
+// Testes da fila SPSC: operações básicas, contadores, volta do índice nos
+// trechos sem cópia e um teste de estresse com produtor e consumidor em
+// threads separadas
+
+#define STRESS_RECORDS 1000000u
+#define STRESS_CAPACITY 256
+
+// Mesmo tamanho do sample_t (24 bytes)
+typedef struct {
+    uint32_t seq;
+    uint32_t check;
+    uint32_t pad[4];
+} record_t;
+
+static record_t make_record(uint32_t seq) {
+    record_t r = { .seq = seq, .check = ~seq * 2654435761u };
+    for (int i = 0; i < 4; i++) r.pad[i] = seq + i;
+    return r;
+}
+
+static int record_ok(const record_t *r, uint32_t seq) {
+    record_t ref = make_record(seq);
+    return memcmp(r, &ref, sizeof(ref)) == 0;
+}
+
+static void test_init(void) {
+    ringbuf_t rb;
+    record_t storage[8];
+
+    CHECK(!ringbuf_init(&rb, storage, sizeof(record_t), 6));
+    CHECK(!ringbuf_init(&rb, storage, sizeof(record_t), 0));
+    CHECK(!ringbuf_init(&rb, storage, 0, 8));
+    CHECK(!ringbuf_init(&rb, NULL, sizeof(record_t), 8));
+    CHECK(ringbuf_init(&rb, storage, sizeof(record_t), 8));
+    CHECK(ringbuf_count(&rb) == 0);
+    CHECK(ringbuf_free(&rb) == 8);
+}
+
+static void test_push_pop(void) {
+    ringbuf_t rb;
+    record_t storage[8], r;
+
+    ringbuf_init(&rb, storage, sizeof(record_t), 8);
+    CHECK(!ringbuf_pop(&rb, &r));
+    for (uint32_t i = 0; i < 8; i++) {
+        r = make_record(i);
+        CHECK(ringbuf_push(&rb, &r));
+    }
+    r = make_record(99);
+    CHECK(!ringbuf_push(&rb, &r)); // Cheia
+    CHECK(ringbuf_overruns(&rb) == 1);
+    CHECK(ringbuf_high_water(&rb) == 8);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(ringbuf_pop(&rb, &r));
+        CHECK(record_ok(&r, i));
+    }
+    CHECK(!ringbuf_pop(&rb, &r));
+
+    ringbuf_add_overruns(&rb, 3);
+    CHECK(ringbuf_overruns(&rb) == 4);
+    ringbuf_reset(&rb);
+    CHECK(ringbuf_overruns(&rb) == 0 && ringbuf_high_water(&rb) == 0);
+}
+
+// Lotes de tamanhos variados para passar por todas as posições de volta
+static void test_batches(void) {
+    ringbuf_t rb;
+    record_t storage[16], in[16], out[16];
+    uint32_t next_in = 0, next_out = 0;
+
+    ringbuf_init(&rb, storage, sizeof(record_t), 16);
+    for (uint32_t round = 0; round < 200; round++) {
+        uint32_t n = 1 + round % 13;
+        uint32_t space = ringbuf_free(&rb);
+        for (uint32_t i = 0; i < n; i++) in[i] = make_record(next_in + i);
+        uint32_t pushed = ringbuf_push_n(&rb, in, n);
+        CHECK(pushed == (n < space ? n : space));
+        next_in += pushed;
+
+        uint32_t m = 1 + round % 7;
+        uint32_t popped = ringbuf_pop_n(&rb, out, m);
+        for (uint32_t i = 0; i < popped; i++) CHECK(record_ok(&out[i], next_out + i));
+        next_out += popped;
+    }
+    CHECK(ringbuf_count(&rb) == next_in - next_out);
+    CHECK(ringbuf_high_water(&rb) <= 16);
+}
+
+// reserve/commit e peek/release: o trecho nunca passa do fim da área
+static void test_spans(void) {
+    ringbuf_t rb;
+    record_t storage[8], r;
+    void *wspan;
+    const void *rspan;
+
+    ringbuf_init(&rb, storage, sizeof(record_t), 8);
+    for (uint32_t i = 0; i < 5; i++) {
+        r = make_record(i);
+        ringbuf_push(&rb, &r);
+    }
+    for (uint32_t i = 0; i < 5; i++) ringbuf_pop(&rb, &r);
+
+    // head = 5: só 3 registros contíguos até o fim, embora 8 estejam livres
+    CHECK(ringbuf_write_reserve(&rb, &wspan) == 3);
+    CHECK(wspan == &storage[5]);
+    for (uint32_t i = 0; i < 3; i++) ((record_t *)wspan)[i] = make_record(100 + i);
+    ringbuf_write_commit(&rb, 3);
+
+    CHECK(ringbuf_write_reserve(&rb, &wspan) == 5);
+    CHECK(wspan == &storage[0]);
+    for (uint32_t i = 0; i < 2; i++) ((record_t *)wspan)[i] = make_record(103 + i);
+    ringbuf_write_commit(&rb, 2);
+    CHECK(ringbuf_count(&rb) == 5);
+
+    CHECK(ringbuf_read_peek(&rb, &rspan) == 3);
+    CHECK(record_ok(rspan, 100));
+    ringbuf_read_release(&rb, 3);
+    CHECK(ringbuf_read_peek(&rb, &rspan) == 2);
+    CHECK(record_ok((const record_t *)rspan + 1, 104));
+    ringbuf_read_release(&rb, 2);
+    CHECK(ringbuf_count(&rb) == 0);
+    CHECK(ringbuf_read_peek(&rb, &rspan) == 0);
+}
+
+/*================== ESTRESSE ==================*/
+
+typedef struct {
+    ringbuf_t rb;
+    record_t storage[STRESS_CAPACITY];
+    uint32_t errors;
+} stress_t;
+
+// Produtor: alterna push, push_n e reserve/commit; fila cheia = tenta de
+// novo (cedendo a CPU, para o teste não depender de haver dois núcleos)
+static void *stress_producer(void *arg) {
+    stress_t *s = arg;
+    record_t batch[32];
+    uint32_t seq = 0;
+
+    while (seq < STRESS_RECORDS) {
+        if (ringbuf_free(&s->rb) == 0) {
+            sched_yield();
+            continue;
+        }
+        uint32_t mode = seq % 3;
+        if (mode == 0) {
+            record_t r = make_record(seq);
+            if (ringbuf_push(&s->rb, &r)) seq++;
+        } else if (mode == 1) {
+            uint32_t n = STRESS_RECORDS - seq < 32 ? STRESS_RECORDS - seq : 1 + seq % 32;
+            uint32_t space = ringbuf_free(&s->rb);
+            if (n > space) n = space;
+            for (uint32_t i = 0; i < n; i++) batch[i] = make_record(seq + i);
+            seq += ringbuf_push_n(&s->rb, batch, n);
+        } else {
+            void *span;
+            uint32_t n = ringbuf_write_reserve(&s->rb, &span);
+            if (n > STRESS_RECORDS - seq) n = STRESS_RECORDS - seq;
+            for (uint32_t i = 0; i < n; i++) ((record_t *)span)[i] = make_record(seq + i);
+            ringbuf_write_commit(&s->rb, n);
+            seq += n;
+        }
+    }
+    return NULL;
+}
+
+// Consumidor: alterna pop_n e peek/release e confere a sequência
+static void *stress_consumer(void *arg) {
+    stress_t *s = arg;
+    record_t batch[32];
+    uint32_t seq = 0;
+
+    while (seq < STRESS_RECORDS) {
+        if (ringbuf_count(&s->rb) == 0) {
+            sched_yield();
+            continue;
+        }
+        if (seq & 1) {
+            uint32_t n = ringbuf_pop_n(&s->rb, batch, 1 + seq % 32);
+            for (uint32_t i = 0; i < n; i++)
+                if (!record_ok(&batch[i], seq + i)) s->errors++;
+            seq += n;
+        } else {
+            const void *span;
+            uint32_t n = ringbuf_read_peek(&s->rb, &span);
+            for (uint32_t i = 0; i < n; i++)
+                if (!record_ok((const record_t *)span + i, seq + i)) s->errors++;
+            ringbuf_read_release(&s->rb, n);
+            seq += n;
+        }
+    }
+    return NULL;
+}
+
+static void test_stress(void) {
+    static stress_t s;
+    pthread_t producer, consumer;
+
+    ringbuf_init(&s.rb, s.storage, sizeof(record_t), STRESS_CAPACITY);
+    double t0 = test_now_s();
+    pthread_create(&consumer, NULL, stress_consumer, &s);
+    pthread_create(&producer, NULL, stress_producer, &s);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    double dt = test_now_s() - t0;
+
+    CHECK(s.errors == 0);
+    CHECK(ringbuf_count(&s.rb) == 0);
+    CHECK(ringbuf_overruns(&s.rb) == 0);
+    printf("estresse: %u registros em %.2f s, %u erros\n", STRESS_RECORDS, dt, s.errors);
+}
+
+int main(void) {
+    test_init();
+    test_push_pop();
+    test_batches();
+    test_spans();
+    test_stress();
+    return test_result("ringbuf_test");
+}
@@ -0,0 +1,190 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test.h"
+#include "lib/spectrum/spectrum.h"
+
+// FFT em ponto fixo e análise por bloco contra o mesmo cálculo em double:
+// a FFT contra a DFT / N, e senoides conhecidas (com nível DC, em várias
+// frequências e amplitudes) contra a frequência e a amplitude verdadeiras e
+// contra a análise em double (janela de Hann, fator 16/3, energia dos três
+// bins do pico e interpolação do deslocamento)
+
+#define PI 3.14159265358979323846
+#define FFT_ROUNDS 50
+#define SINE_ROUNDS 200
+
+static spectrum_t sp;
+static uint32_t seed = 1;
+
+// Uniforme em [0, 1)
+static double uniform(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 16777216.0;
+}
+
+static void dft(const double *xr, const double *xi, double *yr, double *yi) {
+    for (int k = 0; k < SPECTRUM_N; k++) {
+        double sr = 0, si = 0;
+        for (int n = 0; n < SPECTRUM_N; n++) {
+            double a = -2 * PI * k * n / SPECTRUM_N;
+            sr += xr[n] * cos(a) - xi[n] * sin(a);
+            si += xr[n] * sin(a) + xi[n] * cos(a);
+        }
+        yr[k] = sr / SPECTRUM_N;
+        yi[k] = si / SPECTRUM_N;
+    }
+}
+
+// Entradas complexas aleatórias com módulo até a faixa de entrada (16383)
+static void test_fft(void) {
+    int16_t re[SPECTRUM_N], im[SPECTRUM_N];
+    double xr[SPECTRUM_N], xi[SPECTRUM_N], yr[SPECTRUM_N], yi[SPECTRUM_N];
+    double worst = 0;
+
+    for (int round = 0; round < FFT_ROUNDS; round++) {
+        for (int n = 0; n < SPECTRUM_N; n++) {
+            double m = 16383 * uniform(), a = 2 * PI * uniform();
+            re[n] = (int16_t)lrint(m * cos(a));
+            im[n] = (round & 1) ? 0 : (int16_t)lrint(m * sin(a)); // Metade só real, como na análise
+            xr[n] = re[n];
+            xi[n] = im[n];
+        }
+        spectrum_fft_q15(re, im);
+        dft(xr, xi, yr, yi);
+        for (int k = 0; k < SPECTRUM_N; k++) {
+            double e = hypot(re[k] - yr[k], im[k] - yi[k]);
+            if (e > worst) worst = e;
+        }
+    }
+    CHECK(worst < 6.0);
+    printf("fft: erro máximo %.2f LSB contra a DFT / N em double\n", worst);
+
+    // Senoide complexa exatamente no bin 10: toda a energia fica nele
+    for (int n = 0; n < SPECTRUM_N; n++) {
+        re[n] = (int16_t)lrint(16000 * cos(2 * PI * 10 * n / SPECTRUM_N));
+        im[n] = (int16_t)lrint(16000 * sin(2 * PI * 10 * n / SPECTRUM_N));
+    }
+    spectrum_fft_q15(re, im);
+    CHECK(fabs(re[10] - 16000.0) < 6 && abs(im[10]) < 6);
+    for (int k = 0; k < SPECTRUM_N; k++)
+        if (k != 10) CHECK(abs(re[k]) < 6 && abs(im[k]) < 6);
+}
+
+// Maior pico e RMS total calculados em double, com as mesmas fórmulas
+typedef struct {
+    double freq_hz;
+    double amp;  // LSB
+    double rms;  // LSB, soma das faixas
+} ref_result_t;
+
+static void ref_analyze(const int16_t *x, uint32_t rate_hz, ref_result_t *out) {
+    double xr[SPECTRUM_N], xi[SPECTRUM_N], yr[SPECTRUM_N], yi[SPECTRUM_N], power[SPECTRUM_N / 2 + 1];
+    double mean = 0;
+
+    for (int n = 0; n < SPECTRUM_N; n++) mean += x[n];
+    mean /= SPECTRUM_N;
+    for (int n = 0; n < SPECTRUM_N; n++) {
+        xr[n] = (x[n] - mean) * 0.5 * (1 - cos(2 * PI * n / SPECTRUM_N));
+        xi[n] = 0;
+    }
+    dft(xr, xi, yr, yi);
+
+    int k = 1;
+    double total = 0;
+    for (int i = 0; i <= SPECTRUM_N / 2; i++) power[i] = yr[i] * yr[i] + yi[i] * yi[i];
+    for (int i = 1; i < SPECTRUM_N / 2; i++) {
+        total += power[i];
+        if (power[i] > power[k]) k = i;
+    }
+    double m0 = sqrt(power[k - 1]), m1 = sqrt(power[k]), m2 = sqrt(power[k + 1]);
+    double d = 2 * (m2 - m0) / (m0 + 2 * m1 + m2);
+    out->freq_hz = (k + d) * rate_hz / SPECTRUM_N;
+    out->amp = sqrt((power[k - 1] + power[k] + power[k + 1]) * 32 / 3);
+    out->rms = sqrt(total * 16 / 3);
+}
+
+static double band_total_ug(const spectrum_result_t *r) {
+    double total = 0;
+    for (int b = 0; b < SPECTRUM_BANDS; b++) total += (double)r->band_rms_ug[b] * r->band_rms_ug[b];
+    return sqrt(total);
+}
+
+#define UG_PER_LSB (1e6 / 16384)
+
+// Senoide com nível DC entre o bin 4 e N/2 - 4, de 2 mg a 0,5 g
+static void test_sines(uint32_t rate_hz) {
+    int16_t x[SPECTRUM_N];
+    spectrum_result_t r;
+    ref_result_t ref;
+    double bin_hz = (double)rate_hz / SPECTRUM_N;
+    double worst_f = 0, worst_a = 0, worst_ref_f = 0, worst_ref_a = 0, worst_rms = 0;
+
+    spectrum_init(&sp, rate_hz);
+    for (int round = 0; round < SINE_ROUNDS; round++) {
+        double f = (4 + uniform() * (SPECTRUM_N / 2 - 8)) * bin_hz;
+        double a = (0.002 + uniform() * 0.5) * 16384;
+        double dc = (uniform() - 0.5) * 8000, phase = 2 * PI * uniform();
+        for (int n = 0; n < SPECTRUM_N; n++)
+            x[n] = (int16_t)lrint(dc + a * sin(2 * PI * f * n / rate_hz + phase));
+
+        spectrum_analyze(&sp, x, &r);
+        ref_analyze(x, rate_hz, &ref);
+        double got_f = r.peaks[0].freq_chz / 100.0, got_a = r.peaks[0].amp_ug / UG_PER_LSB;
+
+        double ef = fabs(got_f - f) / bin_hz, ea = fabs(got_a / a - 1);
+        // A saída é truncada em centésimos de Hz: esse passo não conta como erro
+        double erf = fmax(fabs(got_f - ref.freq_hz) - 0.01, 0) / bin_hz, era = fabs(got_a / ref.amp - 1);
+        double erms = fabs(band_total_ug(&r) / UG_PER_LSB / ref.rms - 1);
+        if (ef > worst_f) worst_f = ef;
+        if (ea > worst_a) worst_a = ea;
+        if (erf > worst_ref_f) worst_ref_f = erf;
+        if (era > worst_ref_a) worst_ref_a = era;
+        if (erms > worst_rms) worst_rms = erms;
+    }
+
+    // Contra os valores verdadeiros: erro da interpolação e da soma de três bins
+    CHECK(worst_f < 0.06);
+    CHECK(worst_a < 0.03);
+    // Contra o mesmo cálculo em double: só o erro do ponto fixo
+    CHECK(worst_ref_f < 0.01);
+    CHECK(worst_ref_a < 0.01);
+    CHECK(worst_rms < 0.01);
+    printf("senoides a %u Hz: frequência %.3f bin (%.3f do double), amplitude %.2f%% (%.2f%% do double), "
+           "RMS das faixas %.2f%% do double\n", rate_hz, worst_f, worst_ref_f, worst_a * 100, worst_ref_a * 100,
+           worst_rms * 100);
+}
+
+// Dois tons: os dois maiores picos na ordem das amplitudes
+static void test_two_tones(void) {
+    int16_t x[SPECTRUM_N];
+    spectrum_result_t r;
+
+    spectrum_init(&sp, 100);
+    for (int n = 0; n < SPECTRUM_N; n++)
+        x[n] = (int16_t)lrint(16384 + 1638 * sin(2 * PI * 9.4 * n / 100) + 410 * sin(2 * PI * 28.1 * n / 100));
+    spectrum_analyze(&sp, x, &r);
+
+    CHECK(fabs(r.peaks[0].freq_chz - 940.0) < 3);
+    CHECK(fabs(r.peaks[0].amp_ug - 100000.0) < 2000);
+    CHECK(fabs(r.peaks[1].freq_chz - 2810.0) < 3);
+    CHECK(fabs(r.peaks[1].amp_ug - 25000.0) < 750);
+    CHECK(r.peaks[2].amp_ug < r.peaks[1].amp_ug / 20);
+
+    // Faixas de 6,25 Hz: 9,4 Hz cai no meio da faixa 1 e 28,1 Hz no da faixa 4
+    CHECK(fabs(r.band_rms_ug[1] - 100000.0 / sqrt(2)) < 3000);
+    CHECK(fabs(r.band_rms_ug[4] - 25000.0 / sqrt(2)) < 1000);
+
+    // Sinal constante: sem picos nem energia
+    for (int n = 0; n < SPECTRUM_N; n++) x[n] = 16384;
+    spectrum_analyze(&sp, x, &r);
+    CHECK(r.peaks[0].freq_chz == 0 && r.peaks[0].amp_ug == 0 && band_total_ug(&r) == 0);
+}
+
+int main(void) {
+    test_fft();
+    test_sines(100);
+    test_sines(1000);
+    test_two_tones();
+    return test_result("spectrum_test");
+}
@@ -0,0 +1,54 @@
+#include "test.h"
+#include "ssd1306_ref.h"
+
+// Tempo por operação de desenho: rasterizador por páginas contra o caminho
+// pixel a pixel. O envio ao display não entra na medida
+
+#define WIDTH 128
+#define HEIGHT 64
+#define BENCH_REPS 20000u
+
+static ssd1306_t ssd;
+static const char *const lines[] = {"Gravando 1000 Hz", "Amostras: 123456", "Fila 12/64  SD ok", "Temp 25.30 C"};
+
+// Tela de texto: 7 linhas de até 17 caracteres a partir da linha y
+static void text_fast(uint8_t y) {
+    for (int i = 0; i < 7; i++) ssd1306_draw_string(&ssd, lines[i % 4], 0, y + i * 8);
+}
+
+static void text_ref(uint8_t y) {
+    for (int i = 0; i < 7; i++) ref_draw_string(&ssd, lines[i % 4], 0, y + i * 8);
+}
+
+static double bench(void (*fn)(uint32_t)) {
+    double t0 = test_now_s();
+    for (uint32_t i = 0; i < BENCH_REPS; i++) fn(i);
+    return (test_now_s() - t0) / BENCH_REPS * 1e9;
+}
+
+static void fill_fast(uint32_t i) { ssd1306_fill(&ssd, i & 1); }
+static void fill_ref(uint32_t i) { ref_fill(&ssd, i & 1); }
+static void text_aligned_fast(uint32_t i) { (void)i; text_fast(0); }
+static void text_aligned_ref(uint32_t i) { (void)i; text_ref(0); }
+static void text_shifted_fast(uint32_t i) { (void)i; text_fast(3); }
+static void text_shifted_ref(uint32_t i) { (void)i; text_ref(3); }
+static void rect_fast(uint32_t i) { ssd1306_rect(&ssd, 5, 10, 100, 40, i & 1, true); }
+static void rect_ref(uint32_t i) { ref_rect(&ssd, 5, 10, 100, 40, i & 1, true); }
+static void frame_fast(uint32_t i) { ssd1306_rect(&ssd, 3, 3, 122, 58, i & 1, false); }
+static void frame_ref(uint32_t i) { ref_rect(&ssd, 3, 3, 122, 58, i & 1, false); }
+
+static void report(const char *name, void (*fast)(uint32_t), void (*ref)(uint32_t)) {
+    double ns_fast = bench(fast);
+    double ns_ref = bench(ref);
+    printf("%-22s %9.1f ns  pixel a pixel %9.1f ns (%.1fx)\n", name, ns_fast, ns_ref, ns_ref / ns_fast);
+}
+
+int main(void) {
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL);
+    report("fill", fill_fast, fill_ref);
+    report("texto (y alinhado)", text_aligned_fast, text_aligned_ref);
+    report("texto (y = 3)", text_shifted_fast, text_shifted_ref);
+    report("rect cheio 100x40", rect_fast, rect_ref);
+    report("moldura 122x58", frame_fast, frame_ref);
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef SSD1306_REF_H
+#define SSD1306_REF_H
+
+#include "lib/ssd1306/ssd1306.h"
+
+// Caminho pixel a pixel que o rasterizador por páginas substituiu, para o
+// teste de equivalência e o benchmark. Desenha em ssd->ram_buffer como as
+// funções da biblioteca, com o mesmo recorte nas bordas
+
+void ref_pixel(ssd1306_t *ssd, int x, int y, bool value);
+void ref_fill(ssd1306_t *ssd, bool value);
+void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
+void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
+void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+void ref_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
+void ref_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+#endif // SSD1306_REF_H
@@ -0,0 +1,109 @@
+#include <string.h>
+#include "test.h"
+#include "ssd1306_ref.h"
+
+// Rasterizador por páginas contra o caminho pixel a pixel: o quadro
+// resultante tem de ser idêntico byte a byte, em todas as posições
+// verticais (alinhadas ou não às páginas) e com recorte nas bordas
+
+#define WIDTH 128
+#define HEIGHT 64
+#define RANDOM_OPS 20000
+
+static ssd1306_t fast, ref;
+
+// Mesmo fundo nos dois quadros, para que os bits preservados também contem
+static void same_background(uint32_t *seed) {
+    for (size_t i = 1; i < fast.bufsize; i++) {
+        *seed = *seed * 1664525u + 1013904223u;
+        fast.ram_buffer[i] = ref.ram_buffer[i] = (uint8_t)(*seed >> 24);
+    }
+}
+
+static int frames_equal(void) {
+    return memcmp(fast.ram_buffer, ref.ram_buffer, fast.bufsize) == 0;
+}
+
+static void test_fill(void) {
+    uint32_t seed = 1;
+    for (int v = 0; v < 2; v++) {
+        same_background(&seed);
+        ssd1306_fill(&fast, v);
+        ref_fill(&ref, v);
+        CHECK(frames_equal());
+    }
+}
+
+// Todo caractere imprimível em toda linha y e em colunas até a borda direita
+static void test_chars(void) {
+    uint32_t seed = 2, mismatches = 0;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x += 5) {
+            same_background(&seed);
+            for (char c = ' '; c <= '~'; c += 7) {
+                ssd1306_draw_char(&fast, c, x, y);
+                ref_draw_char(&ref, c, x, y);
+            }
+            ssd1306_draw_char(&fast, '\n', x, y); // Fora da fonte: espaço
+            ref_draw_char(&ref, '\n', x, y);
+            if (!frames_equal()) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+
+    same_background(&seed);
+    ssd1306_draw_string(&fast, "Gravando 1000 Hz - amostras: 123456", 3, 5);
+    ref_draw_string(&ref, "Gravando 1000 Hz - amostras: 123456", 3, 5);
+    CHECK(frames_equal());
+}
+
+// Retângulos, linhas e trechos aleatórios, parte deles saindo da tela
+static void test_primitives(void) {
+    uint32_t seed = 3, mismatches = 0;
+    same_background(&seed);
+    for (int i = 0; i < RANDOM_OPS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint32_t r = seed;
+        uint8_t a = (r >> 8) % 140, b = (r >> 16) % 72;
+        uint8_t w = 1 + (r >> 4) % 60, h = 1 + (r >> 24) % 40;
+        bool value = r & 1;
+        switch ((r >> 1) % 5) {
+        case 0:
+            ssd1306_rect(&fast, b, a, w, h, value, true);
+            ref_rect(&ref, b, a, w, h, value, true);
+            break;
+        case 1:
+            ssd1306_rect(&fast, b, a, w, h, value, false);
+            ref_rect(&ref, b, a, w, h, value, false);
+            break;
+        case 2:
+            ssd1306_hline(&fast, a, a + w, b, value);
+            ref_hline(&ref, a, a + w, b, value);
+            break;
+        case 3:
+            ssd1306_vline(&fast, a, b, b + h, value);
+            ref_vline(&ref, a, b, b + h, value);
+            break;
+        default:
+            // Retas horizontais e verticais vão pelos trechos por byte
+            ssd1306_line(&fast, a, b, (r >> 3) & 1 ? a : a + w, (r >> 3) & 1 ? b + h : b, value);
+            if ((r >> 3) & 1) ref_vline(&ref, a, b, b + h, value);
+            else ref_hline(&ref, a, a + w, b, value);
+            break;
+        }
+        if (!frames_equal()) {
+            if (mismatches++ == 0) fprintf(stderr, "operação %d (tipo %u) diverge\n", i, (r >> 1) % 5);
+            memcpy(ref.ram_buffer, fast.ram_buffer, fast.bufsize);
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void) {
+    ssd1306_init(&fast, WIDTH, HEIGHT, false, 0x3C, NULL);
+    ssd1306_init(&ref, WIDTH, HEIGHT, false, 0x3C, NULL);
+    test_fill();
+    test_chars();
+    test_primitives();
+    return test_result("ssd1306_test");
+}
@@ -0,0 +1,33 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// Apoio dos testes de host (ctest): CHECK conta a falha e segue adiante,
+// test_result mostra o resumo e dá o código de saída
+
+static int test_failures;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+static inline int test_result(const char *name) {
+    if (test_failures) printf("%s: %d falhas\n", name, test_failures);
+    else printf("%s: ok\n", name);
+    return test_failures != 0;
+}
+
+// Relógio monotônico em segundos, para os benchmarks
+static inline double test_now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+#endif // TEST_H
@@ -0,0 +1,92 @@
+#include "test_sim.h"
+#include "pico/multicore.h"
+#include "hardware/i2c.h"
+#include "lib/i2c_async/i2c_async.h"
+
+#define TEST_MPU6050_ADDR 0x68
+
+i2c_inst_t i2c0_inst = {0, 400000};
+i2c_inst_t i2c1_inst = {1, 400000};
+
+static uint32_t test_i2c_failures;
+
+void test_i2c_fail_next(uint32_t n) {
+    test_i2c_failures = n;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+// Mesmo custo de tempo do barramento do simulador (sim_i2c.c)
+static int test_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *tx, uint8_t *rx, size_t len) {
+    sim_advance_us(((uint64_t)len + 1) * 9 * 1000000 / i2c->baudrate);
+    if (test_i2c_failures > 0) {
+        test_i2c_failures--;
+        return PICO_ERROR_GENERIC;
+    }
+    if (addr != TEST_MPU6050_ADDR) return PICO_ERROR_GENERIC;
+    if (tx) sim_mpu6050_write(tx, len);
+    else sim_mpu6050_read(rx, len);
+    return (int)len;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    return test_i2c_transfer(i2c, addr, src, NULL, len);
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    return test_i2c_transfer(i2c, addr, NULL, dst, len);
+}
+
+uint8_t test_mpu6050_get_reg(uint8_t reg) {
+    uint8_t value;
+    sim_mpu6050_write(&reg, 1);
+    sim_mpu6050_read(&value, 1);
+    return value;
+}
+
+void test_mpu6050_set_reg(uint8_t reg, uint8_t value) {
+    uint8_t buf[2] = {reg, value};
+    sim_mpu6050_write(buf, 2);
+}
+
+// Sem motor assíncrono nos testes
+bool i2c_async_write_read(i2c_async_t *bus, i2c_async_xfer_t *xfer, uint8_t addr,
+                          const uint8_t *tx, uint16_t tx_len, uint8_t *rx, uint16_t rx_len,
+                          i2c_async_done_t done, void *context) {
+    return false;
+}
+
+// O núcleo 1 não é simulado
+void multicore_launch_core1(void (*entry)(void)) {
+}
+
+void multicore_fifo_push_blocking(uint32_t data) {
+}
+
+uint32_t multicore_fifo_pop_blocking(void) {
+    return 0;
+}
+
+// Modelos fora dos testes (chamados por sim_finish)
+void sim_gpio_print_stats(void) {
+}
+
+void sim_i2c_print_stats(void) {
+}
+
+void sim_ssd1306_print_stats(void) {
+}
+
+void sim_ssd1306_dump(void) {
+}
+
+void sim_sd_print_stats(void) {
+}
+
+void sim_sd_close(void) {
+}
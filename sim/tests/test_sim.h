@@ -0,0 +1,18 @@
+#ifndef TEST_SIM_H
+#define TEST_SIM_H
+
+#include <stdint.h>
+#include "sim.h"
+
+// Ambiente dos testes que usam o relógio virtual (sim_time.c) e o modelo do
+// MPU6050 (sim_mpu6050.c) sem o resto do simulador: um barramento I2C só com
+// o sensor, onde falhas podem ser provocadas, e stubs dos outros modelos
+
+// As próximas n transações I2C falham (NACK)
+void test_i2c_fail_next(uint32_t n);
+
+// Lê e escreve registradores do modelo do MPU6050 pelo barramento
+uint8_t test_mpu6050_get_reg(uint8_t reg);
+void test_mpu6050_set_reg(uint8_t reg, uint8_t value);
+
+#endif // TEST_SIM_H